@@ -1,19 +1,23 @@
 #include "Box2DPhysics.h"
+#include "utility/AllocationTracker.h"
 #include "utility/Log.h"
 #include "utility/Timer.h"
 #include "Entity.h"
 #include "components/TransformComponent.h"
 #include "Game.h"
+#include "options.h"
+#include <algorithm>
 #include <cassert>
 
 const std::string Box2DPhysics::TAG = "Box2DPhysics";
 const b2Vec2 Box2DPhysics::gravity(0.0f, -10);
-const float Box2DPhysics::timeStepS = 1.0f / 60.0f;
-const float Box2DPhysics::timeStepMs = timeStepS * 1000.0f;
 
 Box2DPhysics::Box2DPhysics()
 : world(),
-  lastStepDeltaMs(0.0f)
+  lastStepDeltaMs(0.0f),
+  stepRate(),
+  velocityIterations(),
+  positionIterations()
 {
 }
 
@@ -22,21 +26,38 @@ std::weak_ptr<b2World> Box2DPhysics::getWorld()
   return world;
 }
 
+int Box2DPhysics::getBodyCount() const
+{
+  return world != nullptr ? world->GetBodyCount() : 0;
+}
+
 void Box2DPhysics::initialize()
 {
   world = std::shared_ptr<b2World>(new b2World(gravity));
+  stepRate = GameOptions::getInstance().getIntHandle(PHYSICS_STEP_RATE);
+  velocityIterations =
+    GameOptions::getInstance().getIntHandle(PHYSICS_VELOCITY_ITERATIONS);
+  positionIterations =
+    GameOptions::getInstance().getIntHandle(PHYSICS_POSITION_ITERATIONS);
 }
 
 void Box2DPhysics::update(const float deltaMs)
 {
+  AllocationScope allocations(AllocationTag::Physics);
   bool stepped = false;
 
+  const float timeStepS = 1.0f / std::max(1, stepRate.get());
+  const float timeStepMs = timeStepS * 1000.0f;
   lastStepDeltaMs += deltaMs;
   while (lastStepDeltaMs >= timeStepMs)
   {
     stepped = true;
     lastStepDeltaMs -= timeStepMs;
-    world->Step(timeStepS, 8, 3);
+    world->Step(
+      timeStepS,
+      std::max(1, velocityIterations.get()),
+      std::max(1, positionIterations.get())
+      );
     world->ClearForces();
   }
 
@@ -45,7 +66,9 @@ void Box2DPhysics::update(const float deltaMs)
     auto logic = Game::getInstance().getLogicSystem();
     for (b2Body* body = world->GetBodyList(); body; body = body->GetNext())
     {
-      if (body->GetType() == b2_staticBody)
+      // only bodies that can move need their transforms synced, this keeps
+      // the spatial index from re-inserting entities that are at rest
+      if (body->GetType() == b2_staticBody || !body->IsAwake())
       {
         continue;
       }
@@ -61,6 +84,30 @@ void Box2DPhysics::update(const float deltaMs)
   }
 }
 
+void Box2DPhysics::saveState(ByteWriter& out) const
+{
+  out.writeFloat(lastStepDeltaMs);
+}
+
+bool Box2DPhysics::loadState(ByteReader& in)
+{
+  return in.readFloat(lastStepDeltaMs);
+}
+
+void Box2DPhysics::resetWorld()
+{
+  // the bodies are copied out of the old world before it goes
+  const std::shared_ptr<b2World> oldWorld = world;
+  world = std::shared_ptr<b2World>(new b2World(gravity));
+  Game::getInstance().getLogicSystem()->rebuildPhysics();
+  Log::verbose(
+    TAG,
+    "Reset the world with %d bodies, %d before",
+    world->GetBodyCount(),
+    oldWorld->GetBodyCount()
+    );
+}
+
 void Box2DPhysics::destroy()
 {
   world = std::shared_ptr<b2World>();
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "GameOptions.h"
+#include "utility/ByteStream.h"
 #include <Box2D.h>
 #include <memory>
 #include <string>
@@ -9,11 +11,13 @@ class Box2DPhysics
 private: 
   static const std::string TAG;
   static const b2Vec2 gravity;
-  static const float timeStepS;
-  static const float timeStepMs;
   
   std::shared_ptr<b2World> world;
   float lastStepDeltaMs;
+  // tunable while running
+  OptionHandle<int> stepRate;
+  OptionHandle<int> velocityIterations;
+  OptionHandle<int> positionIterations;
 
 public:
   Box2DPhysics();
@@ -22,5 +26,20 @@ public:
   void update(const float deltaMs);
   void destroy();
 
+  // time carried over to the next step, bodies save their own state
+  void saveState(ByteWriter& out) const;
+  bool loadState(ByteReader& in);
+
+  /**
+   * Moves every body into a new world. Box2D keeps contacts, warm starting
+   * impulses and a broadphase tree shaped by everything that happened
+   * before, none of which is saved state, so replays reset the world at
+   * each keyframe to step the same whether they were played or seeked there.
+   */
+  void resetWorld();
+
   std::weak_ptr<b2World> getWorld();
+
+  // number of bodies in the world
+  int getBodyCount() const;
 };
\ No newline at end of file
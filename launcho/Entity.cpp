@@ -40,6 +40,63 @@ void Entity::update(const float deltaMS)
   }
 }
 
+void Entity::saveState(ByteWriter& out) const
+{
+  out.writeVarint(static_cast<uint32_t>(components.size()));
+  for (auto& component : components)
+  {
+    // sized so a reader can skip components it doesn't know
+    out.writeU32(component.first);
+    const std::size_t sizeOffset = out.getSize();
+    out.writeU32(0);
+    component.second->saveState(out);
+    out.patchU32(
+      sizeOffset,
+      static_cast<uint32_t>(out.getSize() - sizeOffset - 4)
+      );
+  }
+}
+
+bool Entity::loadState(ByteReader& in)
+{
+  uint32_t count;
+  if (!in.readVarint(count))
+  {
+    return false;
+  }
+  for (uint32_t i = 0; i < count; i++)
+  {
+    ComponentID componentID;
+    uint32_t size;
+    const uint8_t* data;
+    if (!in.readU32(componentID) || !in.readU32(size) ||
+        !in.readBytes(data, size))
+    {
+      return false;
+    }
+
+    auto itr = components.find(componentID);
+    if (itr == components.end())
+    {
+      continue;
+    }
+    ByteReader componentIn(data, size);
+    if (!itr->second->loadState(componentIn))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Entity::rebuildPhysics()
+{
+  for (auto& component : components)
+  {
+    component.second->rebuildPhysics();
+  }
+}
+
 void Entity::destroy()
 {
   for (auto component : components)
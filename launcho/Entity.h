@@ -1,6 +1,7 @@
 #pragma once
 
 #include "types.h"
+#include "utility/ByteStream.h"
 #include <map>
 #include <memory>
 #include <string>
@@ -45,6 +46,24 @@ public:
    */
 	void update(const float deltaMS);
 
+  /**
+   * Saves the state of every component, for replay keyframes.
+   */
+  void saveState(ByteWriter& out) const;
+
+  /**
+   * Restores what saveState() wrote. Components the entity no longer has are
+   * skipped.
+   * @return false if the state is corrupt.
+   */
+  bool loadState(ByteReader& in);
+
+  /**
+   * Rebuilds the Box2D bodies of every component, see
+   * Component::rebuildPhysics().
+   */
+  void rebuildPhysics();
+
   /**
    * Destroy the entity and its components.
    */
@@ -1,10 +1,17 @@
 #include "Game.h"
 #include "utility/Timer.h"
 #include "SFMLRenderer.h"
+#include "SoftwareRenderer.h"
+#include "GameOptions.h"
+#include "options.h"
 #include "GameLogic.h"
 #include "GameEventSystem.h"
 #include "Box2DPhysics.h"
+#include "utility/AllocationTracker.h"
+#include "utility/ByteStream.h"
 #include "utility/Log.h"
+#include <algorithm>
+#include <random>
 #include <thread>
 #include <iostream>
 
@@ -12,16 +19,29 @@ const std::string Game::TAG = "Game";
 
 // try to sustain 30 fps
 const float Game::MAX_FRAME_TIME = 1000.0f / 30.0f;
+// seeking this far ahead or less is quicker without a keyframe
+const uint32_t Game::KEYFRAME_SEEK_TICKS = 60;
 
 Game::Game()
   : gameTime(0.0f),
     lastFrameTime(0.0f),
     frameCount(0),
+    seed(0),
+    frameStats(),
+    frameArena("main"),
+    headless(false),
     window(new sf::RenderWindow),
     logic(new GameLogic),    
     physics(new Box2DPhysics),
-    render(new SFMLRenderer(window)),
-    eventManager(new GameEventSystem(window))
+    spatial(new SpatialSystem),
+    particles(new ParticleSystem),
+    render(new NullRenderSystem),
+    eventManager(new GameEventSystem(window)),
+    input(new InputSystem),
+    atlas(new TextureAtlas),
+    workers(new WorkerPool),
+    server(),
+    client()
 {
 }
 
@@ -39,11 +59,21 @@ float Game::getFPS() const
   return 1000.0f / lastFrameTime;
 }
 
+const FrameStats& Game::getFrameStats() const
+{
+  return frameStats;
+}
+
 float Game::getGameTime() const
 {
   return gameTime;
 }
 
+uint32_t Game::getSeed() const
+{
+  return seed;
+}
+
 sf::RenderWindow* Game::getWindow()
 {
   return window.get();
@@ -59,6 +89,16 @@ Box2DPhysics* Game::getPhysicsSystem()
   return physics.get();
 }
 
+SpatialSystem* Game::getSpatialSystem()
+{
+  return spatial.get();
+}
+
+ParticleSystem* Game::getParticleSystem()
+{
+  return particles.get();
+}
+
 IRenderSystem* Game::getRenderSystem()
 {
   return render.get();
@@ -69,6 +109,26 @@ IEventSystem* Game::getEventSystem()
   return eventManager.get();
 }
 
+InputSystem* Game::getInputSystem()
+{
+  return input.get();
+}
+
+TextureAtlas* Game::getTextureAtlas()
+{
+  return atlas.get();
+}
+
+FrameArena* Game::getFrameArena()
+{
+  return &frameArena;
+}
+
+WorkerPool* Game::getWorkerPool()
+{
+  return workers.get();
+}
+
 void Game::run()
 {
   initialize();
@@ -80,26 +140,145 @@ void Game::run()
 void Game::initialize()
 {
   Log::verbose(TAG, "initialize start");
+  frameArena.bindToThread();
+  int threads = GameOptions::getInstance().getInt(WORKER_THREADS);
+  if (threads < 0)
+  {
+    threads = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+  }
+  workers->initialize(static_cast<unsigned>(std::max(threads, 0)));
   logic->initialize();  
   physics->initialize();
+  spatial->initialize();
+  particles->initialize();
+  createRenderSystem();
   render->initialize();
   eventManager->initialize();
+  // a replay brings its own seed, and entities are created after this
+  input->initialize(chooseSeed());
+  seed = input->getSeed();
+  Log::info(TAG, "Random seed %u", seed);
+  startNetwork();
   Log::verbose(TAG, "initialize complete");
 }
 
+void Game::createRenderSystem()
+{
+  const std::string type = GameOptions::getInstance().getString(RENDER_SYSTEM);
+  if (type == "software")
+  {
+    render.reset(new SoftwareRenderer);
+    headless = true;
+  }
+  else if (type == "null")
+  {
+    render.reset(new NullRenderSystem);
+    headless = true;
+  }
+  else
+  {
+    if (type != "sfml")
+    {
+      Log::warning(TAG, "Unknown render system %s, using sfml", type.c_str());
+    }
+    render.reset(new SFMLRenderer(window));
+    headless = false;
+  }
+  Log::debug(TAG, "Using %s render system", type.c_str());
+}
+
+uint32_t Game::chooseSeed() const
+{
+  const int option = GameOptions::getInstance().getInt(RANDOM_SEED);
+  if (option != 0)
+  {
+    return static_cast<uint32_t>(option);
+  }
+  std::random_device device;
+  return std::max(1u, static_cast<uint32_t>(device()));
+}
+
+void Game::startNetwork()
+{
+  const GameOptions& options = GameOptions::getInstance();
+  const std::string mode = options.getString(NET_MODE);
+  const unsigned short port =
+    static_cast<unsigned short>(options.getInt(NET_PORT));
+  const float timeout = options.getFloat(NET_TIMEOUT);
+  if (mode == "server")
+  {
+    const int tickRate = std::max(1, options.getInt(LOGIC_TICK_RATE));
+    const int snapshotRate =
+      std::min(std::max(1, options.getInt(NET_SNAPSHOT_RATE)), tickRate);
+    server.reset(new GameServer);
+    if (!server->start(port, tickRate / snapshotRate, timeout))
+    {
+      Log::error(TAG, "Could not start the server, playing alone");
+      server.reset();
+    }
+  }
+  else if (mode == "client")
+  {
+    client.reset(new GameClient);
+    if (!client->connect(options.getString(NET_ADDRESS), port, timeout))
+    {
+      Log::error(TAG, "Could not connect, playing alone");
+      client.reset();
+    }
+  }
+  else if (!mode.empty())
+  {
+    Log::warning(TAG, "Unknown net mode %s", mode.c_str());
+  }
+}
+
 void Game::mainLoop()
 {
   Log::verbose(TAG, "main loop start");
   Timer frameTime;
-  Timer physicsTime;
+  Timer sectionTime;
   float logicDelta = 0.0f;
-  const float logicTick = 1000.0f / 30.0f;
-  const float maxEventMs = 5.0f;
+  // read every frame so they can be tuned while the game runs
+  const OptionHandle<int> tickRate =
+    GameOptions::getInstance().getIntHandle(LOGIC_TICK_RATE);
+  const OptionHandle<float> eventBudget =
+    GameOptions::getInstance().getFloatHandle(EVENT_BUDGET);
+  const uint32_t maxFrames = static_cast<uint32_t>(
+    GameOptions::getInstance().getInt(MAX_FRAMES)
+    );
+  // a dedicated server runs until it is closed
+  if (headless && maxFrames == 0 && server == nullptr)
+  {
+    Log::warning(TAG, "Running headless with no frame limit");
+  }
+
+  // a headless replay runs one tick per frame as fast as it can, so it can
+  // be timed as a benchmark
+  const bool tickPerFrame = headless && input->isReplaying();
+  if (input->isReplaying())
+  {
+    seekReplay(GameOptions::getInstance().getFloat(REPLAY_SEEK));
+  }
+  // seeks whenever the option changes, the callback runs at the start of a
+  // frame where nothing else is updating
+  const OptionCallbackID seekCallback =
+    GameOptions::getInstance().addChangeCallback(
+      REPLAY_SEEK,
+      [this](const std::string& key) {
+        seekReplay(GameOptions::getInstance().getFloat(key));
+      });
 
-  while (window->isOpen())
+  while ((headless || window->isOpen()) &&
+         (maxFrames == 0 || frameCount < maxFrames) &&
+         !input->isReplayFinished() &&
+         (client == nullptr || !client->isConnectionLost()))
   {
     lastFrameTime = frameTime.elapsedMilliF();
     frameTime.start();
+    if (frameCount > 0)
+    {
+      frameStats.endFrame(lastFrameTime);
+    }
 
     // frame stats    
     gameTime += lastFrameTime / 1000.0f;
@@ -108,16 +287,39 @@ void Game::mainLoop()
 
     Log::verbose(TAG, "Start frame %u", frameCount);
 
+    // scratch memory from the last frame is dropped in one go
+    frameArena.reset();
+    workers->resetArenas();
+#ifdef LAUNCHO_TRACK_ALLOCATIONS
+    AllocationTracker::endFrame();
+#endif
+
+    // nothing is reading options between frames, so reloads are applied
+    // and old values freed here
+    GameOptions::getInstance().update();
+
+    sectionTime.start();
+    spatial->update();
+    frameStats.addSectionTime(FrameSection::Spatial,
+                              sectionTime.elapsedMilliF());
+
+    sectionTime.start();
+    particles->update(lastFrameTime);
+    frameStats.addSectionTime(FrameSection::Particles,
+                              sectionTime.elapsedMilliF());
+
+    sectionTime.start();
     render->update(lastFrameTime);
-    physics->update(physicsTime.elapsedMilliF());
-    physicsTime.start();
+    frameStats.addSectionTime(FrameSection::Render,
+                              sectionTime.elapsedMilliF());
 
-    logicDelta += frameTime.elapsedMilliF();
+    const float logicTick = 1000.0f / std::max(1, tickRate.get());
+    logicDelta += tickPerFrame ? logicTick : frameTime.elapsedMilliF();
+    const float maxEventMs = eventBudget.get();
     while (logicDelta >= logicTick)
     {
       logicDelta -= logicTick;
-      logic->update(logicTick);
-      eventManager->update(maxEventMs);
+      tick(logicTick, maxEventMs);
     }    
     
     // prevent using 100% cpu
@@ -127,17 +329,159 @@ void Game::mainLoop()
     }
   }
 
+  GameOptions::getInstance().removeChangeCallback(seekCallback);
+  if (client != nullptr && client->isConnectionLost())
+  {
+    Log::warning(TAG, "Lost the connection to the server");
+  }
   Log::info(TAG, "Processed %u frames in %.4fs", frameCount, gameTime);
   Log::info(TAG, "Avg frame time %.2fms", (gameTime / frameCount) * 1000.0f);
 }
 
+void Game::tick(const float tickMs, const float maxEventMs)
+{
+  Timer sectionTime;
+
+  // a keyframe restores the world state but not what Box2D caches between
+  // steps, so recordings and replays both reset the physics world at each
+  // one, and a seek steps on from it the same as the recording did
+  if (input->isKeyframeDue())
+  {
+    if (input->isRecording())
+    {
+      std::vector<uint8_t> state;
+      saveWorldState(state);
+      input->addKeyframe(std::move(state));
+    }
+    physics->resetWorld();
+  }
+
+  // window events are polled first so the tick sees the latest input
+  sectionTime.start();
+  eventManager->update(maxEventMs);
+  input->update();
+  frameStats.addSectionTime(FrameSection::Events,
+                            sectionTime.elapsedMilliF());
+
+  sectionTime.start();
+  // a client's input moves its player on the server, and comes back in a
+  // snapshot
+  if (client != nullptr)
+  {
+    client->update(input->getState());
+  }
+  else
+  {
+    logic->applyInput(PLAYER_ID, input->getState());
+  }
+  if (server != nullptr)
+  {
+    server->update();
+  }
+  logic->update(tickMs);
+  frameStats.addSectionTime(FrameSection::Logic,
+                            sectionTime.elapsedMilliF());
+
+  // stepped with the tick rather than the frame, so a run only depends on
+  // its input and not on how fast it was rendered
+  sectionTime.start();
+  physics->update(tickMs);
+  frameStats.addSectionTime(FrameSection::Physics,
+                            sectionTime.elapsedMilliF());
+}
+
+void Game::saveWorldState(std::vector<uint8_t>& state) const
+{
+  state.clear();
+  ByteWriter out(state);
+  physics->saveState(out);
+  logic->saveState(out);
+}
+
+bool Game::loadWorldState(const std::vector<uint8_t>& state)
+{
+  ByteReader in(state.data(), state.size());
+  return physics->loadState(in) && logic->loadState(in);
+}
+
+void Game::seekReplay(const float seconds)
+{
+  if (!input->isReplaying() || seconds < 0.0f)
+  {
+    return;
+  }
+
+  Timer timer(true);
+  const int tickRate =
+    std::max(1, GameOptions::getInstance().getInt(LOGIC_TICK_RATE));
+  const float tickMs = 1000.0f / tickRate;
+  const uint32_t target = std::min(
+    static_cast<uint32_t>(seconds * tickRate),
+    input->getReplayTickCount()
+    );
+  const uint32_t from = input->getReplayTick();
+  if (target == from)
+  {
+    return;
+  }
+
+  // ticks ahead of the replay are simulated from where it is, anything else
+  // starts from a keyframe
+  if (target < from || target - from > KEYFRAME_SEEK_TICKS)
+  {
+    std::vector<uint8_t> state;
+    if (!input->rewindReplay(target, state))
+    {
+      Log::error(TAG, "Could not seek the replay to tick %u", target);
+      return;
+    }
+    if (!loadWorldState(state))
+    {
+      Log::error(TAG, "Keyframe before tick %u is corrupt", target);
+      return;
+    }
+  }
+
+  const float maxEventMs = GameOptions::getInstance().getFloat(EVENT_BUDGET);
+  const uint32_t simulated = target - input->getReplayTick();
+  while (input->getReplayTick() < target)
+  {
+    tick(tickMs, maxEventMs);
+  }
+  Log::info(
+    TAG,
+    "Seeked to tick %u in %.2fms, simulated %u ticks",
+    target,
+    timer.elapsedMilliF(),
+    simulated
+    );
+}
+
 void Game::shutdown()
 {
   Log::verbose(TAG, "shutdown begin");
+  // before the entities go, the players they own are removed
+  if (server != nullptr)
+  {
+    server->stop();
+  }
+  if (client != nullptr)
+  {
+    client->disconnect();
+  }
   logic->destroy();
   physics->destroy();
+  spatial->destroy();
+  particles->destroy();
   render->destroy();
   eventManager->destroy();  
+  input->destroy();
+  frameArena.report();
+  workers->reportArenas();
+#ifdef LAUNCHO_TRACK_ALLOCATIONS
+  AllocationTracker::report();
+#endif
+  workers->destroy();
   Log::verbose(TAG, "shutdown complete");
 }
 
@@ -148,16 +492,17 @@ void Game::shutdown()
 #include "components/RectangleRenderComponent.h"
 #include "components/PhysicsComponent.h"
 
-void Game::createEntities()
+void Game::createPlayer(const EntityID id, const Vector2& position,
+                        const sf::Color& color)
 {
-  StrongEntityPtr ent(new Entity(1));
+  StrongEntityPtr ent(new Entity(id));
   StrongTransformComponentPtr trans(new TransformComponent(ent));
-  trans->setPosition(Vector2(30, 70));
+  trans->setPosition(position);
   trans->setSize(50, 100);
   ent->addComponent(trans);
   StrongRectangleRenderComponentPtr rect(new RectangleRenderComponent(ent));
   rect->setLayer(RenderLayer::Player);
-  rect->setColor(sf::Color::Blue);
+  rect->setColor(color);
   ent->addComponent(rect);
   StrongPhysicsComponentPtr phys(
     new PhysicsComponent(ent, PhysicsComponent::Type::Dynamic)
@@ -165,18 +510,23 @@ void Game::createEntities()
   ent->addComponent(phys);
   ent->initialize();
   logic->addEntity(ent);
+}
+
+void Game::createEntities()
+{
+  createPlayer(PLAYER_ID, Vector2(30, 70), sf::Color::Blue);
 
   // ground
-  ent = StrongEntityPtr(new Entity(2));
-  trans = StrongTransformComponentPtr(new TransformComponent(ent));
+  StrongEntityPtr ent(new Entity(2));
+  StrongTransformComponentPtr trans(new TransformComponent(ent));
   trans->setPosition(Vector2(400, 10));
   trans->setSize(800, 20);
   ent->addComponent(trans);
-  rect = StrongRectangleRenderComponentPtr(new RectangleRenderComponent(ent));
+  StrongRectangleRenderComponentPtr rect(new RectangleRenderComponent(ent));
   rect->setLayer(RenderLayer::Background);
   rect->setColor(sf::Color::Green);
   ent->addComponent(rect);
-  phys = StrongPhysicsComponentPtr(
+  StrongPhysicsComponentPtr phys(
     new PhysicsComponent(ent, PhysicsComponent::Type::Static)
     );
   ent->addComponent(phys);
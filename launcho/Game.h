@@ -3,11 +3,21 @@
 #include "ILogicSystem.h"
 #include "IRenderSystem.h"
 #include "Box2DPhysics.h"
+#include "SpatialSystem.h"
+#include "ParticleSystem.h"
 #include "IEventSystem.h"
+#include "InputSystem.h"
+#include "graphics/TextureAtlas.h"
+#include "net/GameClient.h"
+#include "net/GameServer.h"
+#include "utility/FrameArena.h"
+#include "utility/FrameStats.h"
 #include "utility/Singleton.h"
+#include "utility/WorkerPool.h"
 #include <SFML/Graphics.hpp>
 #include <memory>
 #include <string>
+#include <vector>
 
 /**
  * Encapsulates the systems that make up the game.
@@ -18,17 +28,34 @@ class Game
   static const std::string TAG;
   // max desired time for a single frame
   static const float MAX_FRAME_TIME;
+  // seeks further ahead than this restore a keyframe
+  static const uint32_t KEYFRAME_SEEK_TICKS;
 
   // in ms
   float lastFrameTime;
   // in sec
   float gameTime;
   uint32_t frameCount;
+  // everything random in the run is derived from this
+  uint32_t seed;
+  FrameStats frameStats;
+  // the main thread's scratch memory, reset at the top of every frame
+  FrameArena frameArena;
+  // nothing is shown in the window, the loop ends on MAX_FRAMES instead
+  bool headless;
   std::shared_ptr<sf::RenderWindow> window;
   std::shared_ptr<ILogicSystem> logic;  
   std::shared_ptr<Box2DPhysics> physics;
+  std::shared_ptr<SpatialSystem> spatial;
+  std::shared_ptr<ParticleSystem> particles;
   std::shared_ptr<IRenderSystem> render;
   std::shared_ptr<IEventSystem> eventManager;
+  std::shared_ptr<InputSystem> input;
+  std::shared_ptr<TextureAtlas> atlas;
+  std::shared_ptr<WorkerPool> workers;
+  // at most one is set, by the NET_MODE option
+  std::shared_ptr<GameServer> server;
+  std::shared_ptr<GameClient> client;
 
 public:  
   ~Game();
@@ -41,16 +68,36 @@ public:
   // frame stats accessors
   float getlastFrameTime() const;
   float getFPS() const;
+  const FrameStats& getFrameStats() const;
 
   float getGameTime() const;
+  uint32_t getSeed() const;
 
   // systems accessors - DO NOT HOLD THESE POINTERS
   // these should always return a valid pointer
   sf::RenderWindow* getWindow();
   ILogicSystem* getLogicSystem();
   Box2DPhysics* getPhysicsSystem();
+  SpatialSystem* getSpatialSystem();
+  ParticleSystem* getParticleSystem();
   IRenderSystem* getRenderSystem();
   IEventSystem* getEventSystem();
+  InputSystem* getInputSystem();
+  TextureAtlas* getTextureAtlas();
+  WorkerPool* getWorkerPool();
+  // FrameArena::local() finds the arena of the calling thread, this is the
+  // main thread's
+  FrameArena* getFrameArena();
+
+  /**
+   * Adds a player controlled box to the world.
+   */
+  void createPlayer(const EntityID id, const Vector2& position,
+                    const sf::Color& color);
+
+  // the state replay keyframes restore and servers send to their clients
+  void saveWorldState(std::vector<uint8_t>& state) const;
+  bool loadWorldState(const std::vector<uint8_t>& state);
 
 private:
   friend class Singleton<Game>;
@@ -61,11 +108,38 @@ private:
    */
   void initialize();
 
+  /**
+   * Creates the render system picked by the RENDER_SYSTEM option.
+   */
+  void createRenderSystem();
+
+  /**
+   * Picks the seed for a new run from the RANDOM_SEED option.
+   */
+  uint32_t chooseSeed() const;
+
+  /**
+   * Starts a server or connects to one if the NET_MODE option asks for it.
+   */
+  void startNetwork();
+
   /**
    * Perform the main logic/render loop.
    */
   void mainLoop();
 
+  /**
+   * Runs a logic tick: input, network, logic, then physics.
+   * @param maxEventMs Most time spent dispatching queued events.
+   */
+  void tick(const float tickMs, const float maxEventMs);
+
+  /**
+   * Jumps a replay to a time by restoring the keyframe before it and
+   * simulating the rest of the way.
+   */
+  void seekReplay(const float seconds);
+
   /**
    * Clean up resources.
    */
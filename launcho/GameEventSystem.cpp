@@ -1,7 +1,8 @@
 #include "GameEventSystem.h"
+#include "utility/AllocationTracker.h"
 #include "utility/Log.h"
 #include "events/Event.h"
-#include "events/InputEvents.h"
+#include "Game.h"
 #include <cassert>
 #include <algorithm>
 #include <iterator>
@@ -24,6 +25,7 @@ void GameEventSystem::initialize()
 
 void GameEventSystem::update(const float maxMs)
 {
+  AllocationScope allocations(AllocationTag::Events);
   timer.start();
   Log::verbose(TAG, "Starting event processing, time budget %.2fms", maxMs);
   processWindowEvents();
@@ -60,16 +62,14 @@ bool GameEventSystem::addListener(EventID evtID, EventCallbackID callbackID,
       return false;
     }
   }
-  else
-  {
-    listeners[evtID].emplace(callbackID, fn);
-    Log::verbose(
-      TAG,
-      "Added callbackID %08x (event type %08x)",
-      callbackID,
-      evtID
-      );    
-  }  
+
+  listeners[evtID].emplace(callbackID, fn);
+  Log::verbose(
+    TAG,
+    "Added callbackID %08x (event type %08x)",
+    callbackID,
+    evtID
+    );
   return true;
 }
 
@@ -125,9 +125,9 @@ void GameEventSystem::triggerEvent(StrongEventPtr evt) const
   auto itr = listeners.find(evt->getID());
   if (itr != listeners.end())
   {
-    for (auto listener : itr->second)
+    for (const auto& listener : itr->second)
     {
-      listener.second(evt);
+      listener.second(*evt);
     }
   }
 }
@@ -184,6 +184,12 @@ uint32_t GameEventSystem::abortAllEvents(const EventID id)
   return count;
 }
 
+std::size_t GameEventSystem::getQueuedEventCount() const
+{
+  // includes events queued while the other queue is being processed
+  return queues[0].size() + queues[1].size();
+}
+
 void GameEventSystem::processWindowEvents()
 {
   sf::Event evt;
@@ -197,10 +203,19 @@ void GameEventSystem::processWindowEvents()
     {
       window->close();
     }
-    else if (evt.type == sf::Event::KeyPressed || 
+    else if (evt.type == sf::Event::KeyPressed ||
              evt.type == sf::Event::KeyReleased)
     {
-      dispatchKeyboardEvent(evt);
+      // only flips bits, the input is sampled once per logic tick
+      Game::getInstance().getInputSystem()->onKey(
+        evt.key.code,
+        evt.type == sf::Event::KeyPressed
+        );
+    }
+    else if (evt.type == sf::Event::LostFocus)
+    {
+      // the key ups will go to another window
+      Game::getInstance().getInputSystem()->releaseAll();
     }
   }
 
@@ -249,124 +264,4 @@ void GameEventSystem::processQueue(const float maxMs)
     count, 
     timer.elapsedMilliF() - start
     );
-}
-
-void GameEventSystem::dispatchKeyboardEvent(const sf::Event& evt)
-{
-  enum
-  {
-    UP = 0,
-    DOWN = 1,
-    LEFT = 2,
-    RIGHT = 3,
-    FIRE = 4
-  };
-  // tracks keys that are currently down
-  static bool keyStates[5] = { false };
-
-  assert(evt.type == sf::Event::KeyPressed || 
-         evt.type == sf::Event::KeyReleased);
-  
-  switch (evt.key.code)
-  {
-  case sf::Keyboard::Up:
-    if ((evt.type == sf::Event::KeyPressed) && !keyStates[UP])
-    {
-      keyStates[UP] = true;
-      queueEvent(
-        StrongEventPtr(
-          new InputEvent(InputAction::MoveUp, InputActionState::Start)
-          )
-        );
-    }
-    else if ((evt.type == sf::Event::KeyReleased) && keyStates[UP])
-    {
-      keyStates[UP] = false;
-      queueEvent(
-        StrongEventPtr(
-          new InputEvent(InputAction::MoveUp, InputActionState::Stop)
-          )
-        );
-    }
-    break;
-
-  case sf::Keyboard::Down:
-    if ((evt.type == sf::Event::KeyPressed) && !keyStates[DOWN])
-    {
-      keyStates[DOWN] = true;
-      queueEvent(
-        StrongEventPtr(
-          new InputEvent(InputAction::MoveDown, InputActionState::Start)
-          )
-        );
-    }
-    else if ((evt.type == sf::Event::KeyReleased) && keyStates[DOWN])
-    {
-      keyStates[DOWN] = false;
-      queueEvent(
-        StrongEventPtr(
-          new InputEvent(InputAction::MoveDown, InputActionState::Stop)
-          )
-        );
-    }
-    break;
-
-  case sf::Keyboard::Left:
-    if ((evt.type == sf::Event::KeyPressed) && !keyStates[LEFT])
-    {
-      keyStates[LEFT] = true;
-      queueEvent(
-        StrongEventPtr(
-          new InputEvent(InputAction::MoveLeft, InputActionState::Start)
-          )
-        );
-    }
-    else if ((evt.type == sf::Event::KeyReleased) && keyStates[LEFT])
-    {
-      keyStates[LEFT] = false;
-      queueEvent(
-        StrongEventPtr(
-          new InputEvent(InputAction::MoveLeft, InputActionState::Stop)
-          )
-        );
-    }
-    break;
-
-  case sf::Keyboard::Right:
-    if ((evt.type == sf::Event::KeyPressed) && !keyStates[RIGHT])
-    {
-      keyStates[RIGHT] = true;
-      queueEvent(
-        StrongEventPtr(
-          new InputEvent(InputAction::MoveRight, InputActionState::Start)
-          )
-        );
-    }
-    else if ((evt.type == sf::Event::KeyReleased) && keyStates[RIGHT])
-    {
-      keyStates[RIGHT] = false;
-      queueEvent(
-        StrongEventPtr(
-          new InputEvent(InputAction::MoveRight, InputActionState::Stop)
-          )
-        );
-    }
-    break;
-
-  case sf::Keyboard::Space:
-    if ((evt.type == sf::Event::KeyPressed) && !keyStates[FIRE])
-    {
-      keyStates[FIRE] = true;
-      queueEvent(
-        StrongEventPtr(
-          new InputEvent(InputAction::Fire)
-          )
-        );
-    }
-    else if ((evt.type == sf::Event::KeyReleased) && keyStates[FIRE])
-    {
-      keyStates[FIRE] = false;
-    }
-    break;
-  }
-}
+}
\ No newline at end of file
@@ -43,9 +43,9 @@ public:
   void queueEvent(StrongEventPtr evt) override;
   bool abortEvent(const EventID id) override;
   uint32_t abortAllEvents(const EventID id) override;
+  std::size_t getQueuedEventCount() const override;
 
 private:
   void processWindowEvents();
   void processQueue(const float maxMs);
-  void dispatchKeyboardEvent(const sf::Event& evt);
 };
\ No newline at end of file
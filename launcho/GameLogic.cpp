@@ -1,10 +1,10 @@
 #include "GameLogic.h"
+#include "utility/AllocationTracker.h"
 #include "utility/Timer.h"
 #include "Game.h"
 #include "events/EntityEvents.h"
 #include "utility/Log.h"
 #include "Game.h"
-#include "events/InputEvents.h"
 #include "components/PhysicsComponent.h"
 #include <cassert>
 #include <functional>
@@ -13,20 +13,11 @@ const std::string GameLogic::TAG = "GameLogic";
 
 void GameLogic::initialize()
 {
-  // attach callbacks
-  auto evtMgr = Game::getInstance().getEventSystem();
-  // it SHOULD be ok to recycle this id since it is being registered
-  // on 4 different event types
-  inputCallbackID = evtMgr->generateNextCallbackID();
-  evtMgr->addListener(
-    InputEvent::ID,
-    inputCallbackID,
-    std::bind(&GameLogic::inputCallback, this, std::placeholders::_1)
-    );
 }
 
 void GameLogic::update(const float deltaMs)
 {
+  AllocationScope allocations(AllocationTag::Logic);
   for (auto entity : entities)
   {
     entity.second->update(deltaMs);
@@ -40,10 +31,6 @@ void GameLogic::destroy()
   {
     removeEntity(entities.begin()->second->getID());
   }
-
-  // detach callbacks
-  auto evtMgr = Game::getInstance().getEventSystem();
-  evtMgr->removeListener(InputEvent::ID, inputCallbackID);
 }
 
 void GameLogic::addEntity(StrongEntityPtr entity)
@@ -96,45 +83,86 @@ WeakEntityPtr GameLogic::getPlayer()
   return entities[PLAYER_ID];
 }
 
-void GameLogic::inputCallback(StrongEventPtr evt)
+void GameLogic::applyInput(const EntityID id, const InputState& input)
 {
-  auto ie = Event::cast<InputEvent>(evt);
-
-  if (ie == nullptr)
+  if (input.pressed == 0)
   {
-    Log::warning(
-      TAG,
-      "Unknown input event %08x (%s)",
-      evt->getID(),
-      evt->getNameC()
-      );
+    return;
   }
-  else
-  {
-    auto player = entities[PLAYER_ID];
-    auto physics = player->getComponent<PhysicsComponent>().lock();
 
-    switch (ie->action)
-    {
-    case InputAction::MoveUp:
-      physics->applyImpulse(Vector2(0, 1000));
-      break;
+  auto itr = entities.find(id);
+  if (itr == entities.end())
+  {
+    Log::warning(TAG, "Input for non existing entity %u", id);
+    return;
+  }
+  auto physics = itr->second->getComponent<PhysicsComponent>().lock();
 
-    case InputAction::MoveDown:
-      physics->applyImpulse(Vector2(0, -1000));
-      break;
+  if (input.wasPressed(InputAction::MoveUp))
+  {
+    physics->applyImpulse(Vector2(0, 1000));
+  }
+  if (input.wasPressed(InputAction::MoveDown))
+  {
+    physics->applyImpulse(Vector2(0, -1000));
+  }
+  if (input.wasPressed(InputAction::MoveLeft))
+  {
+    physics->applyImpulse(Vector2(-1000, 0));
+  }
+  if (input.wasPressed(InputAction::MoveRight))
+  {
+    physics->applyImpulse(Vector2(1000, 0));
+  }
+  if (input.wasPressed(InputAction::Fire))
+  {
+    physics->applyImpulse(Vector2(10000000, 100000000));
+  }
+}
 
-    case InputAction::MoveLeft:
-      physics->applyImpulse(Vector2(-1000, 0));
-      break;
+void GameLogic::saveState(ByteWriter& out) const
+{
+  out.writeVarint(static_cast<uint32_t>(entities.size()));
+  for (auto& entity : entities)
+  {
+    out.writeVarint(entity.first);
+    entity.second->saveState(out);
+  }
+}
 
-    case InputAction::MoveRight:
-      physics->applyImpulse(Vector2(1000, 0));
-      break;
+bool GameLogic::loadState(ByteReader& in)
+{
+  uint32_t count;
+  if (!in.readVarint(count) || count != entities.size())
+  {
+    return false;
+  }
+  for (uint32_t i = 0; i < count; i++)
+  {
+    EntityID id;
+    if (!in.readVarint(id))
+    {
+      return false;
+    }
+    auto itr = entities.find(id);
+    if (itr == entities.end() || !itr->second->loadState(in))
+    {
+      Log::error(TAG, "Could not restore entity %u", id);
+      return false;
+    }
+  }
+  return true;
+}
 
-    case InputAction::Fire:
-      physics->applyImpulse(Vector2(10000000, 100000000));
-      break;
-    }    
+void GameLogic::rebuildPhysics()
+{
+  for (auto& entity : entities)
+  {
+    entity.second->rebuildPhysics();
   }
 }
+
+std::size_t GameLogic::getEntityCount() const
+{
+  return entities.size();
+}
\ No newline at end of file
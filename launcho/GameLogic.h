@@ -17,17 +17,18 @@ private:
   static const std::string TAG;
 
   std::map<EntityID, StrongEntityPtr> entities;
-  EventCallbackID inputCallbackID;
 
 public:
   void initialize() override;
   void update(const float deltaMs) override;
   void destroy() override;
+  void saveState(ByteWriter& out) const override;
+  bool loadState(ByteReader& in) override;
+  void rebuildPhysics() override;
+  void applyInput(const EntityID id, const InputState& input) override;
   void addEntity(StrongEntityPtr entity) override;
   WeakEntityPtr getEntity(const EntityID id) const override;
   void removeEntity(const EntityID id) override;
   WeakEntityPtr getPlayer() override;
-
-private:
-  void inputCallback(StrongEventPtr evt);
+  std::size_t getEntityCount() const override;
 };
\ No newline at end of file
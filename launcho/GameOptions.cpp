@@ -1,54 +1,499 @@
 #include "GameOptions.h"
 #include "utility/conversions.h"
 #include "utility/Log.h"
+#include <sys/stat.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 
 const std::string GameOptions::TAG = "GameOptions";
 
-void GameOptions::loadFromFile(const std::string& filename)
+// how often the watched file is checked for changes
+static const std::chrono::milliseconds WATCH_INTERVAL(500);
+
+// whitespace around keys and values is ignored
+static std::string trim(const std::string& s)
+{
+  const std::string space = " \t\r\n";
+  const std::size_t begin = s.find_first_not_of(space);
+  if (begin == std::string::npos)
+  {
+    return std::string();
+  }
+  const std::size_t end = s.find_last_not_of(space);
+  return s.substr(begin, end - begin + 1);
+}
+
+// modification times only have a resolution of a second, the size catches
+// most saves made within the same second
+struct FileStamp
+{
+  time_t modified;
+  long long size;
+
+  bool operator!=(const FileStamp& rhs) const
+  {
+    return modified != rhs.modified || size != rhs.size;
+  }
+};
+
+// all zeros if the file doesn't exist
+static FileStamp getFileStamp(const std::string& filename)
+{
+  struct stat info;
+  FileStamp stamp = { 0, 0 };
+  if (stat(filename.c_str(), &info) == 0)
+  {
+    stamp.modified = info.st_mtime;
+    stamp.size = info.st_size;
+  }
+  return stamp;
+}
+
+GameOptions::GameOptions()
+: current(nullptr),
+  writeMutex(),
+  live(new Snapshot()),
+  retired(),
+  changedKeys(),
+  messages(),
+  listeners(),
+  nextListenerID(0),
+  watcher(),
+  watchMutex(),
+  watchWake(),
+  stopWatching(false),
+  watchedFile(),
+  fileValues()
+{
+  current.store(live.get(), std::memory_order_release);
+}
+
+GameOptions::~GameOptions()
 {
-  // TODO: Implement me.
+  stopWatchingFile();
+}
+
+bool GameOptions::loadFromFile(const std::string& filename)
+{
+  Assignments assignments;
+  std::vector<std::string> problems;
+  if (!parseFile(filename, assignments, problems))
+  {
+    Log::debug(TAG, "No config file at %s", filename.c_str());
+    return false;
+  }
+  apply(assignments, filename, problems);
+  for (auto& problem : problems)
+  {
+    Log::warning(TAG, "%s", problem.c_str());
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(watchMutex);
+    fileValues = assignments;
+  }
+  Log::debug(TAG, "Loaded options from %s", filename.c_str());
+  return true;
 }
 
 void GameOptions::parseCommandLine(int argc, char* argv[])
 {
-  // TODO: Implement me.
+  Assignments assignments;
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string arg = argv[i];
+    const std::size_t equals = arg.find('=');
+    if (arg.compare(0, 2, "--") != 0 || equals == std::string::npos)
+    {
+      Log::warning(TAG, "Ignoring argument %s, use --key=value", argv[i]);
+      continue;
+    }
+    assignments.emplace_back(
+      arg.substr(2, equals - 2),
+      arg.substr(equals + 1)
+      );
+  }
+
+  std::vector<std::string> problems;
+  apply(assignments, "command line", problems);
+  for (auto& problem : problems)
+  {
+    Log::warning(TAG, "%s", problem.c_str());
+  }
+}
+
+void GameOptions::watchFile(const std::string& filename)
+{
+  stopWatchingFile();
+  {
+    std::lock_guard<std::mutex> lock(watchMutex);
+    watchedFile = filename;
+    stopWatching = false;
+  }
+  watcher = std::thread(&GameOptions::watchLoop, this);
+  Log::debug(TAG, "Watching %s for changes", filename.c_str());
+}
+
+void GameOptions::stopWatchingFile()
+{
+  if (!watcher.joinable())
+  {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(watchMutex);
+    stopWatching = true;
+  }
+  watchWake.notify_one();
+  watcher.join();
+}
+
+void GameOptions::update()
+{
+  std::vector<std::unique_ptr<const Snapshot>> freed;
+  std::vector<std::string> changed;
+  std::vector<std::string> logged;
+  {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    freed.swap(retired);
+    changed.swap(changedKeys);
+    logged.swap(messages);
+  }
+
+  // between frames nothing holds a reference into an old snapshot, so they
+  // can go once they're out of the list
+  freed.clear();
+
+  for (auto& message : logged)
+  {
+    Log::warning(TAG, "%s", message.c_str());
+  }
+
+  // the same key can change more than once between updates
+  std::sort(changed.begin(), changed.end());
+  changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+  for (auto& key : changed)
+  {
+    Log::info(TAG, "%s changed to %s", key.c_str(), getString(key).c_str());
+    // callbacks can add or remove listeners, so walk a copy
+    const std::vector<Listener> notify = listeners;
+    for (auto& listener : notify)
+    {
+      if (listener.key == key)
+      {
+        listener.callback(key);
+      }
+    }
+  }
+}
+
+OptionCallbackID GameOptions::addChangeCallback(const std::string& key,
+                                                OptionCallback callback)
+{
+  Listener listener;
+  listener.id = nextListenerID++;
+  listener.key = key;
+  listener.callback = std::move(callback);
+  listeners.push_back(std::move(listener));
+  return listeners.back().id;
+}
+
+void GameOptions::removeChangeCallback(const OptionCallbackID id)
+{
+  listeners.erase(
+    std::remove_if(
+      listeners.begin(),
+      listeners.end(),
+      [id](const Listener& listener) { return listener.id == id; }
+      ),
+    listeners.end()
+    );
 }
 
 void GameOptions::dumpToLog() const
 {
   Log::getInstance().print(TAG, "Options dump:");
-  for (auto opt : options)
+  const Snapshot& snapshot = getSnapshot();
+  for (auto& slot : snapshot.slots)
   {
-    Log::getInstance().print(TAG, opt.first + " = " + opt.second);
+    Log::getInstance().print(
+      TAG,
+      slot.first + " = " + snapshot.values[slot.second].text
+      );
   }
 }
 
-std::string GameOptions::getString(const std::string& key) const
+const std::string& GameOptions::getString(const std::string& key) const
 {
-  return options.at(key);
+  return find(key).text;
 }
 
 int GameOptions::getInt(const std::string& key) const
 {
-  return fromString<int>(getString(key));
+  return find(key).intValue;
 }
 
 float GameOptions::getFloat(const std::string& key) const
 {
-  return fromString<float>(getString(key));
+  return find(key).floatValue;
+}
+
+OptionHandle<std::string> GameOptions::getStringHandle(
+  const std::string& key) const
+{
+  return OptionHandle<std::string>(this, findSlot(key));
+}
+
+OptionHandle<int> GameOptions::getIntHandle(const std::string& key) const
+{
+  return OptionHandle<int>(this, findSlot(key));
+}
+
+OptionHandle<float> GameOptions::getFloatHandle(const std::string& key) const
+{
+  return OptionHandle<float>(this, findSlot(key));
 }
 
 void GameOptions::setString(const std::string& key, const std::string& value)
 {
-  options[key] = value;
+  bool valid = true;
+  publish([&](Snapshot& snapshot) {
+    valid = assign(findOrAdd(snapshot, key, OptionType::String), value);
+  });
+  if (!valid)
+  {
+    Log::warning(
+      TAG,
+      "%s is not a valid value for %s",
+      value.c_str(),
+      key.c_str()
+      );
+  }
 }
 
 void GameOptions::setInt(const std::string& key, const int value)
 {
-  setString(key, toString(value));
+  publish([&](Snapshot& snapshot) {
+    Option& option = findOrAdd(snapshot, key, OptionType::Int);
+    option.type = OptionType::Int;
+    option.text = toString(value);
+    option.intValue = value;
+    option.floatValue = static_cast<float>(value);
+  });
 }
 
 void GameOptions::setFloat(const std::string& key, const float value)
 {
-  setString(key, toString(value));
+  publish([&](Snapshot& snapshot) {
+    Option& option = findOrAdd(snapshot, key, OptionType::Float);
+    option.type = OptionType::Float;
+    option.text = toString(value);
+    option.intValue = static_cast<int>(value);
+    option.floatValue = value;
+  });
+}
+
+const GameOptions::Option& GameOptions::find(const std::string& key) const
+{
+  const Snapshot& snapshot = getSnapshot();
+  return snapshot.values[snapshot.slots.at(key)];
+}
+
+std::size_t GameOptions::findSlot(const std::string& key) const
+{
+  return getSnapshot().slots.at(key);
+}
+
+void GameOptions::publish(const std::function<void(Snapshot&)>& edit)
+{
+  std::lock_guard<std::mutex> lock(writeMutex);
+  std::unique_ptr<Snapshot> next(new Snapshot(*live));
+  edit(*next);
+
+  // newly added options aren't changes
+  for (auto& slot : next->slots)
+  {
+    if (slot.second < live->values.size() &&
+        next->values[slot.second].text != live->values[slot.second].text)
+    {
+      changedKeys.push_back(slot.first);
+    }
+  }
+
+  // readers that already have the old snapshot keep using it until the
+  // next update()
+  current.store(next.get(), std::memory_order_release);
+  retired.push_back(std::move(live));
+  live = std::move(next);
+}
+
+GameOptions::Option& GameOptions::findOrAdd(Snapshot& snapshot,
+                                            const std::string& key,
+                                            const OptionType type)
+{
+  auto itr = snapshot.slots.find(key);
+  if (itr != snapshot.slots.end())
+  {
+    return snapshot.values[itr->second];
+  }
+
+  Option option;
+  option.type = type;
+  option.intValue = 0;
+  option.floatValue = 0.0f;
+  snapshot.slots[key] = snapshot.values.size();
+  snapshot.values.push_back(option);
+  return snapshot.values.back();
+}
+
+bool GameOptions::assign(Option& option, const std::string& text)
+{
+  // numbers have to use up the whole string
+  errno = 0;
+  char* end = nullptr;
+  const long asInt = std::strtol(text.c_str(), &end, 10);
+  const bool isInt = !text.empty() && *end == '\0' && errno == 0;
+  errno = 0;
+  const float asFloat = std::strtof(text.c_str(), &end);
+  const bool isFloat = !text.empty() && *end == '\0' && errno == 0;
+
+  if ((option.type == OptionType::Int && !isInt) ||
+      (option.type == OptionType::Float && !isFloat))
+  {
+    return false;
+  }
+
+  option.text = text;
+  option.intValue = isInt ? static_cast<int>(asInt) :
+                    isFloat ? static_cast<int>(asFloat) : 0;
+  option.floatValue = isFloat ? asFloat : 0.0f;
+  return true;
+}
+
+bool GameOptions::parseFile(const std::string& filename, Assignments& out,
+                            std::vector<std::string>& problems)
+{
+  std::ifstream file(filename);
+  if (!file)
+  {
+    return false;
+  }
+
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(file, line))
+  {
+    lineNumber++;
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty())
+    {
+      continue;
+    }
+
+    const std::size_t equals = line.find('=');
+    if (equals == std::string::npos)
+    {
+      problems.push_back(
+        filename + ":" + toString(lineNumber) + " is not key = value"
+        );
+      continue;
+    }
+    out.emplace_back(
+      trim(line.substr(0, equals)),
+      trim(line.substr(equals + 1))
+      );
+  }
+  return true;
+}
+
+void GameOptions::apply(const Assignments& assignments,
+                        const std::string& source,
+                        std::vector<std::string>& problems)
+{
+  if (assignments.empty())
+  {
+    return;
+  }
+
+  // all of the values show up at once
+  publish([&](Snapshot& snapshot) {
+    for (auto& assignment : assignments)
+    {
+      auto itr = snapshot.slots.find(assignment.first);
+      if (itr == snapshot.slots.end())
+      {
+        problems.push_back(
+          "Unknown option " + assignment.first + " from " + source
+          );
+      }
+      else if (!assign(snapshot.values[itr->second], assignment.second))
+      {
+        problems.push_back(
+          assignment.second + " from " + source +
+          " is not a valid value for " + assignment.first
+          );
+      }
+    }
+  });
 }
+
+void GameOptions::watchLoop()
+{
+  std::unique_lock<std::mutex> lock(watchMutex);
+  FileStamp last = getFileStamp(watchedFile);
+  while (!watchWake.wait_for(lock, WATCH_INTERVAL,
+                             [this] { return stopWatching; }))
+  {
+    const FileStamp stamp = getFileStamp(watchedFile);
+    if (stamp.modified != 0 && stamp != last)
+    {
+      last = stamp;
+      lock.unlock();
+      reloadWatchedFile();
+      lock.lock();
+    }
+  }
+}
+
+void GameOptions::reloadWatchedFile()
+{
+  std::string filename;
+  Assignments previous;
+  {
+    std::lock_guard<std::mutex> lock(watchMutex);
+    filename = watchedFile;
+    previous = fileValues;
+  }
+
+  Assignments loaded;
+  std::vector<std::string> problems;
+  if (!parseFile(filename, loaded, problems))
+  {
+    problems.push_back("Could not reload " + filename);
+  }
+  else
+  {
+    // only what was edited, anything set elsewhere since is left alone
+    Assignments edited;
+    for (auto& assignment : loaded)
+    {
+      if (std::find(previous.begin(), previous.end(), assignment) ==
+          previous.end())
+      {
+        edited.push_back(assignment);
+      }
+    }
+    apply(edited, filename, problems);
+
+    std::lock_guard<std::mutex> lock(watchMutex);
+    fileValues = loaded;
+  }
+
+  // the log isn't thread safe, update() writes these out
+  std::lock_guard<std::mutex> lock(writeMutex);
+  messages.insert(messages.end(), problems.begin(), problems.end());
+}
\ No newline at end of file
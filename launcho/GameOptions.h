@@ -1,11 +1,62 @@
 #pragma once
 
 #include "utility/Singleton.h"
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+class GameOptions;
+
+/**
+ * A direct reference to the value of an option, for code that reads an
+ * option often enough that a lookup by name would show up. The value is
+ * parsed when the option is set, so reading it is just a couple of pointer
+ * reads without any locking, and it always reflects the latest value.
+ */
+template<typename T>
+class OptionHandle
+{
+private:
+  const GameOptions* options;
+  std::size_t slot;
+
+public:
+  OptionHandle();
+  OptionHandle(const GameOptions* _options, const std::size_t _slot);
+
+  /**
+   * The reference is only good until the next GameOptions::update(), copy
+   * the value to keep it longer.
+   */
+  const T& get() const;
+  bool isValid() const;
+};
+
+// identifies a change callback so it can be removed
+using OptionCallbackID = uint32_t;
+// called with the name of the option that changed
+using OptionCallback = std::function<void(const std::string& key)>;
 
 /**
  * Holds settings for the game configuration.
+ * Every option is registered with a default in main() before anything is
+ * loaded. The type of the default decides how values from the config file
+ * and command line are parsed, and options that were never registered are
+ * rejected so typos don't go unnoticed.
+ * Options live in an immutable snapshot. Changing anything builds a new
+ * snapshot and swaps it in atomically, so readers on any thread never lock
+ * and always see a consistent set of values. Replaced snapshots are freed in
+ * update(), which the main loop calls between frames when nothing can still
+ * be reading them.
  */
 class GameOptions final
   : public Singleton<GameOptions>
@@ -13,21 +64,107 @@ class GameOptions final
 private:
   static const std::string TAG;
 
-  std::unordered_map<std::string, std::string> options;
+  template<typename T>
+  friend class OptionHandle;
+
+  enum class OptionType
+  {
+    String,
+    Int,
+    Float
+  };
+
+  // every representation is kept so any getter is a plain read
+  struct Option
+  {
+    OptionType type;
+    std::string text;
+    int intValue;
+    float floatValue;
+  };
+
+  struct Snapshot
+  {
+    // options are never removed, so a slot means the same option in every
+    // snapshot
+    std::vector<Option> values;
+    std::unordered_map<std::string, std::size_t> slots;
+  };
+
+  using Assignments = std::vector<std::pair<std::string, std::string>>;
+
+  std::atomic<const Snapshot*> current;
+
+  // everything below is guarded by writeMutex
+  std::mutex writeMutex;
+  std::unique_ptr<const Snapshot> live;
+  // replaced snapshots waiting for update()
+  std::vector<std::unique_ptr<const Snapshot>> retired;
+  // keys changed since the last update()
+  std::vector<std::string> changedKeys;
+  // messages from the watcher thread, logged in update()
+  std::vector<std::string> messages;
+
+  // only used on the main thread
+  struct Listener
+  {
+    OptionCallbackID id;
+    std::string key;
+    OptionCallback callback;
+  };
+  std::vector<Listener> listeners;
+  OptionCallbackID nextListenerID;
+
+  // file watching
+  std::thread watcher;
+  std::mutex watchMutex;
+  std::condition_variable watchWake;
+  bool stopWatching;
+  std::string watchedFile;
+  // values from the last time the file was loaded, a reload only applies
+  // the ones that changed so command line overrides stay in place
+  Assignments fileValues;
 
 public:
+  ~GameOptions();
+
   /**
-   * Parses game settings from command line options.
+   * Parses game settings from command line options, in the form
+   * --key=value.
    * @param argc Arg count.
    * @param argv Arg strings.
    */
   void parseCommandLine(int argc, char* argv[]);
 
   /**
-   * Load game settings from a config file.
+   * Load game settings from a config file. Each line is key = value, and
+   * anything after a # is a comment.
    * @param filename Path of the file to load.
+   * @return false if the file couldn't be opened.
+   */
+  bool loadFromFile(const std::string& filename);
+
+  /**
+   * Starts a thread that reloads a config file whenever it is saved. Only
+   * the values that changed in the file are applied.
    */
-  void loadFromFile(const std::string& filename);
+  void watchFile(const std::string& filename);
+  void stopWatchingFile();
+
+  /**
+   * Frees replaced snapshots, logs messages from the watcher and calls the
+   * callbacks of options that changed. Call from the main thread between
+   * frames, while no other thread is reading options.
+   */
+  void update();
+
+  /**
+   * Calls back from update() whenever an option changes.
+   * @return An id for removeChangeCallback().
+   */
+  OptionCallbackID addChangeCallback(const std::string& key,
+                                     OptionCallback callback);
+  void removeChangeCallback(const OptionCallbackID id);
 
   /**
    * Dumps all current options to the log file.
@@ -54,10 +191,10 @@ public:
   /**
    * Gets an option from the settings.
    * @param key The setting to get.
-   * @return The string for the option.
+   * @return The string for the option, good until the next update().
    * @throws std::out_of_range key is not a valid option.
    */
-  std::string getString(const std::string& key) const;
+  const std::string& getString(const std::string& key) const;
 
   /**
    * Returns an option as an int. See getString().
@@ -69,7 +206,105 @@ public:
    */
   float getFloat(const std::string& key) const;
 
+  /**
+   * Returns a handle to the value of an option, see OptionHandle.
+   * @throws std::out_of_range key is not a valid option.
+   */
+  OptionHandle<std::string> getStringHandle(const std::string& key) const;
+  OptionHandle<int> getIntHandle(const std::string& key) const;
+  OptionHandle<float> getFloatHandle(const std::string& key) const;
+
 private:
   friend class Singleton<GameOptions>;
-  GameOptions() = default;
-};
\ No newline at end of file
+  GameOptions();
+
+  const Snapshot& getSnapshot() const;
+  const Option& find(const std::string& key) const;
+  std::size_t findSlot(const std::string& key) const;
+
+  /**
+   * Copies the live snapshot, lets edit change the copy and publishes it.
+   * Keys whose text changed are queued for the change callbacks.
+   */
+  void publish(const std::function<void(Snapshot&)>& edit);
+  // adds the option to a snapshot being built if it isn't there yet
+  static Option& findOrAdd(Snapshot& snapshot, const std::string& key,
+                           const OptionType type);
+  /**
+   * Sets an option from text, parsed according to its type.
+   * @return false if the text isn't a valid value, the option is unchanged.
+   */
+  static bool assign(Option& option, const std::string& text);
+
+  /**
+   * Reads the key = value lines of a config file.
+   * @param problems[out] Lines that couldn't be read are described here.
+   * @return false if the file couldn't be opened.
+   */
+  static bool parseFile(const std::string& filename, Assignments& out,
+                        std::vector<std::string>& problems);
+  /**
+   * Sets registered options in a single snapshot.
+   * @param problems[out] Unknown keys and bad values are described here.
+   */
+  void apply(const Assignments& assignments, const std::string& source,
+             std::vector<std::string>& problems);
+
+  void watchLoop();
+  void reloadWatchedFile();
+
+  template<typename T>
+  const T& getValue(const std::size_t slot) const;
+};
+
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+
+template<typename T>
+OptionHandle<T>::OptionHandle()
+  : options(nullptr), slot(0)
+{}
+
+template<typename T>
+OptionHandle<T>::OptionHandle(const GameOptions* _options,
+                              const std::size_t _slot)
+  : options(_options), slot(_slot)
+{}
+
+template<typename T>
+const T& OptionHandle<T>::get() const
+{
+  assert(options != nullptr);
+  return options->getValue<T>(slot);
+}
+
+template<typename T>
+bool OptionHandle<T>::isValid() const
+{
+  return options != nullptr;
+}
+
+inline const GameOptions::Snapshot& GameOptions::getSnapshot() const
+{
+  return *current.load(std::memory_order_acquire);
+}
+
+template<>
+inline const int& GameOptions::getValue<int>(const std::size_t slot) const
+{
+  return getSnapshot().values[slot].intValue;
+}
+
+template<>
+inline const float& GameOptions::getValue<float>(const std::size_t slot) const
+{
+  return getSnapshot().values[slot].floatValue;
+}
+
+template<>
+inline const std::string& GameOptions::getValue<std::string>(
+  const std::size_t slot) const
+{
+  return getSnapshot().values[slot].text;
+}
\ No newline at end of file
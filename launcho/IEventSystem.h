@@ -49,4 +49,7 @@ public:
   // aborts all events of the type
   // returns the number of events aborted
   virtual uint32_t abortAllEvents(const EventID id) = 0;
+
+  // number of events waiting in the queue
+  virtual std::size_t getQueuedEventCount() const = 0;
 };
\ No newline at end of file
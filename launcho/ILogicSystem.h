@@ -2,6 +2,8 @@
 
 #include "Entity.h"
 #include "types.h"
+#include "input/InputState.h"
+#include "utility/ByteStream.h"
 
 class ILogicSystem
 {
@@ -24,6 +26,29 @@ public:
    */
   virtual void destroy() = 0;
 
+  /**
+   * Saves the state of every entity, for replay keyframes.
+   */
+  virtual void saveState(ByteWriter& out) const = 0;
+
+  /**
+   * Restores what saveState() wrote.
+   * @return false if the state is corrupt or doesn't match the entities.
+   */
+  virtual bool loadState(ByteReader& in) = 0;
+
+  /**
+   * Rebuilds the Box2D bodies of every entity, in order of their ids, after
+   * the physics system replaced its world.
+   */
+  virtual void rebuildPhysics() = 0;
+
+  /**
+   * Moves a player with its input for this tick.
+   * @param id Entity the player controls.
+   */
+  virtual void applyInput(const EntityID id, const InputState& input) = 0;
+
   // Adds an entity to the logic system.
   virtual void addEntity(StrongEntityPtr entity) = 0;
 
@@ -42,4 +67,7 @@ public:
 
   // Shortcut to get the player entity
   virtual WeakEntityPtr getPlayer() = 0;
+
+  // number of entities in the game
+  virtual std::size_t getEntityCount() const = 0;
 };
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include "InputSystem.h"
+#include "options.h"
+#include "utility/AllocationTracker.h"
+#include "utility/Log.h"
+#include <algorithm>
+#include <sstream>
+
+const std::string InputSystem::TAG = "InputSystem";
+
+// the option holding the keys of each action, in InputAction order
+static const std::string* const BINDING_OPTIONS[] = {
+  &INPUT_MOVE_UP,
+  &INPUT_MOVE_DOWN,
+  &INPUT_MOVE_LEFT,
+  &INPUT_MOVE_RIGHT,
+  &INPUT_FIRE
+};
+static_assert(
+  sizeof(BINDING_OPTIONS) / sizeof(BINDING_OPTIONS[0]) ==
+    static_cast<std::size_t>(InputAction::Count),
+  "Every action needs a binding option"
+  );
+
+// looks up a key by the name of its sf::Keyboard constant
+static sf::Keyboard::Key parseKey(const std::string& name)
+{
+  if (name.size() == 1 && name[0] >= 'A' && name[0] <= 'Z')
+  {
+    return static_cast<sf::Keyboard::Key>(sf::Keyboard::A + (name[0] - 'A'));
+  }
+  if (name.size() == 4 && name.compare(0, 3, "Num") == 0 &&
+      name[3] >= '0' && name[3] <= '9')
+  {
+    return static_cast<sf::Keyboard::Key>(
+      sf::Keyboard::Num0 + (name[3] - '0')
+      );
+  }
+
+  static const struct
+  {
+    const char* name;
+    sf::Keyboard::Key key;
+  } named[] = {
+    { "Up", sf::Keyboard::Up },
+    { "Down", sf::Keyboard::Down },
+    { "Left", sf::Keyboard::Left },
+    { "Right", sf::Keyboard::Right },
+    { "Space", sf::Keyboard::Space },
+    { "Return", sf::Keyboard::Return },
+    { "Escape", sf::Keyboard::Escape },
+    { "Tab", sf::Keyboard::Tab },
+    { "LShift", sf::Keyboard::LShift },
+    { "RShift", sf::Keyboard::RShift },
+    { "LControl", sf::Keyboard::LControl },
+    { "RControl", sf::Keyboard::RControl },
+    { "LAlt", sf::Keyboard::LAlt },
+    { "RAlt", sf::Keyboard::RAlt }
+  };
+  for (auto& entry : named)
+  {
+    if (name == entry.name)
+    {
+      return entry.key;
+    }
+  }
+  return sf::Keyboard::Unknown;
+}
+
+InputSystem::InputSystem()
+: bindings(),
+  keysDown(),
+  down(0),
+  pressedSinceSample(0),
+  releasedSinceSample(0),
+  state(),
+  optionCallbacks(),
+  seed(0),
+  recorder(),
+  replay(),
+  replayTick(0)
+{
+}
+
+void InputSystem::initialize(const uint32_t _seed)
+{
+  const int tickRate = GameOptions::getInstance().getInt(LOGIC_TICK_RATE);
+  const std::string replayFile =
+    GameOptions::getInstance().getString(INPUT_REPLAY);
+  const std::string recordFile =
+    GameOptions::getInstance().getString(INPUT_RECORD);
+  seed = _seed;
+  replayTick = 0;
+
+  if (!replayFile.empty() && replay.open(replayFile))
+  {
+    seed = replay.getSeed();
+    // ticks only line up with the replay at its own rate
+    if (replay.getTickRate() != static_cast<uint32_t>(tickRate))
+    {
+      Log::warning(
+        TAG,
+        "Replay was recorded at %u ticks/s, switching from %d",
+        replay.getTickRate(),
+        tickRate
+        );
+      GameOptions::getInstance().setInt(
+        LOGIC_TICK_RATE,
+        static_cast<int>(replay.getTickRate())
+        );
+    }
+  }
+  else if (!recordFile.empty())
+  {
+    recorder.open(
+      recordFile,
+      seed,
+      static_cast<uint32_t>(std::max(1, tickRate)),
+      static_cast<uint32_t>(std::max(
+        1,
+        GameOptions::getInstance().getInt(INPUT_KEYFRAME_INTERVAL)
+        ))
+      );
+  }
+
+  loadBindings();
+  for (auto option : BINDING_OPTIONS)
+  {
+    optionCallbacks.push_back(GameOptions::getInstance().addChangeCallback(
+      *option,
+      [this](const std::string&) { loadBindings(); }
+      ));
+  }
+}
+
+void InputSystem::update()
+{
+  AllocationScope allocations(AllocationTag::Events);
+  if (replay.isOpen())
+  {
+    // nothing is held once the replay runs out
+    if (replayTick >= replay.getTickCount() ||
+        !replay.getTick(replayTick, state))
+    {
+      state = InputState();
+    }
+    replayTick++;
+    return;
+  }
+
+  // a tap that starts and ends between two samples still counts for a tick
+  state = InputState(
+    down | pressedSinceSample,
+    pressedSinceSample,
+    releasedSinceSample
+    );
+  pressedSinceSample = 0;
+  releasedSinceSample = 0;
+
+  if (recorder.isOpen())
+  {
+    recorder.addTick(state);
+  }
+}
+
+void InputSystem::destroy()
+{
+  for (auto id : optionCallbacks)
+  {
+    GameOptions::getInstance().removeChangeCallback(id);
+  }
+  optionCallbacks.clear();
+
+  recorder.close();
+  replay.close();
+}
+
+void InputSystem::onKey(const sf::Keyboard::Key key, const bool pressed)
+{
+  // key repeats come in as more presses, and a replay ignores the keyboard
+  if (replay.isOpen() || key < 0 || key >= sf::Keyboard::KeyCount ||
+      keysDown[key] == pressed)
+  {
+    return;
+  }
+
+  keysDown[key] = pressed;
+  const InputMask now = actionsDown();
+  pressedSinceSample |= now & ~down;
+  releasedSinceSample |= down & ~now;
+  down = now;
+}
+
+void InputSystem::releaseAll()
+{
+  keysDown.fill(false);
+  releasedSinceSample |= down;
+  down = 0;
+}
+
+const InputState& InputSystem::getState() const
+{
+  return state;
+}
+
+bool InputSystem::isReplaying() const
+{
+  return replay.isOpen();
+}
+
+bool InputSystem::isReplayFinished() const
+{
+  return replay.isOpen() && replayTick >= replay.getTickCount();
+}
+
+uint32_t InputSystem::getReplayTick() const
+{
+  return replayTick;
+}
+
+uint32_t InputSystem::getReplayTickCount() const
+{
+  return replay.getTickCount();
+}
+
+bool InputSystem::rewindReplay(const uint32_t tick,
+                               std::vector<uint8_t>& state)
+{
+  uint32_t keyTick;
+  if (!replay.isOpen() || !replay.getKeyframe(tick, keyTick, state))
+  {
+    return false;
+  }
+  replayTick = keyTick;
+  return true;
+}
+
+bool InputSystem::isKeyframeDue() const
+{
+  return recorder.needsKeyframe() ||
+         (replay.isOpen() && replay.isKeyframeTick(replayTick));
+}
+
+bool InputSystem::isRecording() const
+{
+  return recorder.isOpen();
+}
+
+void InputSystem::addKeyframe(std::vector<uint8_t>&& state)
+{
+  recorder.addKeyframe(std::move(state));
+}
+
+uint32_t InputSystem::getSeed() const
+{
+  return seed;
+}
+
+void InputSystem::loadBindings()
+{
+  bindings.fill(0);
+  for (std::size_t i = 0; i < static_cast<std::size_t>(InputAction::Count);
+       i++)
+  {
+    // comma separated key names
+    std::istringstream keys(
+      GameOptions::getInstance().getString(*BINDING_OPTIONS[i])
+      );
+    std::string name;
+    while (std::getline(keys, name, ','))
+    {
+      const sf::Keyboard::Key key = parseKey(name);
+      if (key == sf::Keyboard::Unknown)
+      {
+        Log::warning(
+          TAG,
+          "Unknown key %s for %s",
+          name.c_str(),
+          BINDING_OPTIONS[i]->c_str()
+          );
+        continue;
+      }
+      bindings[key] |= inputBit(static_cast<InputAction>(i));
+    }
+  }
+
+  // keys that are down now may be bound differently
+  const InputMask now = actionsDown();
+  releasedSinceSample |= down & ~now;
+  pressedSinceSample |= now & ~down;
+  down = now;
+  Log::debug(TAG, "Key bindings loaded");
+}
+
+InputMask InputSystem::actionsDown() const
+{
+  InputMask mask = 0;
+  for (int key = 0; key < sf::Keyboard::KeyCount; key++)
+  {
+    if (keysDown[key])
+    {
+      mask |= bindings[key];
+    }
+  }
+  return mask;
+}
\ No newline at end of file
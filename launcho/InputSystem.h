@@ -0,0 +1,94 @@
+#pragma once
+
+#include "GameOptions.h"
+#include "input/ReplayReader.h"
+#include "input/ReplayWriter.h"
+#include "input/InputState.h"
+#include <SFML/Window/Keyboard.hpp>
+#include <array>
+#include <string>
+#include <vector>
+
+/**
+ * Turns keyboard input into the actions gameplay cares about. Keys are bound
+ * to actions with options, and window events only flip bits as they arrive.
+ * Once per logic tick update() samples them into an InputState that
+ * gameplay reads directly, so nothing is allocated or queued per key press.
+ * The sampled input can be recorded to a replay file, and a replay can be
+ * played back in place of the keyboard to repeat a run, or from any of its
+ * keyframes to jump into the middle of one.
+ */
+class InputSystem
+{
+private:
+  static const std::string TAG;
+
+  // actions each key is bound to
+  std::array<InputMask, sf::Keyboard::KeyCount> bindings;
+  // several keys can be bound to an action, it is only released once none of
+  // them are down
+  std::array<bool, sf::Keyboard::KeyCount> keysDown;
+  // actions down right now, and edges since the last sample
+  InputMask down;
+  InputMask pressedSinceSample;
+  InputMask releasedSinceSample;
+
+  InputState state;
+  std::vector<OptionCallbackID> optionCallbacks;
+
+  // the seed of the run, a replay brings its own
+  uint32_t seed;
+  ReplayWriter recorder;
+  ReplayReader replay;
+  // the next tick read from the replay
+  uint32_t replayTick;
+
+public:
+  InputSystem();
+
+  /**
+   * Starts recording or replaying if the options ask for it.
+   * @param seed The random seed of a new run, saved with its recording.
+   */
+  void initialize(const uint32_t seed);
+  // samples the input for a logic tick, or reads it from the replay
+  void update();
+  void destroy();
+
+  // called with window events as they are polled
+  void onKey(const sf::Keyboard::Key key, const bool pressed);
+  // releases everything, for when the window loses focus
+  void releaseAll();
+
+  // input for the current logic tick
+  const InputState& getState() const;
+
+  bool isReplaying() const;
+  // every tick of the replay has been played
+  bool isReplayFinished() const;
+  uint32_t getReplayTick() const;
+  uint32_t getReplayTickCount() const;
+
+  /**
+   * Moves the replay back to the last keyframe at or before a tick.
+   * @param state[out] The world state to restore, as of the new replay tick.
+   * @return false if there is no replay, or the keyframe couldn't be read.
+   */
+  bool rewindReplay(const uint32_t tick, std::vector<uint8_t>& state);
+
+  /**
+   * Checks if the next tick starts at a keyframe. A recording has to save the
+   * world state before it is sampled, so the recording can be seeked to it.
+   */
+  bool isKeyframeDue() const;
+  bool isRecording() const;
+  void addKeyframe(std::vector<uint8_t>&& state);
+  // the seed the run should use, a replay overrides the one it was given
+  uint32_t getSeed() const;
+
+private:
+  // builds the key table from the binding options
+  void loadBindings();
+  // actions with at least one of their keys down
+  InputMask actionsDown() const;
+};
\ No newline at end of file
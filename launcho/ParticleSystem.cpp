@@ -0,0 +1,71 @@
+#include "ParticleSystem.h"
+#include "Game.h"
+#include "utility/AllocationTracker.h"
+#include "utility/Log.h"
+#include <algorithm>
+
+const std::string ParticleSystem::TAG = "ParticleSystem";
+
+ParticleSystem::ParticleSystem()
+: emitters(),
+  particleCount(0)
+{
+}
+
+void ParticleSystem::initialize()
+{
+}
+
+void ParticleSystem::update(const float deltaMs)
+{
+  AllocationScope allocations(AllocationTag::Particles);
+  const float dt = deltaMs / 1000.0f;
+  Game::getInstance().getWorkerPool()->parallelFor(
+    emitters.size(),
+    1,
+    [&](const std::size_t begin, const std::size_t end) {
+      for (std::size_t i = begin; i < end; i++)
+      {
+        emitters[i]->simulate(dt);
+      }
+    });
+
+  particleCount = 0;
+  for (auto emitter : emitters)
+  {
+    particleCount += emitter->getParticleCount();
+  }
+}
+
+void ParticleSystem::destroy()
+{
+  if (!emitters.empty())
+  {
+    Log::warning(
+      TAG,
+      "%u emitters still registered",
+      static_cast<unsigned>(emitters.size())
+      );
+  }
+  emitters.clear();
+}
+
+void ParticleSystem::addEmitter(ParticleEmitterComponent* emitter)
+{
+  emitters.push_back(emitter);
+}
+
+void ParticleSystem::removeEmitter(ParticleEmitterComponent* emitter)
+{
+  auto itr = std::find(emitters.begin(), emitters.end(), emitter);
+  if (itr != emitters.end())
+  {
+    *itr = emitters.back();
+    emitters.pop_back();
+  }
+}
+
+std::size_t ParticleSystem::getParticleCount() const
+{
+  return particleCount;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "components/ParticleEmitterComponent.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Simulates every particle emitter once per frame. Emitters are independent,
+ * so they are spread over the worker pool.
+ */
+class ParticleSystem
+{
+private:
+  static const std::string TAG;
+
+  std::vector<ParticleEmitterComponent*> emitters;
+  std::size_t particleCount;
+
+public:
+  ParticleSystem();
+
+  void initialize();
+  void update(const float deltaMs);
+  void destroy();
+
+  // called by emitters when they are initialized and destroyed
+  void addEmitter(ParticleEmitterComponent* emitter);
+  void removeEmitter(ParticleEmitterComponent* emitter);
+
+  // particles alive after the last update
+  std::size_t getParticleCount() const;
+};
\ No newline at end of file
@@ -4,8 +4,9 @@
 #include "Game.h"
 #include "Entity.h"
 #include "components/PhysicsComponent.h"
-#include "events/EntityEvents.h"
+#include "utility/AllocationTracker.h"
 #include "utility/Log.h"
+#include <algorithm>
 #include <string>
 #include <cassert>
 #include <functional>
@@ -13,17 +14,37 @@
 
 const std::string SFMLRenderer::TAG = "SFMLRenderer";
 
+// how far past each edge of the view the layer caches extend, in pixels
+static const unsigned CACHE_MARGIN = 256;
+
 SFMLRenderer::SFMLRenderer(std::shared_ptr<sf::RenderWindow> _window)
 : window(_window),
   view(),
   renderTexture(),
   timer(),
-  renderables(),
-  sortedRenderables(),
-  needSortUpdate(false),
+  resolution(),
+  frameCount(0),
+  capture(),
+  readback(),
+  asyncReadback(false),
+  queue(),
+  culling(true),
+  visible(),
+  culledCount(0),
+  commands(),
+  buildTime(0.0f),
+  layerCaching(true),
+  caches(),
+  cachedLayers(),
+  cachedMask(),
+  cacheList(),
+  cacheCommands(),
+  batching(true),
+  drawCalls(0),
   font(),
-  addedCallbackID(0),
-  removedCallbackID(0)
+  showStats(true),
+  stats(),
+  optionCallbacks()
 {
   assert(window != nullptr);
 }
@@ -53,47 +74,105 @@ void SFMLRenderer::initialize()
   }
   renderTexture.setView(view);
 
+  capture.initialize(
+    width,
+    height,
+    GameOptions::getInstance().getString(CAPTURE_PREFIX),
+    GameOptions::getInstance().getString(CAPTURE_FORMAT),
+    static_cast<uint32_t>(GameOptions::getInstance().getInt(CAPTURE_INTERVAL)),
+    static_cast<unsigned>(GameOptions::getInstance().getInt(CAPTURE_BUFFERS))
+    );
+  if (capture.isEnabled())
+  {
+    window->setActive(true);
+    asyncReadback = readback.initialize(width, height);
+    if (!asyncReadback)
+    {
+      Log::warning(TAG, "Capturing with synchronous reads, expect stalls");
+    }
+  }
+
+  applyOptions();
+  for (auto& key : { RENDER_BATCHING, RENDER_CULLING,
+                     DYNAMIC_RESOLUTION_BUDGET, DYNAMIC_RESOLUTION_MIN })
+  {
+    optionCallbacks.push_back(GameOptions::getInstance().addChangeCallback(
+      key,
+      [this](const std::string&) { applyOptions(); }
+      ));
+  }
+  layerCaching = GameOptions::getInstance().getInt(RENDER_LAYER_CACHE) != 0;
+  Log::debug(TAG, "Layer caching %s", layerCaching ? "enabled" : "disabled");
+  if (layerCaching)
+  {
+    createLayerCache(RenderLayer::Background, width, height);
+    createLayerCache(RenderLayer::Scenery, width, height);
+  }
+
   // load font for UI
+  showStats = GameOptions::getInstance().getInt(STATS_OVERLAY) != 0;
   if (!font.loadFromFile("data/fonts/arial.ttf"))
   {
     Log::error(TAG, "Could not load arial font");
+    showStats = false;
+  }
+  if (showStats)
+  {
+    createStatsOverlay();
   }
 
-  // event registration
-  auto evtMgr = Game::getInstance().getEventSystem();
-  addedCallbackID = evtMgr->generateNextCallbackID();
-  evtMgr->addListener(
-    EntityAddedEvent::ID,
-    addedCallbackID,
-    std::bind(&SFMLRenderer::entityAddedCallback, this, std::placeholders::_1)
-    );
-  removedCallbackID = evtMgr->generateNextCallbackID();
-  evtMgr->addListener(
-    EntityRemovedEvent::ID,
-    removedCallbackID,
-    std::bind(&SFMLRenderer::entityRemovedCallback, this, std::placeholders::_1)
-    );
+  queue.initialize();
 }
 
 void SFMLRenderer::update(const float deltaMs)
 {
+  AllocationScope allocations(AllocationTag::Render);
   timer.start(); 
 
   // TODO update view pos as the player moves
-  renderTexture.setView(view);
-  window->setView(view);
+  // the view covers the same part of the world at any scale, it is only
+  // squeezed into the upper left of the texture
+  const float scale = resolution.getScale();
+  sf::View scaledView(view);
+  scaledView.setViewport(sf::FloatRect(0.0f, 0.0f, scale, scale));
+  renderTexture.setView(scaledView);
 
   renderTexture.clear(sf::Color::White);  
 
-  sortRenderables();
-  for (auto rc : sortedRenderables)
+  // images added since the last frame
+  Game::getInstance().getTextureAtlas()->upload();
+
+  queue.update();
+  // cached layers are drawn from their textures, so their commands are only
+  // built when a cache is redrawn
+  queue.findVisible(getViewBounds(), culling, cachedMask, visible);
+  std::size_t notCulled = visible.size();
+  for (int layer : cachedLayers)
   {
-    rc->draw(renderTexture);
+    notCulled += queue.getLayerSize(layer);
   }
+  culledCount = static_cast<unsigned>(queue.size() - notCulled);
+  drawCalls = 0;
+  buildTime = 0.0f;
+  buildCommands(visible, commands);
+  submit(commands, renderTexture, true);
 
-  drawUI();
   renderTexture.display();
-  window->draw(sf::Sprite(renderTexture.getTexture()));
+
+  // stretch what was drawn over the whole window
+  const sf::Vector2u size = renderTexture.getSize();
+  const sf::Vector2u scaled = getScaledSize();
+  sf::Sprite frame(
+    renderTexture.getTexture(),
+    sf::IntRect(0, 0, scaled.x, scaled.y)
+    );
+  frame.setScale(
+    static_cast<float>(size.x) / scaled.x,
+    static_cast<float>(size.y) / scaled.y
+    );
+  window->setView(window->getDefaultView());
+  window->draw(frame);
+  drawUI();
 
   // HACK: SFML 2.1 is a piece of shit and doesn't clear correctly on certain
   // gfx cards... supposed to be fixed in 2.2
@@ -102,127 +181,392 @@ void SFMLRenderer::update(const float deltaMs)
   shape.setFillColor(sf::Color(0, 0, 0, 0));
   window->draw(shape);
 
+  captureFrame();
   window->display();
-  Log::verbose(TAG, "Rendering complete in %.2fms", timer.elapsedMilliF());
+  frameCount++;
+
+  // without vsync display() waits on the gpu once it falls behind, so this
+  // includes the fill cost the scale is meant to bring down
+  const float renderMs = timer.elapsedMilliF();
+  if (resolution.update(renderMs))
+  {
+    renderTexture.setSmooth(resolution.getScale() < 1.0f);
+  }
+
+  Log::verbose(
+    TAG,
+    "Rendering complete in %.2fms (%.2fms building), %u draw calls, "
+    "%u drawn, %u culled",
+    renderMs,
+    buildTime,
+    drawCalls,
+    static_cast<unsigned>(visible.size()),
+    culledCount
+    );
 }
 
 void SFMLRenderer::destroy()
 {
-  auto evtMgr = Game::getInstance().getEventSystem();
-  evtMgr->removeListener(EntityAddedEvent::ID, addedCallbackID);
-  evtMgr->removeListener(EntityRemovedEvent::ID, removedCallbackID);
-}
+  queue.destroy();
+  for (auto id : optionCallbacks)
+  {
+    GameOptions::getInstance().removeChangeCallback(id);
+  }
+  optionCallbacks.clear();
 
-void SFMLRenderer::sortRenderables()
-{
-  if (needSortUpdate)
+  // reads still in flight need the window's context
+  if (asyncReadback && window->isOpen())
   {
-    auto sorter = 
-      [](StrongRenderComponentPtr rc1, StrongRenderComponentPtr rc2) {
-        // sort in reverse order
-        return rc1->getLayer() > rc2->getLayer();
-    };
+    window->setActive(true);
+    while (collectReadback())
+    {
+    }
+  }
+  readback.destroy();
+  capture.destroy();
 
-    std::sort(
-      sortedRenderables.begin(),
-      sortedRenderables.end(),
-      sorter
-      );
-    needSortUpdate = false;
+  for (auto& cache : caches)
+  {
+    cache.texture.reset();
   }
 }
 
-void SFMLRenderer::drawUI()
+AABB2 SFMLRenderer::getViewBounds() const
 {
-//   auto player = Game::getInstance().getLogicSystem()->getPlayer().lock();
-//   assert(player != nullptr);
-//   auto physics = player->getComponent<PhysicsComponent>().lock();
-//   assert(physics != nullptr);
-//   Vector2 vel = physics->getVelocity();
-// 
-//   char buffer[32];
-//   sprintf_s(buffer, 32, "Velocity <%01.2f, %01.2f>", vel.x, vel.y);
-//   sf::Text text(buffer, font, 18);
-//   text.setPosition(10.0f, 10.0f);
-//   text.setColor(sf::Color::Black);
-// 
-//   renderTexture.draw(text);
-}
-
-void SFMLRenderer::entityAddedCallback(StrongEventPtr evt)
-{
-  auto eae = Event::cast<EntityAddedEvent>(evt);
-  if (eae == nullptr)
-  {
-    Log::error(
-      TAG,
-      "Couldn't cast to EntityAddedEvent, type %u (%s)",
-      evt->getID(),
-      evt->getNameC()
-      );
-    return;
-  }
+  // the view is in SFML coordinates, which have y flipped
+  const sf::Vector2f& center = view.getCenter();
+  const sf::Vector2f& size = view.getSize();
+  const float targetHeight = static_cast<float>(renderTexture.getSize().y);
+  return AABB2(Vector2(center.x, targetHeight - center.y), size.x, size.y);
+}
+
+sf::Vector2u SFMLRenderer::getScaledSize() const
+{
+  // rounded the same way SFML rounds viewports
+  const sf::Vector2u size = renderTexture.getSize();
+  const float scale = resolution.getScale();
+  return sf::Vector2u(
+    static_cast<unsigned>(0.5f + (size.x * scale)),
+    static_cast<unsigned>(0.5f + (size.y * scale))
+    );
+}
+
+void SFMLRenderer::buildCommands(
+  const RenderList& components, RenderCommandBuffer& buffer)
+{
+  Timer buildTimer(true);
+  const float targetHeight = static_cast<float>(renderTexture.getSize().y);
+  buffer.build(
+    components,
+    targetHeight,
+    *Game::getInstance().getWorkerPool()
+    );
+  buildTime += buildTimer.elapsedMilliF();
+}
 
-  auto entity = 
-    Game::getInstance().getLogicSystem()->getEntity(eae->entity).lock();
-  assert(entity != nullptr);
+void SFMLRenderer::submit(const RenderCommandBuffer& buffer,
+                          sf::RenderTarget& target, const bool useCaches)
+{
+  const AABB2 viewBounds = getViewBounds();
+  std::size_t nextCache = 0;
+  std::size_t runStart = 0;
+  std::size_t runCount = 0;
 
-  auto rc = entity->getComponent<RenderComponent>().lock();
-  if (rc != nullptr)
+  for (std::size_t i = 0; i < buffer.size(); i++)
   {
-    if (renderables.find(entity->getID()) != renderables.end())
+    const RenderCommand& command = buffer.getCommand(i);
+
+    // cached layers aren't in the list, the list is in layer order so each
+    // one is composited before the first command in front of it
+    const int layer = static_cast<int>(command.layer);
+    while (useCaches && nextCache < cachedLayers.size() &&
+           cachedLayers[nextCache] > layer)
     {
-      Log::error(TAG, "Tried to add duplicate entity %u", entity->getID());
+      drawRun(buffer, target, runStart, runCount);
+      runCount = 0;
+      drawLayerCache(cachedLayers[nextCache++], viewBounds);
     }
-    else
+
+    // keep the draw order for anything that has to be drawn by itself
+    if (command.custom)
     {
-      renderables[entity->getID()] = rc;
-      sortedRenderables.push_back(rc);
-      needSortUpdate = true;
+      drawRun(buffer, target, runStart, runCount);
+      runCount = 0;
+      command.component->draw(target);
+      drawCalls++;
+      continue;
     }
+
+    // consecutive quads can share a call across layers as long as they use
+    // the same texture
+    if (runCount > 0 &&
+        (!batching || command.texture != buffer.getCommand(runStart).texture))
+    {
+      drawRun(buffer, target, runStart, runCount);
+      runCount = 0;
+    }
+    if (runCount == 0)
+    {
+      runStart = i;
+    }
+    runCount++;
+  }
+
+  drawRun(buffer, target, runStart, runCount);
+  while (useCaches && nextCache < cachedLayers.size())
+  {
+    drawLayerCache(cachedLayers[nextCache++], viewBounds);
+  }
+}
+
+void SFMLRenderer::drawRun(const RenderCommandBuffer& buffer,
+                           sf::RenderTarget& target, const std::size_t start,
+                           const std::size_t count)
+{
+  if (count > 0)
+  {
+    sf::RenderStates states;
+    states.texture = buffer.getCommand(start).texture;
+    target.draw(buffer.getQuad(start), count * 4, sf::Quads, states);
+    drawCalls++;
+  }
+}
+
+void SFMLRenderer::createLayerCache(const RenderLayer layer,
+                                    const unsigned width, const unsigned height)
+{
+  LayerCache& cache = caches[static_cast<int>(layer)];
+  cache.texture.reset(new sf::RenderTexture());
+  if (!cache.texture->create(width + (CACHE_MARGIN * 2),
+                             height + (CACHE_MARGIN * 2)))
+  {
+    // the layer is drawn directly instead
+    Log::error(TAG, "Unable to create cache for layer %d", (int)layer);
+    cache.texture.reset();
+    return;
+  }
+  cache.valid = false;
+
+  const int index = static_cast<int>(layer);
+  cachedLayers.insert(
+    std::upper_bound(
+      cachedLayers.begin(),
+      cachedLayers.end(),
+      index,
+      std::greater<int>()
+      ),
+    index
+    );
+  cachedMask.set(index);
+}
+
+void SFMLRenderer::drawLayerCache(const int layer, const AABB2& viewBounds)
+{
+  LayerCache& cache = caches[layer];
+  if (queue.getLayerSize(layer) == 0)
+  {
+    return;
   }
-  else
+  if (!cache.valid || cache.version != queue.getLayerVersion(layer) ||
+      !cache.area.contains(viewBounds))
   {
-    Log::debug(
-      TAG,
-      "Ignoring add of non-renderable entity %u",
-      entity->getID()
-      );
+    renderLayerCache(layer, viewBounds);
   }
+
+  const float targetHeight = static_cast<float>(renderTexture.getSize().y);
+  sf::Sprite sprite(cache.texture->getTexture());
+  sprite.setPosition(
+    cache.area.center.x - cache.area.halfSize.x,
+    targetHeight - (cache.area.center.y + cache.area.halfSize.y)
+    );
+  renderTexture.draw(sprite);
+  drawCalls++;
+}
+
+void SFMLRenderer::renderLayerCache(const int layer, const AABB2& viewBounds)
+{
+  LayerCache& cache = caches[layer];
+  const sf::Vector2u size = cache.texture->getSize();
+  const float targetHeight = static_cast<float>(renderTexture.getSize().y);
+
+  // center the cache on the view, in the same flipped coordinates as the
+  // main render texture so components draw the same way into both
+  cache.area = AABB2(viewBounds.center, (float)size.x, (float)size.y);
+  cache.texture->setView(sf::View(
+    sf::Vector2f(cache.area.center.x, targetHeight - cache.area.center.y),
+    sf::Vector2f((float)size.x, (float)size.y)
+    ));
+  cache.texture->clear(sf::Color::Transparent);
+
+  queue.findInLayer(layer, cache.area, cacheList);
+  buildCommands(cacheList, cacheCommands);
+  submit(cacheCommands, *cache.texture, false);
+  cache.texture->display();
+  cache.version = queue.getLayerVersion(layer);
+  cache.valid = true;
+
+  Log::debug(
+    TAG,
+    "Redrew layer %d cache with %u renderables",
+    layer,
+    static_cast<unsigned>(cacheList.size())
+    );
+}
+
+void SFMLRenderer::applyOptions()
+{
+  batching = GameOptions::getInstance().getInt(RENDER_BATCHING) != 0;
+  Log::debug(TAG, "Batched rendering %s", batching ? "enabled" : "disabled");
+  culling = GameOptions::getInstance().getInt(RENDER_CULLING) != 0;
+  Log::debug(TAG, "View culling %s", culling ? "enabled" : "disabled");
+
+  // starts again from full resolution
+  const int budget =
+    GameOptions::getInstance().getInt(DYNAMIC_RESOLUTION_BUDGET);
+  const int minPercent =
+    GameOptions::getInstance().getInt(DYNAMIC_RESOLUTION_MIN);
+  resolution.initialize(
+    static_cast<float>(std::max(budget, 0)),
+    std::min(std::max(minPercent, 10), 100) / 100.0f
+    );
+  Log::debug(
+    TAG,
+    "Dynamic resolution %s",
+    resolution.isEnabled() ? "enabled" : "disabled"
+    );
+  renderTexture.setSmooth(false);
 }
 
-void SFMLRenderer::entityRemovedCallback(StrongEventPtr evt)
+void SFMLRenderer::captureFrame()
 {
-  auto ere = Event::cast<EntityRemovedEvent>(evt);
-  if (ere == nullptr)
+  if (!capture.wantsFrame(frameCount))
   {
-    Log::error(
-      TAG,
-      "Couldn't cast to EntityRemovedEvent, type %u (%s)",
-      evt->getID(),
-      evt->getNameC()
-      );
     return;
   }
 
-  auto itr = renderables.find(ere->entity);
-  if (itr != renderables.end())
+  if (!asyncReadback)
   {
-    renderables.erase(itr);
+    const sf::Image image = window->capture();
+    capture.submit(image.getPixelsPtr(), false, frameCount);
+    return;
+  }
 
-    // is it cheaper to swap & pop then resort?
-    auto itr2 = std::find_if(
-      sortedRenderables.begin(),
-      sortedRenderables.end(),
-      [&](StrongRenderComponentPtr rc) {
-        return rc->getParentID() == ere->entity;
-      }
-      );
-    assert(itr2 != sortedRenderables.end());
-    sortedRenderables.erase(itr2);
+  // the older of the two reads was started at least two frames ago, so the
+  // GPU is done with it
+  window->setActive(true);
+  if (readback.isFull())
+  {
+    collectReadback();
   }
-  else
+  readback.start(frameCount);
+}
+
+bool SFMLRenderer::collectReadback()
+{
+  uint32_t number;
+  const uint8_t* pixels = readback.map(number);
+  if (pixels == nullptr)
+  {
+    return false;
+  }
+  capture.submit(pixels, true, number);
+  readback.unmap();
+  return true;
+}
+
+void SFMLRenderer::createStatsOverlay()
+{
+  static const char* const labels[StatLineCount] = {
+    "FPS",
+    "Frame avg ms",
+    "Frame p50 ms",
+    "Frame p95 ms",
+    "Frame p99 ms",
+    "Spatial ms",
+    "Particles ms",
+    "Render ms",
+    "Physics ms",
+    "Logic ms",
+    "Events ms",
+    "Entities",
+    "Bodies",
+    "Particles",
+    "Draw calls",
+    "Drawn",
+    "Culled",
+    "Queued events",
+    "Render scale %",
+    "Scale changes",
+#ifdef LAUNCHO_TRACK_ALLOCATIONS
+    "Allocations",
+    "Allocated KB",
+#endif
+  };
+
+  stats.initialize(font, 12, sf::Vector2f(4.0f, 4.0f), sf::Color::Black);
+  for (int i = 0; i < StatLineCount; i++)
   {
-    Log::debug(TAG, "Entity %u not found in renderable list", ere->entity);
+    const std::size_t line = stats.addLine(labels[i], 8);
+    assert(line == static_cast<std::size_t>(i));
+    (void) line;
   }
 }
+
+void SFMLRenderer::drawUI()
+{
+  if (!showStats)
+  {
+    return;
+  }
+
+  Game& game = Game::getInstance();
+  const FrameStats& frame = game.getFrameStats();
+  stats.setValue(FpsLine, game.getFPS(), 1);
+  stats.setValue(FrameAvgLine, frame.getAverage(), 2);
+  stats.setValue(FrameP50Line, frame.getPercentile(50.0f), 2);
+  stats.setValue(FrameP95Line, frame.getPercentile(95.0f), 2);
+  stats.setValue(FrameP99Line, frame.getPercentile(99.0f), 2);
+  stats.setValue(SpatialLine, frame.getSectionTime(FrameSection::Spatial), 2);
+  stats.setValue(
+    ParticlesLine,
+    frame.getSectionTime(FrameSection::Particles),
+    2
+    );
+  stats.setValue(RenderLine, frame.getSectionTime(FrameSection::Render), 2);
+  stats.setValue(PhysicsLine, frame.getSectionTime(FrameSection::Physics), 2);
+  stats.setValue(LogicLine, frame.getSectionTime(FrameSection::Logic), 2);
+  stats.setValue(EventsLine, frame.getSectionTime(FrameSection::Events), 2);
+  stats.setValue(
+    EntitiesLine,
+    static_cast<unsigned>(game.getLogicSystem()->getEntityCount())
+    );
+  stats.setValue(
+    BodiesLine,
+    static_cast<unsigned>(game.getPhysicsSystem()->getBodyCount())
+    );
+  stats.setValue(
+    ParticleCountLine,
+    static_cast<unsigned>(game.getParticleSystem()->getParticleCount())
+    );
+  stats.setValue(DrawCallsLine, drawCalls);
+  stats.setValue(DrawnLine, static_cast<unsigned>(visible.size()));
+  stats.setValue(CulledLine, culledCount);
+  stats.setValue(
+    QueuedEventsLine,
+    static_cast<unsigned>(game.getEventSystem()->getQueuedEventCount())
+    );
+
+  stats.setValue(ResolutionLine, resolution.getScale() * 100.0f, 0);
+  stats.setValue(ResolutionChangesLine, resolution.getChangeCount());
+#ifdef LAUNCHO_TRACK_ALLOCATIONS
+  stats.setValue(AllocationsLine, AllocationTracker::getFrameAllocations());
+  stats.setValue(
+    AllocatedLine,
+    AllocationTracker::getFrameBytes() / 1024.0f,
+    1
+    );
+#endif
+
+  // drawn straight to the window so it stays sharp at any render scale
+  stats.draw(*window);
+}
\ No newline at end of file
@@ -1,12 +1,21 @@
 #pragma once
 
 #include "IRenderSystem.h"
+#include "GameOptions.h"
 #include "types.h"
 #include "components/RenderComponent.h"
+#include "graphics/DynamicResolution.h"
+#include "graphics/FrameCapture.h"
+#include "graphics/PixelReadback.h"
+#include "graphics/RenderCommandBuffer.h"
+#include "graphics/RenderQueue.h"
+#include "graphics/TextPanel.h"
+#include "math/AABB2.h"
 #include "utility/Timer.h"
 #include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 #include <string>
 
@@ -18,17 +27,94 @@ private:
 
   std::shared_ptr<sf::RenderWindow> window;
   sf::View view;
+  // always window sized, at lower resolutions only the upper left part of it
+  // is drawn to and then stretched over the window
   sf::RenderTexture renderTexture;
   Timer timer;
+  DynamicResolution resolution;
+  uint32_t frameCount;
+
+  // frames are read back from the window, through pixel buffers when the
+  // driver has them so the main loop never waits on the GPU
+  FrameCapture capture;
+  PixelReadback readback;
+  bool asyncReadback;
   
-  std::unordered_map<EntityID, StrongRenderComponentPtr> renderables;
-  std::vector<StrongRenderComponentPtr> sortedRenderables;
-  bool needSortUpdate;
+  RenderQueue queue;
+  // only renderables inside the view are drawn
+  bool culling;
+  // what gets drawn this frame, in draw order
+  RenderList visible;
+  // renderables left out of visible that aren't in a cached layer
+  unsigned culledCount;
+  RenderCommandBuffer commands;
+  // time spent building the command buffers this frame, in ms
+  float buildTime;
+
+  // Static layers are drawn into their own texture, covering the view plus a
+  // margin. The texture is only redrawn when something in the layer is added,
+  // removed or moved, or when the view leaves the cached area.
+  struct LayerCache
+  {
+    // null for layers that aren't cached
+    std::unique_ptr<sf::RenderTexture> texture;
+    // world area covered by the texture
+    AABB2 area;
+    // layer version the texture was drawn from
+    uint32_t version;
+    bool valid;
+  };
+
+  bool layerCaching;
+  std::array<LayerCache, RenderQueue::LAYER_COUNT> caches;
+  // layers with a cache, farthest first, and the same as a mask so they can
+  // be left out of the visible list
+  std::vector<int> cachedLayers;
+  RenderQueue::LayerMask cachedMask;
+  RenderList cacheList;
+  RenderCommandBuffer cacheCommands;
+
+  // consecutive quads with the same texture are drawn with a single call
+  bool batching;
+  unsigned drawCalls;
 
   sf::Font font;
 
-  EventCallbackID addedCallbackID;
-  EventCallbackID removedCallbackID;
+  // lines of the performance overlay, in the order they are shown
+  enum StatLine
+  {
+    FpsLine,
+    FrameAvgLine,
+    FrameP50Line,
+    FrameP95Line,
+    FrameP99Line,
+    SpatialLine,
+    ParticlesLine,
+    RenderLine,
+    PhysicsLine,
+    LogicLine,
+    EventsLine,
+    EntitiesLine,
+    BodiesLine,
+    ParticleCountLine,
+    DrawCallsLine,
+    DrawnLine,
+    CulledLine,
+    QueuedEventsLine,
+    ResolutionLine,
+    ResolutionChangesLine,
+#ifdef LAUNCHO_TRACK_ALLOCATIONS
+    AllocationsLine,
+    AllocatedLine,
+#endif
+    StatLineCount
+  };
+
+  bool showStats;
+  TextPanel stats;
+
+  // settings that are applied again when they are reloaded
+  std::vector<OptionCallbackID> optionCallbacks;
 
 public:
   SFMLRenderer() = delete;
@@ -40,10 +126,36 @@ public:
   virtual void destroy();
 
 private:
-  void sortRenderables();
-  void drawUI();
+  // area covered by the view in world coordinates
+  AABB2 getViewBounds() const;
+  // size of the part of the render texture being drawn to
+  sf::Vector2u getScaledSize() const;
+  // builds the command buffer for a list of renderables on the workers
+  void buildCommands(const RenderList& components,
+                     RenderCommandBuffer& buffer);
+  /**
+   * Issues the draw calls for a command buffer.
+   * @param useCaches Composite the cached layers, which the buffer leaves
+   * out, in between the commands of the other layers.
+   */
+  void submit(const RenderCommandBuffer& buffer, sf::RenderTarget& target,
+              const bool useCaches);
+  // draws a run of consecutive quads that share a texture
+  void drawRun(const RenderCommandBuffer& buffer, sf::RenderTarget& target,
+               const std::size_t start, const std::size_t count);
 
-  // callbacks
-  void entityAddedCallback(StrongEventPtr evt);
-  void entityRemovedCallback(StrongEventPtr evt);
+  // layer caching
+  void createLayerCache(const RenderLayer layer, const unsigned width,
+                        const unsigned height);
+  // draws the cached texture of a layer, redrawing it first if needed
+  void drawLayerCache(const int layer, const AABB2& viewBounds);
+  void renderLayerCache(const int layer, const AABB2& viewBounds);
+  // reads the window back for the frame capture if this frame is captured
+  void captureFrame();
+  // hands the oldest finished readback to the capture
+  bool collectReadback();
+  // reads the settings that can change while running
+  void applyOptions();
+  void createStatsOverlay();
+  void drawUI();
 };
\ No newline at end of file
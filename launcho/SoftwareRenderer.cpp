@@ -0,0 +1,254 @@
+#include "SoftwareRenderer.h"
+#include "options.h"
+#include "GameOptions.h"
+#include "Game.h"
+#include "utility/AllocationTracker.h"
+#include "utility/Log.h"
+#include <algorithm>
+#include <cstdio>
+
+const std::string SoftwareRenderer::TAG = "SoftwareRenderer";
+
+SoftwareRenderer::SoftwareRenderer()
+: framebuffer(0, 0),
+  viewBounds(),
+  view(),
+  offset(),
+  timer(),
+  queue(),
+  culling(true),
+  visible(),
+  commands(),
+  lastTexture(nullptr),
+  lastImage(nullptr),
+  frameCount(0),
+  quadCount(0),
+  customCount(0),
+  skippedCount(0),
+  totalCustom(0),
+  totalSkipped(0),
+  dumpPrefix(),
+  dumpInterval(1),
+  dumpPNG(false),
+  capture()
+{
+}
+
+void SoftwareRenderer::initialize()
+{
+  int width = GameOptions::getInstance().getInt(SCREEN_WIDTH);
+  int height = GameOptions::getInstance().getInt(SCREEN_HEIGHT);
+  framebuffer = Framebuffer(width, height);
+  Log::debug(TAG, "Framebuffer created, %dx%d", width, height);
+
+  // same view as SFMLRenderer
+  viewBounds = AABB2(width / 2.0f, height / 2.0f, (float)width, (float)height);
+  // target coordinates have y flipped
+  const float targetHeight = static_cast<float>(height);
+  view.setCenter(viewBounds.center.x, targetHeight - viewBounds.center.y);
+  view.setSize(viewBounds.halfSize.x * 2.0f, viewBounds.halfSize.y * 2.0f);
+  offset = sf::Vector2f(
+    viewBounds.center.x - viewBounds.halfSize.x,
+    targetHeight - (viewBounds.center.y + viewBounds.halfSize.y)
+    );
+
+  culling = GameOptions::getInstance().getInt(RENDER_CULLING) != 0;
+  Log::debug(TAG, "View culling %s", culling ? "enabled" : "disabled");
+
+  dumpPrefix = GameOptions::getInstance().getString(RENDER_DUMP_PREFIX);
+  dumpInterval = static_cast<uint32_t>(
+    std::max(1, GameOptions::getInstance().getInt(RENDER_DUMP_INTERVAL))
+    );
+  dumpPNG = GameOptions::getInstance().getString(RENDER_DUMP_FORMAT) == "png";
+  if (!dumpPrefix.empty())
+  {
+    Log::debug(
+      TAG,
+      "Dumping every %u frames to %s*.%s",
+      dumpInterval,
+      dumpPrefix.c_str(),
+      dumpPNG ? "png" : "ppm"
+      );
+  }
+
+  capture.initialize(
+    width,
+    height,
+    GameOptions::getInstance().getString(CAPTURE_PREFIX),
+    GameOptions::getInstance().getString(CAPTURE_FORMAT),
+    static_cast<uint32_t>(GameOptions::getInstance().getInt(CAPTURE_INTERVAL)),
+    static_cast<unsigned>(GameOptions::getInstance().getInt(CAPTURE_BUFFERS))
+    );
+
+  queue.initialize();
+}
+
+void SoftwareRenderer::update(const float)
+{
+  AllocationScope allocations(AllocationTag::Render);
+  timer.start();
+
+  framebuffer.clear(sf::Color::White);
+  queue.update();
+  // nothing is cached, every layer is drawn
+  queue.findVisible(viewBounds, culling, RenderQueue::LayerMask(), visible);
+  drawRenderables();
+
+  Log::verbose(
+    TAG,
+    "Rendering complete in %.2fms, %u quads, %u custom, %u skipped, "
+    "%u culled",
+    timer.elapsedMilliF(),
+    quadCount,
+    customCount,
+    skippedCount,
+    static_cast<unsigned>(queue.size() - visible.size())
+    );
+
+  if (!dumpPrefix.empty() && (frameCount % dumpInterval) == 0)
+  {
+    dumpFrame();
+  }
+  if (capture.wantsFrame(frameCount))
+  {
+    capture.submit(
+      reinterpret_cast<const uint8_t*>(framebuffer.getPixels()),
+      false,
+      frameCount
+      );
+  }
+  frameCount++;
+}
+
+void SoftwareRenderer::destroy()
+{
+  Log::info(
+    TAG,
+    "Drew %llu custom components, %llu draws skipped",
+    static_cast<unsigned long long>(totalCustom),
+    static_cast<unsigned long long>(totalSkipped)
+    );
+  queue.destroy();
+  capture.destroy();
+}
+
+const Framebuffer& SoftwareRenderer::getFramebuffer() const
+{
+  return framebuffer;
+}
+
+void SoftwareRenderer::drawRenderables()
+{
+  quadCount = 0;
+  customCount = 0;
+  skippedCount = 0;
+  lastTexture = nullptr;
+  lastImage = nullptr;
+  const float targetHeight = static_cast<float>(framebuffer.getHeight());
+  commands.build(visible, targetHeight, *Game::getInstance().getWorkerPool());
+
+  for (std::size_t i = 0; i < commands.size(); i++)
+  {
+    const RenderCommand& command = commands.getCommand(i);
+    // drawn in order with the other commands, like SFMLRenderer does
+    if (command.custom)
+    {
+      if (command.component->drawQuads(*this))
+      {
+        customCount++;
+      }
+      else
+      {
+        skippedCount++;
+      }
+      continue;
+    }
+
+    const sf::Image* image = findImage(command.texture);
+    if (command.texture != nullptr && image == nullptr)
+    {
+      skippedCount++;
+      continue;
+    }
+
+    sf::Vertex quad[4];
+    const sf::Vertex* source = commands.getQuad(i);
+    for (int j = 0; j < 4; j++)
+    {
+      quad[j] = source[j];
+      quad[j].position -= offset;
+    }
+    framebuffer.drawQuad(quad, image);
+    quadCount++;
+  }
+  totalCustom += customCount;
+  totalSkipped += skippedCount;
+}
+
+void SoftwareRenderer::dumpFrame()
+{
+  char filename[256];
+  snprintf(
+    filename,
+    sizeof(filename),
+    "%s%06u.%s",
+    dumpPrefix.c_str(),
+    frameCount,
+    dumpPNG ? "png" : "ppm"
+    );
+
+  const bool saved = dumpPNG ? framebuffer.savePNG(filename) :
+                               framebuffer.savePPM(filename);
+  if (!saved)
+  {
+    Log::error(TAG, "Could not write %s", filename);
+  }
+}
+
+sf::Vector2u SoftwareRenderer::getSize() const
+{
+  return sf::Vector2u(framebuffer.getWidth(), framebuffer.getHeight());
+}
+
+const sf::View& SoftwareRenderer::getView() const
+{
+  return view;
+}
+
+void SoftwareRenderer::drawQuads(const sf::Vertex* vertices,
+                                 const std::size_t count,
+                                 const sf::RenderStates& states)
+{
+  const sf::Image* image = findImage(states.texture);
+  if (states.texture != nullptr && image == nullptr)
+  {
+    skippedCount++;
+    return;
+  }
+
+  sf::Vertex quad[4];
+  for (std::size_t i = 0; i + 4 <= count; i += 4)
+  {
+    for (int j = 0; j < 4; j++)
+    {
+      quad[j] = vertices[i + j];
+      quad[j].position =
+        states.transform.transformPoint(quad[j].position) - offset;
+    }
+    framebuffer.drawQuad(quad, image);
+    quadCount++;
+  }
+}
+
+const sf::Image* SoftwareRenderer::findImage(const sf::Texture* texture)
+{
+  // textures are sampled from the atlas copy in memory, and commands using
+  // the same one are usually next to each other
+  if (texture != lastTexture)
+  {
+    lastTexture = texture;
+    lastImage = texture != nullptr ?
+      Game::getInstance().getTextureAtlas()->getPageImage(texture) : nullptr;
+  }
+  return lastImage;
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "IRenderSystem.h"
+#include "components/RenderComponent.h"
+#include "graphics/FrameCapture.h"
+#include "graphics/Framebuffer.h"
+#include "graphics/QuadTarget.h"
+#include "graphics/RenderCommandBuffer.h"
+#include "graphics/RenderQueue.h"
+#include "math/AABB2.h"
+#include "utility/Timer.h"
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Render system that rasterizes on the CPU into a framebuffer in memory, so
+ * rendering can be measured on machines without a GPU or a display. It draws
+ * from the same RenderQueue and command buffers as SFMLRenderer, so it
+ * exercises the same pipeline. Custom drawn components are drawn through
+ * their QuadTarget path, and the ones without one are skipped and counted.
+ * Frames can be dumped to PPM or PNG files to check the output, or recorded
+ * with a FrameCapture.
+ */
+class SoftwareRenderer
+  : public IRenderSystem,
+    private QuadTarget
+{
+private:
+  static const std::string TAG;
+
+  Framebuffer framebuffer;
+  // world area drawn into the framebuffer
+  AABB2 viewBounds;
+  // the same view in target coordinates, for custom drawn components
+  sf::View view;
+  // moves target coordinates so the view's upper left is the first pixel
+  sf::Vector2f offset;
+  Timer timer;
+
+  RenderQueue queue;
+  bool culling;
+  RenderList visible;
+
+  RenderCommandBuffer commands;
+  // the last texture looked up in the atlas
+  const sf::Texture* lastTexture;
+  const sf::Image* lastImage;
+  uint32_t frameCount;
+  unsigned quadCount;
+  unsigned customCount;
+  unsigned skippedCount;
+  // over the whole run, so a benchmark can tell what it didn't measure
+  uint64_t totalCustom;
+  uint64_t totalSkipped;
+
+  // empty when frames aren't dumped
+  std::string dumpPrefix;
+  // dump every nth frame
+  uint32_t dumpInterval;
+  bool dumpPNG;
+
+  FrameCapture capture;
+
+public:
+  SoftwareRenderer();
+
+  virtual void initialize();
+  virtual void update(const float deltaMs);
+  virtual void destroy();
+
+  const Framebuffer& getFramebuffer() const;
+
+private:
+  void drawRenderables();
+  void dumpFrame();
+
+  // QuadTarget
+  sf::Vector2u getSize() const override;
+  const sf::View& getView() const override;
+  void drawQuads(const sf::Vertex* vertices, const std::size_t count,
+                 const sf::RenderStates& states) override;
+  // the atlas page a texture was copied to, nullptr if it isn't in the atlas
+  const sf::Image* findImage(const sf::Texture* texture);
+};
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "SpatialSystem.h"
+#include "spatial/LooseQuadtree.h"
+#include "spatial/HashGrid.h"
+#include "Game.h"
+#include "Entity.h"
+#include "GameOptions.h"
+#include "options.h"
+#include "events/EntityEvents.h"
+#include "utility/AllocationTracker.h"
+#include "utility/Log.h"
+#include <cassert>
+
+const std::string SpatialSystem::TAG = "SpatialSystem";
+
+// quadtree covers [-32768, 32768] on both axes, smallest nodes are 64 units
+static const float WORLD_HALF_SIZE = 32768.0f;
+static const int QUADTREE_DEPTH = 10;
+static const float GRID_CELL_SIZE = 64.0f;
+
+SpatialSystem::SpatialSystem()
+: index(),
+  tracked(),
+  moved(),
+  lastMoved(),
+  addedCallbackID(0),
+  removedCallbackID(0)
+{
+}
+
+void SpatialSystem::initialize()
+{
+  const std::string type = GameOptions::getInstance().getString(SPATIAL_INDEX);
+  if (type == "grid")
+  {
+    index = std::shared_ptr<ISpatialIndex>(new HashGrid(GRID_CELL_SIZE));
+  }
+  else
+  {
+    if (type != "quadtree")
+    {
+      Log::warning(TAG, "Unknown spatial index '%s'", type.c_str());
+    }
+    index = std::shared_ptr<ISpatialIndex>(
+      new LooseQuadtree(Vector2::ZERO, WORLD_HALF_SIZE, QUADTREE_DEPTH)
+      );
+  }
+  Log::debug(TAG, "Using %s", index->getNameC());
+
+  // event registration
+  auto evtMgr = Game::getInstance().getEventSystem();
+  addedCallbackID = evtMgr->generateNextCallbackID();
+  evtMgr->addListener(
+    EntityAddedEvent::ID,
+    addedCallbackID,
+    EventCallback::bind<SpatialSystem, &SpatialSystem::entityAddedCallback>(
+      this
+      )
+    );
+  removedCallbackID = evtMgr->generateNextCallbackID();
+  evtMgr->addListener(
+    EntityRemovedEvent::ID,
+    removedCallbackID,
+    EventCallback::bind<SpatialSystem, &SpatialSystem::entityRemovedCallback>(
+      this
+      )
+    );
+}
+
+void SpatialSystem::update()
+{
+  AllocationScope allocations(AllocationTag::Spatial);
+  for (EntityID id : moved)
+  {
+    // entities that moved before they were added are inserted at their
+    // current position by the add callback
+    auto itr = tracked.find(id);
+    if (itr != tracked.end())
+    {
+      itr->second->clearMoved();
+      index->update(id, itr->second->getWorldBounds());
+    }
+  }
+
+  Log::verbose(
+    TAG,
+    "Updated %u moved entities",
+    static_cast<unsigned>(moved.size())
+    );
+  lastMoved.swap(moved);
+  moved.clear();
+}
+
+void SpatialSystem::destroy()
+{
+  auto evtMgr = Game::getInstance().getEventSystem();
+  evtMgr->removeListener(EntityAddedEvent::ID, addedCallbackID);
+  evtMgr->removeListener(EntityRemovedEvent::ID, removedCallbackID);
+
+  tracked.clear();
+  moved.clear();
+  lastMoved.clear();
+  index = std::shared_ptr<ISpatialIndex>();
+}
+
+void SpatialSystem::entityMoved(const EntityID id)
+{
+  moved.push_back(id);
+}
+
+void SpatialSystem::query(const AABB2& area,
+                          std::vector<EntityID>& results) const
+{
+  index->query(area, results);
+}
+
+void SpatialSystem::queryNearest(const Vector2& point, const std::size_t k,
+                                 std::vector<EntityID>& results) const
+{
+  index->queryNearest(point, k, results);
+}
+
+const std::vector<EntityID>& SpatialSystem::getLastMoved() const
+{
+  return lastMoved;
+}
+
+std::size_t SpatialSystem::size() const
+{
+  return index->size();
+}
+
+void SpatialSystem::entityAddedCallback(const Event& evt)
+{
+  auto eae = Event::cast<EntityAddedEvent>(evt);
+  if (eae == nullptr)
+  {
+    Log::error(
+      TAG,
+      "Couldn't cast to EntityAddedEvent, type %u (%s)",
+      evt.getID(),
+      evt.getNameC()
+      );
+    return;
+  }
+
+  auto entity =
+    Game::getInstance().getLogicSystem()->getEntity(eae->entity).lock();
+  assert(entity != nullptr);
+
+  auto tc = entity->getComponent<TransformComponent>().lock();
+  if (tc == nullptr)
+  {
+    return;
+  }
+
+  if (tracked.find(entity->getID()) != tracked.end())
+  {
+    Log::error(TAG, "Tried to add duplicate entity %u", entity->getID());
+    return;
+  }
+
+  tracked[entity->getID()] = tc;
+  tc->clearMoved();
+  index->insert(entity->getID(), tc->getWorldBounds());
+}
+
+void SpatialSystem::entityRemovedCallback(const Event& evt)
+{
+  auto ere = Event::cast<EntityRemovedEvent>(evt);
+  if (ere == nullptr)
+  {
+    Log::error(
+      TAG,
+      "Couldn't cast to EntityRemovedEvent, type %u (%s)",
+      evt.getID(),
+      evt.getNameC()
+      );
+    return;
+  }
+
+  auto itr = tracked.find(ere->entity);
+  if (itr != tracked.end())
+  {
+    tracked.erase(itr);
+    index->remove(ere->entity);
+  }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "types.h"
+#include "spatial/ISpatialIndex.h"
+#include "components/TransformComponent.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Keeps a spatial index of every entity with a TransformComponent so that
+ * rendering, AI and gameplay can find nearby entities without scanning the
+ * whole world. Transforms report their own moves, and the index is brought up
+ * to date once per frame in update().
+ */
+class SpatialSystem
+{
+private:
+  static const std::string TAG;
+
+  std::shared_ptr<ISpatialIndex> index;
+  std::unordered_map<EntityID, StrongTransformComponentPtr> tracked;
+  // entities that moved since the last update
+  std::vector<EntityID> moved;
+  // entities that were applied by the last update
+  std::vector<EntityID> lastMoved;
+
+  EventCallbackID addedCallbackID;
+  EventCallbackID removedCallbackID;
+
+public:
+  SpatialSystem();
+
+  void initialize();
+
+  /**
+   * Applies all moves reported since the last update to the index.
+   */
+  void update();
+  void destroy();
+
+  /**
+   * Called by TransformComponent the first time it changes after an update.
+   */
+  void entityMoved(const EntityID id);
+
+  /**
+   * Finds the entities whose bounds intersect an area. See ISpatialIndex.
+   */
+  void query(const AABB2& area, std::vector<EntityID>& results) const;
+
+  /**
+   * Finds the k entities closest to a point. See ISpatialIndex.
+   */
+  void queryNearest(const Vector2& point, const std::size_t k,
+                    std::vector<EntityID>& results) const;
+
+  /**
+   * Returns the entities whose moves were applied by the last update, valid
+   * until the next update. Lets systems react to moves without tracking
+   * transforms themselves.
+   */
+  const std::vector<EntityID>& getLastMoved() const;
+
+  // number of entities being tracked
+  std::size_t size() const;
+
+private:
+  // callbacks
+  void entityAddedCallback(const Event& evt);
+  void entityRemovedCallback(const Event& evt);
+};
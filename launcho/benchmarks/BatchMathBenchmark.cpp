@@ -0,0 +1,140 @@
+#include "benchmarks/Benchmark.h"
+#include "math/BatchMath.h"
+#include <random>
+#include <vector>
+
+static const std::size_t COUNT = 100000;
+static const int ITERATIONS = 200;
+static const SimdPath PATHS[] = { SimdPath::Scalar, SimdPath::Sse2,
+                                  SimdPath::Avx2 };
+
+// keeps the compiler from throwing away benchmark results
+static volatile std::size_t sink;
+
+void Benchmark::batchMath()
+{
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> position(0.0f, 10000.0f);
+  std::uniform_real_distribution<float> size(1.0f, 50.0f);
+
+  // same data in array of structs form for the scalar Vector2/AABB2 methods
+  std::vector<AABB2> boxes;
+  std::vector<Vector2> points;
+  AABB2Array boxArray;
+  Vector2Array pointArray;
+  for (std::size_t i = 0; i < COUNT; i++)
+  {
+    AABB2 box(position(rng), position(rng), size(rng), size(rng));
+    Vector2 pt(position(rng), position(rng));
+    boxes.push_back(box);
+    points.push_back(pt);
+    boxArray.push_back(box);
+    pointArray.push_back(pt);
+  }
+
+  const AABB2 query(5000.0f, 5000.0f, 1000.0f, 1000.0f);
+  const Transform2 transform = Transform2::make(Vector2(10.0f, 20.0f), 30.0f);
+  std::vector<uint32_t> indices;
+  indices.reserve(COUNT);
+  Vector2Array transformed;
+  std::vector<Vector2> transformedAos(COUNT);
+  const SimdPath best = BatchMath::getPath();
+
+  float baseline = measure("AABB2::intersect 1 vs N", ITERATIONS, [&] {
+    indices.clear();
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+      if (query.intersect(boxes[i]))
+      {
+        indices.push_back(static_cast<uint32_t>(i));
+      }
+    }
+    sink = indices.size();
+  });
+  for (SimdPath path : PATHS)
+  {
+    if (BatchMath::setPath(path) != path)
+    {
+      continue;
+    }
+    std::string name =
+      std::string("BatchMath::intersect 1 vs N ") + BatchMath::getPathName(path);
+    float t = measure(name, ITERATIONS, [&] {
+      sink = BatchMath::intersect(query, boxArray, indices);
+    });
+    logSpeedup(name, baseline, t);
+  }
+
+  baseline = measure("AABB2::contains 1 vs N", ITERATIONS, [&] {
+    indices.clear();
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+      if (query.contains(points[i]))
+      {
+        indices.push_back(static_cast<uint32_t>(i));
+      }
+    }
+    sink = indices.size();
+  });
+  for (SimdPath path : PATHS)
+  {
+    if (BatchMath::setPath(path) != path)
+    {
+      continue;
+    }
+    std::string name =
+      std::string("BatchMath::contains 1 vs N ") + BatchMath::getPathName(path);
+    float t = measure(name, ITERATIONS, [&] {
+      sink = BatchMath::contains(query, pointArray, indices);
+    });
+    logSpeedup(name, baseline, t);
+  }
+
+  baseline = measure("Transform2::transformPoint", ITERATIONS, [&] {
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+      transformedAos[i] = transform.transformPoint(points[i]);
+    }
+    sink = static_cast<std::size_t>(transformedAos[COUNT / 2].x);
+  });
+  for (SimdPath path : PATHS)
+  {
+    if (BatchMath::setPath(path) != path)
+    {
+      continue;
+    }
+    std::string name =
+      std::string("BatchMath::transformPoints ") + BatchMath::getPathName(path);
+    float t = measure(name, ITERATIONS, [&] {
+      BatchMath::transformPoints(transform, pointArray, transformed);
+      sink = static_cast<std::size_t>(transformed.x[COUNT / 2]);
+    });
+    logSpeedup(name, baseline, t);
+  }
+
+  baseline = measure("Vector2::normalize", ITERATIONS, [&] {
+    transformedAos = points;
+    for (Vector2& v : transformedAos)
+    {
+      v.normalize();
+    }
+    sink = static_cast<std::size_t>(transformedAos[COUNT / 2].x * 1000.0f);
+  });
+  for (SimdPath path : PATHS)
+  {
+    if (BatchMath::setPath(path) != path)
+    {
+      continue;
+    }
+    std::string name =
+      std::string("BatchMath::normalize ") + BatchMath::getPathName(path);
+    float t = measure(name, ITERATIONS, [&] {
+      transformed = pointArray;
+      BatchMath::normalize(transformed);
+      sink = static_cast<std::size_t>(transformed.x[COUNT / 2] * 1000.0f);
+    });
+    logSpeedup(name, baseline, t);
+  }
+
+  BatchMath::setPath(best);
+}
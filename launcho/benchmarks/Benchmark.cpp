@@ -0,0 +1,22 @@
+#include "benchmarks/Benchmark.h"
+
+const std::string Benchmark::TAG = "Benchmark";
+
+void Benchmark::runAll()
+{
+  Log::info(TAG, "Running benchmarks");
+  batchMath();
+  spatialIndex();
+  fixedPoint();
+  softwareRender();
+  particles();
+  tileMap();
+  delegates();
+  Log::info(TAG, "Benchmarks complete");
+}
+
+void Benchmark::logSpeedup(const std::string& name, const float baselineUs,
+                           const float optimizedUs)
+{
+  Log::info(TAG, "%-40s %10.2fx", name.c_str(), baselineUs / optimizedUs);
+}
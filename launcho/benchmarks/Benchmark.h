@@ -0,0 +1,70 @@
+#pragma once
+
+#include "utility/Timer.h"
+#include "utility/Log.h"
+#include <string>
+
+/**
+ * Micro benchmarks for engine code. When the game is built with
+ * LAUNCHO_BENCHMARK defined, main() runs these instead of the game and writes
+ * the results to the log.
+ */
+class Benchmark final
+{
+private:
+  static const std::string TAG;
+
+public:
+  Benchmark() = delete;
+
+  /**
+   * Runs every benchmark suite.
+   */
+  static void runAll();
+
+  /**
+   * Times a function over a number of iterations and logs the average.
+   * @param name Printed with the result.
+   * @param iterations How many times to call fn.
+   * @param fn The code to time.
+   * @return Average time per iteration in microseconds.
+   */
+  template<typename Fn>
+  static float measure(const std::string& name, const int iterations, Fn fn);
+
+  /**
+   * Logs how much faster the optimized version ran.
+   */
+  static void logSpeedup(const std::string& name, const float baselineUs,
+                         const float optimizedUs);
+
+  // Individual suites, each is implemented in its own file.
+  static void batchMath();
+  static void spatialIndex();
+  static void fixedPoint();
+  static void softwareRender();
+  static void particles();
+  static void tileMap();
+  static void delegates();
+};
+
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+
+template<typename Fn>
+float Benchmark::measure(const std::string& name, const int iterations, Fn fn)
+{
+  // warm up caches and branch predictors
+  fn();
+
+  Timer timer(true);
+  for (int i = 0; i < iterations; i++)
+  {
+    fn();
+  }
+  const float avgUs = timer.elapsedMicro() / static_cast<float>(iterations);
+
+  Log::info(TAG, "%-40s %10.2fus", name.c_str(), avgUs);
+  return avgUs;
+}
@@ -0,0 +1,77 @@
+#include "benchmarks/Benchmark.h"
+#include "events/EntityEvents.h"
+#include "utility/Delegate.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+static const std::size_t LISTENERS = 8;
+static const std::size_t DISPATCHES = 100000;
+static const int ITERATIONS = 20;
+
+// keeps the compiler from throwing away benchmark results
+static volatile EntityID sink;
+
+// stands in for a system with an event callback
+struct DelegateListener
+{
+  EntityID total;
+
+  void onEvent(const Event& evt)
+  {
+    total += Event::cast<EntityAddedEvent>(evt)->entity;
+  }
+};
+
+void Benchmark::delegates()
+{
+  std::vector<DelegateListener> listeners(LISTENERS);
+  const StrongEventPtr evt(new EntityAddedEvent(1));
+
+  // how events were dispatched before: bound std::functions taking the
+  // shared_ptr by value, copied out of the listener map for each call
+  std::vector<std::function<void(StrongEventPtr)>> functions;
+  for (auto& listener : listeners)
+  {
+    DelegateListener* target = &listener;
+    functions.push_back(
+      std::bind(
+        [](DelegateListener* l, StrongEventPtr e) { l->onEvent(*e); },
+        target,
+        std::placeholders::_1
+        )
+      );
+  }
+  float baseline = measure("std::function, shared_ptr by value", ITERATIONS,
+    [&] {
+      for (std::size_t i = 0; i < DISPATCHES; i++)
+      {
+        for (auto listener : functions)
+        {
+          listener(evt);
+        }
+      }
+      sink = listeners[0].total;
+    });
+
+  std::vector<EventCallback> delegates;
+  for (auto& listener : listeners)
+  {
+    delegates.push_back(
+      EventCallback::bind<DelegateListener, &DelegateListener::onEvent>(
+        &listener
+        )
+      );
+  }
+  float optimized = measure("Delegate, event by reference", ITERATIONS, [&] {
+    for (std::size_t i = 0; i < DISPATCHES; i++)
+    {
+      for (const auto& listener : delegates)
+      {
+        listener(*evt);
+      }
+    }
+    sink = listeners[0].total;
+  });
+  logSpeedup("Event dispatch", baseline, optimized);
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "benchmarks/Benchmark.h"
+#include "math/FixedAABB2.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+static const std::size_t COUNT = 100000;
+static const int ITERATIONS = 100;
+
+// keeps the compiler from throwing away benchmark results
+static volatile float sinkFloat;
+static volatile int64_t sinkRaw;
+
+// Times the scalar operations and collision checks of one fixed point type.
+// The values are small enough that each operation fits in Q16.16, but the
+// sums wrap. They only stop the optimizer from removing the loops, so the
+// wrapping is intended.
+template<typename T>
+static void benchmarkFixed(const std::string& typeName,
+                           const std::vector<AABB2>& boxes,
+                           const std::vector<Vector2>& points,
+                           const float floatMul, const float floatDiv,
+                           const float floatSqrt, const float floatIntersect)
+{
+  std::vector<T> a;
+  std::vector<T> b;
+  std::vector<FixedAABB2<T>> fixedBoxes;
+  for (std::size_t i = 0; i < COUNT; i++)
+  {
+    a.push_back(T::fromFloat(points[i].x));
+    b.push_back(T::fromFloat(points[i].y));
+    fixedBoxes.push_back(FixedAABB2<T>::fromAABB2(boxes[i]));
+  }
+  const FixedAABB2<T> query = FixedAABB2<T>::fromAABB2(boxes[0]);
+
+  float t = Benchmark::measure(typeName + " multiply", ITERATIONS, [&] {
+    T sum;
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+      sum += a[i] * b[i];
+    }
+    sinkRaw = sum.raw();
+  });
+  Benchmark::logSpeedup(typeName + " multiply", floatMul, t);
+
+  t = Benchmark::measure(typeName + " divide", ITERATIONS, [&] {
+    T sum;
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+      sum += a[i] / b[i];
+    }
+    sinkRaw = sum.raw();
+  });
+  Benchmark::logSpeedup(typeName + " divide", floatDiv, t);
+
+  t = Benchmark::measure(typeName + " sqrt", ITERATIONS, [&] {
+    T sum;
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+      sum += a[i].sqrt();
+    }
+    sinkRaw = sum.raw();
+  });
+  Benchmark::logSpeedup(typeName + " sqrt", floatSqrt, t);
+
+  t = Benchmark::measure(typeName + " AABB intersect", ITERATIONS, [&] {
+    int64_t hits = 0;
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+      hits += query.intersect(fixedBoxes[i]) ? 1 : 0;
+    }
+    sinkRaw = hits;
+  });
+  Benchmark::logSpeedup(typeName + " AABB intersect", floatIntersect, t);
+}
+
+void Benchmark::fixedPoint()
+{
+  std::mt19937 rng(2468);
+  std::uniform_real_distribution<float> value(1.0f, 100.0f);
+  std::uniform_real_distribution<float> size(1.0f, 10.0f);
+
+  std::vector<AABB2> boxes;
+  std::vector<Vector2> points;
+  for (std::size_t i = 0; i < COUNT; i++)
+  {
+    boxes.push_back(AABB2(value(rng), value(rng), size(rng), size(rng)));
+    points.push_back(Vector2(value(rng), value(rng)));
+  }
+
+  const float floatMul = measure("float multiply", ITERATIONS, [&] {
+    float sum = 0.0f;
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+      sum += points[i].x * points[i].y;
+    }
+    sinkFloat = sum;
+  });
+
+  const float floatDiv = measure("float divide", ITERATIONS, [&] {
+    float sum = 0.0f;
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+      sum += points[i].x / points[i].y;
+    }
+    sinkFloat = sum;
+  });
+
+  const float floatSqrt = measure("float sqrt", ITERATIONS, [&] {
+    float sum = 0.0f;
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+      sum += std::sqrt(points[i].x);
+    }
+    sinkFloat = sum;
+  });
+
+  const float floatIntersect = measure("float AABB intersect", ITERATIONS, [&] {
+    int64_t hits = 0;
+    for (std::size_t i = 0; i < COUNT; i++)
+    {
+      hits += boxes[0].intersect(boxes[i]) ? 1 : 0;
+    }
+    sinkRaw = hits;
+  });
+
+  benchmarkFixed<Fixed16>("Fixed16", boxes, points, floatMul, floatDiv,
+                          floatSqrt, floatIntersect);
+  benchmarkFixed<Fixed32>("Fixed32", boxes, points, floatMul, floatDiv,
+                          floatSqrt, floatIntersect);
+}
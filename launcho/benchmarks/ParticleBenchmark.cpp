@@ -0,0 +1,83 @@
+#include "benchmarks/Benchmark.h"
+#include "graphics/ParticlePool.h"
+#include "math/BatchMath.h"
+#include <random>
+#include <vector>
+
+static const std::size_t COUNT = 100000;
+static const int ITERATIONS = 200;
+static const float DT = 1.0f / 60.0f;
+static const SimdPath PATHS[] = { SimdPath::Scalar, SimdPath::Sse2,
+                                  SimdPath::Avx2 };
+
+// keeps the compiler from throwing away benchmark results
+static volatile float sink;
+
+// fills the pool back up, like an emitter with a steady rate would
+static void refill(ParticlePool& pool, std::mt19937& rng)
+{
+  std::uniform_real_distribution<float> velocity(-100.0f, 100.0f);
+  std::uniform_real_distribution<float> lifetime(0.5f, 5.0f);
+  while (!pool.full())
+  {
+    pool.add(
+      Vector2(400.0f, 300.0f),
+      Vector2(velocity(rng), velocity(rng)),
+      lifetime(rng)
+      );
+  }
+}
+
+void Benchmark::particles()
+{
+  const SimdPath best = BatchMath::getPath();
+  const Vector2 gravity(0.0f, -10.0f);
+  ParticleLook look;
+  look.startSize = 2.0f;
+  look.endSize = 6.0f;
+  look.startColor = sf::Color(255, 200, 0, 255);
+  look.endColor = sf::Color(255, 0, 0, 0);
+  std::vector<sf::Vertex> vertices(COUNT * 4);
+
+  float baseline = 0.0f;
+  for (SimdPath path : PATHS)
+  {
+    if (BatchMath::setPath(path) != path)
+    {
+      continue;
+    }
+
+    std::mt19937 rng(1234);
+    ParticlePool pool(COUNT);
+    refill(pool, rng);
+
+    // the respawns are part of a steady state frame, they cost the same on
+    // every path
+    std::string name =
+      std::string("ParticlePool::update 100k ") + BatchMath::getPathName(path);
+    const float t = measure(name, ITERATIONS, [&] {
+      pool.update(DT, gravity);
+      refill(pool, rng);
+      sink = pool.x[COUNT / 2];
+    });
+    if (path == SimdPath::Scalar)
+    {
+      baseline = t;
+    }
+    else
+    {
+      logSpeedup(name, baseline, t);
+    }
+  }
+
+  std::mt19937 rng(1234);
+  ParticlePool pool(COUNT);
+  refill(pool, rng);
+  pool.update(DT, gravity);
+  measure("ParticlePool::writeQuads 100k", ITERATIONS, [&] {
+    pool.writeQuads(&vertices[0], look);
+    sink = vertices[COUNT].position.x;
+  });
+
+  BatchMath::setPath(best);
+}
\ No newline at end of file
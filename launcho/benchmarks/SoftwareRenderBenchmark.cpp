@@ -0,0 +1,116 @@
+#include "benchmarks/Benchmark.h"
+#include "graphics/Framebuffer.h"
+#include "math/BatchMath.h"
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static const unsigned WIDTH = 800;
+static const unsigned HEIGHT = 600;
+static const std::size_t QUAD_COUNT = 5000;
+static const int ITERATIONS = 50;
+static const SimdPath PATHS[] = { SimdPath::Scalar, SimdPath::Sse2,
+                                  SimdPath::Avx2 };
+
+// keeps the compiler from throwing away benchmark results
+static volatile uint32_t sink;
+
+// random quads the way the render components append them
+static std::vector<sf::Vertex> makeQuads(const bool rotated,
+                                         const bool translucent)
+{
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> position(-50.0f, WIDTH + 50.0f);
+  std::uniform_real_distribution<float> size(4.0f, 120.0f);
+  std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+  std::uniform_int_distribution<int> channel(0, 255);
+  std::uniform_int_distribution<int> alpha(32, 224);
+
+  std::vector<sf::Vertex> quads(QUAD_COUNT * 4);
+  for (std::size_t i = 0; i < QUAD_COUNT; i++)
+  {
+    const sf::Vector2f center(position(rng), position(rng) * HEIGHT / WIDTH);
+    const float halfWidth = size(rng) / 2.0f;
+    const float halfHeight = size(rng) / 2.0f;
+    const float a = rotated ? angle(rng) : 0.0f;
+    const sf::Vector2f axisX(std::cos(a) * halfWidth, std::sin(a) * halfWidth);
+    const sf::Vector2f axisY(-std::sin(a) * halfHeight,
+                             std::cos(a) * halfHeight);
+    const sf::Color color(
+      static_cast<sf::Uint8>(channel(rng)),
+      static_cast<sf::Uint8>(channel(rng)),
+      static_cast<sf::Uint8>(channel(rng)),
+      static_cast<sf::Uint8>(translucent ? alpha(rng) : 255)
+      );
+
+    sf::Vertex* quad = &quads[i * 4];
+    quad[0] = sf::Vertex(center - axisX - axisY, color);
+    quad[1] = sf::Vertex(center + axisX - axisY, color);
+    quad[2] = sf::Vertex(center + axisX + axisY, color);
+    quad[3] = sf::Vertex(center - axisX + axisY, color);
+  }
+  return quads;
+}
+
+static void drawAll(Framebuffer& framebuffer,
+                    const std::vector<sf::Vertex>& quads)
+{
+  framebuffer.clear(sf::Color::White);
+  for (std::size_t i = 0; i < quads.size(); i += 4)
+  {
+    framebuffer.drawQuad(&quads[i], nullptr);
+  }
+  sink = framebuffer.getPixel(WIDTH / 2, HEIGHT / 2);
+}
+
+static void runScene(const std::string& scene,
+                     const std::vector<sf::Vertex>& quads)
+{
+  Framebuffer reference(WIDTH, HEIGHT);
+  Framebuffer framebuffer(WIDTH, HEIGHT);
+
+  BatchMath::setPath(SimdPath::Scalar);
+  drawAll(reference, quads);
+
+  float baseline = 0.0f;
+  for (SimdPath path : PATHS)
+  {
+    if (BatchMath::setPath(path) != path)
+    {
+      continue;
+    }
+    const std::string name =
+      "Framebuffer " + scene + " " + BatchMath::getPathName(path);
+    const float t = Benchmark::measure(name, ITERATIONS, [&] {
+      drawAll(framebuffer, quads);
+    });
+    if (path == SimdPath::Scalar)
+    {
+      baseline = t;
+    }
+    else
+    {
+      Benchmark::logSpeedup(name, baseline, t);
+    }
+
+    // every path has to produce the same image
+    if (std::memcmp(reference.getPixels(), framebuffer.getPixels(),
+                    WIDTH * HEIGHT * sizeof(uint32_t)) != 0)
+    {
+      Log::error("Benchmark", "%s doesn't match the scalar output",
+                 name.c_str());
+    }
+  }
+}
+
+void Benchmark::softwareRender()
+{
+  const SimdPath best = BatchMath::getPath();
+
+  runScene("opaque quads", makeQuads(false, false));
+  runScene("rotated quads", makeQuads(true, false));
+  runScene("translucent quads", makeQuads(true, true));
+
+  BatchMath::setPath(best);
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "benchmarks/Benchmark.h"
+#include "spatial/LooseQuadtree.h"
+#include "spatial/HashGrid.h"
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+// queries per timed iteration
+static const int QUERIES = 100;
+// entities are spread out so that each one has about this much room
+static const float AREA_PER_ENTITY = 32.0f * 32.0f;
+
+static volatile std::size_t sink;
+
+static void benchmarkIndex(ISpatialIndex& index, const std::vector<AABB2>& boxes,
+                           const std::vector<AABB2>& moved,
+                           const std::vector<AABB2>& areas,
+                           const std::vector<Vector2>& points,
+                           const int iterations)
+{
+  const std::string prefix =
+    std::string(index.getNameC()) + " n=" + std::to_string(boxes.size()) + " ";
+  std::vector<EntityID> results;
+
+  Benchmark::measure(prefix + "build", iterations, [&] {
+    index.clear();
+    for (std::size_t i = 0; i < boxes.size(); i++)
+    {
+      index.insert(static_cast<EntityID>(i + 1), boxes[i]);
+    }
+    sink = index.size();
+  });
+
+  // moves every 10th entity a short distance and back again
+  bool away = true;
+  Benchmark::measure(prefix + "update 10%", iterations, [&] {
+    for (std::size_t i = 0; i < boxes.size(); i += 10)
+    {
+      index.update(static_cast<EntityID>(i + 1), away ? moved[i] : boxes[i]);
+    }
+    away = !away;
+  });
+
+  Benchmark::measure(prefix + "100 range queries", iterations, [&] {
+    results.clear();
+    for (int i = 0; i < QUERIES; i++)
+    {
+      index.query(areas[i], results);
+    }
+    sink = results.size();
+  });
+
+  Benchmark::measure(prefix + "100 kNN queries k=8", iterations, [&] {
+    results.clear();
+    for (int i = 0; i < QUERIES; i++)
+    {
+      index.queryNearest(points[i], 8, results);
+    }
+    sink = results.size();
+  });
+}
+
+void Benchmark::spatialIndex()
+{
+  const std::size_t counts[] = { 10000, 100000, 1000000 };
+
+  for (std::size_t count : counts)
+  {
+    const float worldHalf = std::sqrt(count * AREA_PER_ENTITY) / 2.0f;
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> position(-worldHalf, worldHalf);
+    std::uniform_real_distribution<float> size(4.0f, 32.0f);
+    std::uniform_real_distribution<float> offset(-8.0f, 8.0f);
+
+    std::vector<AABB2> boxes;
+    std::vector<AABB2> moved;
+    for (std::size_t i = 0; i < count; i++)
+    {
+      AABB2 box(position(rng), position(rng), size(rng), size(rng));
+      boxes.push_back(box);
+      box.center += Vector2(offset(rng), offset(rng));
+      moved.push_back(box);
+    }
+
+    // screen sized queries
+    std::vector<AABB2> areas;
+    std::vector<Vector2> points;
+    for (int i = 0; i < QUERIES; i++)
+    {
+      areas.push_back(AABB2(position(rng), position(rng), 800.0f, 600.0f));
+      points.push_back(Vector2(position(rng), position(rng)));
+    }
+
+    const int iterations = count >= 1000000 ? 2 : 10;
+
+    measure(
+      "Linear scan n=" + std::to_string(count) + " 100 range queries",
+      iterations,
+      [&] {
+        std::size_t found = 0;
+        for (const AABB2& area : areas)
+        {
+          for (const AABB2& box : boxes)
+          {
+            found += area.intersect(box) ? 1 : 0;
+          }
+        }
+        sink = found;
+      });
+
+    LooseQuadtree quadtree(Vector2::ZERO, worldHalf, 10);
+    benchmarkIndex(quadtree, boxes, moved, areas, points, iterations);
+
+    HashGrid grid(64.0f);
+    benchmarkIndex(grid, boxes, moved, areas, points, iterations);
+  }
+}
@@ -0,0 +1,145 @@
+#include "benchmarks/Benchmark.h"
+#include "tilemap/TileMap.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+static const int MAP_SIZE = 1024;
+static const float TILE_SIZE = 16.0f;
+static const int ITERATIONS = 100;
+
+// keeps the compiler from throwing away benchmark results
+static volatile std::size_t sink;
+
+// rolling ground with caves, roughly what a side scrolling level looks like
+static void buildTerrain(TileMap& map, const TileID dirt, const TileID rock)
+{
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> step(-1, 1);
+  std::uniform_int_distribution<int> roll(0, 99);
+  int ground = MAP_SIZE / 2;
+  for (int x = 0; x < MAP_SIZE; x++)
+  {
+    ground = std::max(16, std::min(MAP_SIZE - 16, ground + step(rng)));
+    for (int y = 0; y < ground; y++)
+    {
+      if (roll(rng) >= 5)
+      {
+        map.setTile(x, y, y < ground - 8 ? rock : dirt);
+      }
+    }
+  }
+}
+
+void Benchmark::tileMap()
+{
+  TileMap map(MAP_SIZE, MAP_SIZE, TILE_SIZE);
+  TileType type;
+  type.texture = nullptr;
+  type.color = sf::Color(120, 80, 40, 255);
+  type.solid = true;
+  const TileID dirt = map.addTileType(type);
+  type.color = sf::Color(90, 90, 90, 255);
+  const TileID rock = map.addTileType(type);
+  buildTerrain(map, dirt, rock);
+
+  // collision for the whole map, the cost of loading a level
+  std::vector<TileMap::TileRect> rects;
+  std::size_t boxes = 0;
+  measure("TileMap::buildCollision all chunks", 10, [&] {
+    boxes = 0;
+    for (int cy = 0; cy < map.getChunksY(); cy++)
+    {
+      for (int cx = 0; cx < map.getChunksX(); cx++)
+      {
+        map.buildCollision(cx, cy, rects);
+        boxes += rects.size();
+      }
+    }
+  });
+  std::size_t solid = 0;
+  for (int y = 0; y < MAP_SIZE; y++)
+  {
+    for (int x = 0; x < MAP_SIZE; x++)
+    {
+      solid += map.getTile(x, y) != 0;
+    }
+  }
+  Log::info(
+    TAG,
+    "Collision boxes %u for %u solid tiles",
+    static_cast<unsigned>(boxes),
+    static_cast<unsigned>(solid)
+    );
+
+  // an 800x600 view over the surface, 3x3 chunks
+  const AABB2 view(Vector2(MAP_SIZE * TILE_SIZE / 2.0f,
+                           MAP_SIZE * TILE_SIZE / 2.0f), 800.0f, 600.0f);
+  int minX, minY, maxX, maxY;
+  map.getChunkRange(view, minX, minY, maxX, maxY);
+
+  // baseline, one quad per visible tile rebuilt every frame
+  std::vector<sf::Vertex> vertices;
+  const float baseline = measure("Visible tiles rebuilt per frame",
+                                 ITERATIONS, [&] {
+    vertices.clear();
+    const int x0 = minX * TileMap::CHUNK_SIZE;
+    const int y0 = minY * TileMap::CHUNK_SIZE;
+    const int x1 = (maxX + 1) * TileMap::CHUNK_SIZE;
+    const int y1 = (maxY + 1) * TileMap::CHUNK_SIZE;
+    for (int y = y0; y < y1; y++)
+    {
+      for (int x = x0; x < x1; x++)
+      {
+        const TileID id = map.getTile(x, y);
+        if (id != 0)
+        {
+          const sf::Color& color = map.getTileType(id).color;
+          const float l = x * TILE_SIZE;
+          const float b = y * TILE_SIZE;
+          vertices.push_back(sf::Vertex(sf::Vector2f(l, b + TILE_SIZE), color));
+          vertices.push_back(sf::Vertex(sf::Vector2f(l + TILE_SIZE,
+                                                     b + TILE_SIZE), color));
+          vertices.push_back(sf::Vertex(sf::Vector2f(l + TILE_SIZE, b),
+                                        color));
+          vertices.push_back(sf::Vertex(sf::Vector2f(l, b), color));
+        }
+      }
+    }
+    sink = vertices.size();
+  });
+
+  // cached chunk meshes, only looked up once they are built
+  uint32_t frame = 0;
+  const float cached = measure("Visible chunk meshes cached", ITERATIONS, [&] {
+    frame++;
+    std::size_t count = 0;
+    for (int cy = minY; cy <= maxY; cy++)
+    {
+      for (int cx = minX; cx <= maxX; cx++)
+      {
+        auto mesh = map.getChunkMesh(cx, cy, frame);
+        count += mesh != nullptr ? mesh->size() : 0;
+      }
+    }
+    map.releaseStaleMeshes(frame, 1);
+    sink = count;
+  });
+  logSpeedup("Chunk mesh cache", baseline, cached);
+
+  // editing one tile costs a single chunk rebuild
+  measure("Chunk mesh rebuild after edit", ITERATIONS, [&] {
+    const int x = minX * TileMap::CHUNK_SIZE;
+    const int y = minY * TileMap::CHUNK_SIZE;
+    map.setTile(x, y, map.getTile(x, y) == dirt ? rock : dirt);
+    sink = map.getChunkMesh(minX, minY, frame)->size();
+  });
+
+  Log::info(
+    TAG,
+    "Chunks allocated %u of %u, meshes in memory %u",
+    static_cast<unsigned>(map.getChunkCount()),
+    map.getChunksX() * map.getChunksY(),
+    static_cast<unsigned>(map.getMeshCount())
+    );
+}
\ No newline at end of file
@@ -22,6 +22,19 @@ void Component::update(const float deltaMs)
 {
 }
 
+void Component::saveState(ByteWriter&) const
+{
+}
+
+bool Component::loadState(ByteReader&)
+{
+  return true;
+}
+
+void Component::rebuildPhysics()
+{
+}
+
 void Component::destroy()
 {
   parent = StrongEntityPtr();
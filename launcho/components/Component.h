@@ -2,6 +2,9 @@
 
 #include "types.h"
 
+class ByteReader;
+class ByteWriter;
+
 /**
  * The base class for all components used by entities.
  */
@@ -42,6 +45,25 @@ public:
    */
   virtual void update(const float deltaMs);
 
+  /**
+   * Saves the state that changes as the game runs, for replay keyframes.
+   * Components that only hold setup or visual state save nothing.
+   */
+  virtual void saveState(ByteWriter& out) const;
+
+  /**
+   * Restores what saveState() wrote.
+   * @return false if the state is corrupt.
+   */
+  virtual bool loadState(ByteReader& in);
+
+  /**
+   * Creates the component's Box2D bodies again in the physics system's new
+   * world, copying them from the old ones, which are freed with the old
+   * world once every component is done.
+   */
+  virtual void rebuildPhysics();
+
   /**
    * Destroys the component, freeing resources.
    * A class that overrides this method MUST call Component::destroy() to break 
@@ -0,0 +1,192 @@
+#include "ParticleEmitterComponent.h"
+#include "Entity.h"
+#include "Game.h"
+#include "graphics/QuadTarget.h"
+#include "utility/Log.h"
+#include <cassert>
+#include <cmath>
+
+const std::string ParticleEmitterComponent::TAG = "ParticleEmitterComponent";
+
+ParticleEmitterComponent::ParticleEmitterComponent(StrongEntityPtr parent,
+                                                   const std::size_t capacity)
+: RenderComponent(parent),
+  transform(),
+  pool(capacity),
+  look(),
+  imageName(),
+  texture(nullptr),
+  rate(0.0f),
+  pending(0.0f),
+  minLifetime(1.0f),
+  maxLifetime(1.0f),
+  minSpeed(0.0f),
+  maxSpeed(0.0f),
+  direction(0.0f),
+  spread(360.0f),
+  acceleration(),
+  emitting(true),
+  rng(Game::getInstance().getSeed() ^ parent->getID()),
+  vertices()
+{
+  look.startSize = 4.0f;
+  look.endSize = 4.0f;
+  look.startColor = sf::Color::White;
+  look.endColor = sf::Color::White;
+}
+
+bool ParticleEmitterComponent::initialize()
+{
+  transform = parent->getComponent<TransformComponent>().lock();
+  if (transform == nullptr)
+  {
+    return false;
+  }
+  Game::getInstance().getParticleSystem()->addEmitter(this);
+  return true;
+}
+
+void ParticleEmitterComponent::destroy()
+{
+  Game::getInstance().getParticleSystem()->removeEmitter(this);
+  transform = StrongTransformComponentPtr();
+  RenderComponent::destroy();
+}
+
+void ParticleEmitterComponent::draw(sf::RenderTarget& tgt)
+{
+  SFMLQuadTarget quads(tgt);
+  drawQuads(quads);
+}
+
+bool ParticleEmitterComponent::drawQuads(QuadTarget& tgt)
+{
+  if (vertices.empty())
+  {
+    return true;
+  }
+
+  // the quads are in world coordinates, flip them like everything else
+  sf::RenderStates states;
+  states.texture = texture;
+  states.transform = sf::Transform(
+    1.0f, 0.0f, 0.0f,
+    0.0f, -1.0f, static_cast<float>(tgt.getSize().y),
+    0.0f, 0.0f, 1.0f
+    );
+  tgt.drawQuads(&vertices[0], vertices.size(), states);
+  return true;
+}
+
+void ParticleEmitterComponent::simulate(const float dt)
+{
+  pool.update(dt, acceleration);
+
+  if (emitting)
+  {
+    pending += rate * dt;
+    const float whole = std::floor(pending);
+    pending -= whole;
+    emit(static_cast<std::size_t>(whole));
+  }
+
+  vertices.resize(pool.size() * 4);
+  if (!vertices.empty())
+  {
+    pool.writeQuads(&vertices[0], look);
+  }
+}
+
+std::size_t ParticleEmitterComponent::getParticleCount() const
+{
+  return pool.size();
+}
+
+void ParticleEmitterComponent::setRate(const float particlesPerSecond)
+{
+  rate = particlesPerSecond;
+}
+
+void ParticleEmitterComponent::setLifetime(const float minSeconds,
+                                           const float maxSeconds)
+{
+  assert(minSeconds > 0.0f && minSeconds <= maxSeconds);
+  minLifetime = minSeconds;
+  maxLifetime = maxSeconds;
+}
+
+void ParticleEmitterComponent::setSpeed(const float min, const float max)
+{
+  assert(min <= max);
+  minSpeed = min;
+  maxSpeed = max;
+}
+
+void ParticleEmitterComponent::setDirection(const float degrees,
+                                            const float spreadDegrees)
+{
+  direction = degrees;
+  spread = spreadDegrees;
+}
+
+void ParticleEmitterComponent::setAcceleration(const Vector2& accel)
+{
+  acceleration = accel;
+}
+
+void ParticleEmitterComponent::setEmitting(const bool enable)
+{
+  emitting = enable;
+  pending = 0.0f;
+}
+
+void ParticleEmitterComponent::setSize(const float start, const float end)
+{
+  look.startSize = start;
+  look.endSize = end;
+}
+
+void ParticleEmitterComponent::setColor(const sf::Color& start,
+                                        const sf::Color& end)
+{
+  look.startColor = start;
+  look.endColor = end;
+}
+
+bool ParticleEmitterComponent::setImage(const std::string& name)
+{
+  const AtlasRegion* found = Game::getInstance().getTextureAtlas()->find(name);
+  if (found == nullptr)
+  {
+    Log::error(TAG, "Image %s is not in the atlas", name.c_str());
+    return false;
+  }
+
+  imageName = name;
+  texture = found->texture;
+  look.texRect = found->rect;
+  return true;
+}
+
+void ParticleEmitterComponent::emit(const std::size_t count)
+{
+  std::uniform_real_distribution<float> life(minLifetime, maxLifetime);
+  std::uniform_real_distribution<float> speed(minSpeed, maxSpeed);
+  std::uniform_real_distribution<float> angle(
+    direction - (spread / 2.0f),
+    direction + (spread / 2.0f)
+    );
+  const Vector2& origin = transform->getPosition();
+
+  for (std::size_t i = 0; i < count && !pool.full(); i++)
+  {
+    // clockwise degrees, see TransformComponent
+    const float rad = -angle(rng) * Transform2::DEG_TO_RAD;
+    const float s = speed(rng);
+    pool.add(
+      origin,
+      Vector2(std::cos(rad) * s, std::sin(rad) * s),
+      life(rng)
+      );
+  }
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "RenderComponent.h"
+#include "TransformComponent.h"
+#include "graphics/ParticlePool.h"
+#include "graphics/TextureAtlas.h"
+#include "math/Vector2.h"
+#include "types.h"
+#include <random>
+#include <string>
+#include <vector>
+
+class ParticleEmitterComponent;
+using StrongParticleEmitterComponentPtr =
+  std::shared_ptr<ParticleEmitterComponent>;
+using WeakParticleEmitterComponentPtr =
+  std::weak_ptr<ParticleEmitterComponent>;
+
+/**
+ * Spawns particles at the entity's position and draws all of them with a
+ * single vertex array. Particles are simulated by the ParticleSystem, not as
+ * entities.
+ * The emitter is culled with the entity, so size the entity's transform to
+ * cover the area the particles spread over.
+ */
+class ParticleEmitterComponent
+  : public RenderComponent
+{
+private:
+  static const std::string TAG;
+
+  StrongTransformComponentPtr transform;
+  ParticlePool pool;
+  ParticleLook look;
+  // empty for untextured particles
+  std::string imageName;
+  const sf::Texture* texture;
+
+  // particles per second, and the fraction of one carried to the next update
+  float rate;
+  float pending;
+  float minLifetime;
+  float maxLifetime;
+  float minSpeed;
+  float maxSpeed;
+  // degrees, same convention as TransformComponent
+  float direction;
+  float spread;
+  Vector2 acceleration;
+  bool emitting;
+
+  std::minstd_rand rng;
+  // quads in world coordinates, rebuilt every update
+  std::vector<sf::Vertex> vertices;
+
+public:
+  /**
+   * @param parent The owner of this component.
+   * @param capacity Most particles alive at once.
+   */
+  ParticleEmitterComponent(StrongEntityPtr parent,
+                           const std::size_t capacity);
+
+  bool initialize() override;
+  void destroy() override;
+  void draw(sf::RenderTarget& tgt) override;
+  bool drawQuads(QuadTarget& tgt) override;
+
+  /**
+   * Spawns, moves and removes particles and rebuilds the vertices. Called by
+   * the ParticleSystem, possibly on a worker thread.
+   * @param dt Elapsed time in seconds.
+   */
+  void simulate(const float dt);
+
+  std::size_t getParticleCount() const;
+
+  // emission
+  void setRate(const float particlesPerSecond);
+  void setLifetime(const float minSeconds, const float maxSeconds);
+  void setSpeed(const float min, const float max);
+  void setDirection(const float degrees, const float spreadDegrees);
+  void setAcceleration(const Vector2& accel);
+  void setEmitting(const bool enable);
+
+  // appearance
+  void setSize(const float start, const float end);
+  void setColor(const sf::Color& start, const sf::Color& end);
+  /**
+   * Draws the particles with an image from the game's texture atlas.
+   * @return false if the atlas doesn't have the image.
+   */
+  bool setImage(const std::string& name);
+
+private:
+  void emit(const std::size_t count);
+};
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "utility/Log.h"
 #include "Game.h"
 #include "Box2DPhysics.h"
+#include "utility/ByteStream.h"
 #include "utility/conversions.h"
 
 static const Vector2 GRAVITY(0.0f, -9.80665f);
@@ -22,24 +23,11 @@ ComponentID PhysicsComponent::getID() const
 
 bool PhysicsComponent::initialize()
 {
-  auto world = Game::getInstance().getPhysicsSystem()->getWorld().lock();
   auto tc = parent->getComponent<TransformComponent>().lock();
 
-  b2BodyDef bodyDef;  
-  bodyDef.type = type == Type::Static ? b2_staticBody : b2_dynamicBody;
+  b2BodyDef bodyDef;
   bodyDef.position.Set(tc->getPosition().x, tc->getPosition().y);
-  bodyDef.fixedRotation = true;
-  bodyDef.userData = reinterpret_cast<void*>(parent->getID());
-  body = world->CreateBody(&bodyDef);
-
-  b2PolygonShape shape;
-  shape.SetAsBox(tc->getBounds().halfSize.x, tc->getBounds().halfSize.y);
-  b2FixtureDef fixture;
-  fixture.shape = &shape;
-  fixture.density = 0.0001f;
-  fixture.friction = 0.25f;
-  fixture.restitution = 0.5f;
-  body->CreateFixture(&fixture);
+  createBody(bodyDef);
 
   return true;
 }
@@ -48,6 +36,50 @@ void PhysicsComponent::update(const float deltaMs)
 {
 }
 
+void PhysicsComponent::saveState(ByteWriter& out) const
+{
+  out.writeFloat(body->GetPosition().x);
+  out.writeFloat(body->GetPosition().y);
+  out.writeFloat(body->GetAngle());
+  out.writeFloat(body->GetLinearVelocity().x);
+  out.writeFloat(body->GetLinearVelocity().y);
+  out.writeFloat(body->GetAngularVelocity());
+  out.writeU8(body->IsAwake() ? 1 : 0);
+}
+
+bool PhysicsComponent::loadState(ByteReader& in)
+{
+  b2Vec2 position;
+  float angle;
+  b2Vec2 velocity;
+  float angularVelocity;
+  uint8_t awake;
+  if (!in.readFloat(position.x) || !in.readFloat(position.y) ||
+      !in.readFloat(angle) ||
+      !in.readFloat(velocity.x) || !in.readFloat(velocity.y) ||
+      !in.readFloat(angularVelocity) || !in.readU8(awake))
+  {
+    return false;
+  }
+  body->SetTransform(position, angle);
+  body->SetLinearVelocity(velocity);
+  body->SetAngularVelocity(angularVelocity);
+  body->SetAwake(awake != 0);
+  return true;
+}
+
+void PhysicsComponent::rebuildPhysics()
+{
+  b2BodyDef bodyDef;
+  bodyDef.position = body->GetPosition();
+  bodyDef.angle = body->GetAngle();
+  bodyDef.linearVelocity = body->GetLinearVelocity();
+  bodyDef.angularVelocity = body->GetAngularVelocity();
+  bodyDef.awake = body->IsAwake();
+  // the old body is freed with the old world
+  createBody(bodyDef);
+}
+
 void PhysicsComponent::destroy()
 {
   auto world = Game::getInstance().getPhysicsSystem()->getWorld().lock();
@@ -60,3 +92,23 @@ void PhysicsComponent::applyImpulse(const Vector2& impulse)
   b2Vec2 temp(impulse.x, impulse.y);
   body->ApplyLinearImpulse(temp, body->GetWorldCenter(), true);
 }
+
+void PhysicsComponent::createBody(b2BodyDef& bodyDef)
+{
+  auto world = Game::getInstance().getPhysicsSystem()->getWorld().lock();
+  auto tc = parent->getComponent<TransformComponent>().lock();
+
+  bodyDef.type = type == Type::Static ? b2_staticBody : b2_dynamicBody;
+  bodyDef.fixedRotation = true;
+  bodyDef.userData = reinterpret_cast<void*>(parent->getID());
+  body = world->CreateBody(&bodyDef);
+
+  b2PolygonShape shape;
+  shape.SetAsBox(tc->getBounds().halfSize.x, tc->getBounds().halfSize.y);
+  b2FixtureDef fixture;
+  fixture.shape = &shape;
+  fixture.density = 0.0001f;
+  fixture.friction = 0.25f;
+  fixture.restitution = 0.5f;
+  body->CreateFixture(&fixture);
+}
\ No newline at end of file
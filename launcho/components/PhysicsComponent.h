@@ -30,7 +30,15 @@ public:
   ComponentID getID() const override;
   bool initialize() override;
   void update(const float deltaMs) override;
+  void saveState(ByteWriter& out) const override;
+  bool loadState(ByteReader& in) override;
+  void rebuildPhysics() override;
   void destroy() override;
 
   void applyImpulse(const Vector2& impulse);
+
+private:
+  // adds the body and its box to the world, the position and motion come from
+  // the def
+  void createBody(b2BodyDef& bodyDef);
 };
\ No newline at end of file
@@ -1,43 +1,49 @@
 #include "RectangleRenderComponent.h"
-#include "TransformComponent.h"
 #include "Entity.h"
-#include "utility/conversions.h"
+#include <cassert>
 
 RectangleRenderComponent::RectangleRenderComponent(StrongEntityPtr parent)
-:RenderComponent(parent)
+:RenderComponent(parent), transform(), color(sf::Color::White)
 {
 }
 
 bool RectangleRenderComponent::initialize()
 {
-  // sfml defaults the origin of an object to its upper left corner,
-  // need to move that origin to the center of the object
-  auto tc = parent->getComponent<TransformComponent>().lock();
-  Vector2 origin = tc->getPosition() - tc->getUpperLeftCorner();
-  rect.setSize(convert(tc->getBounds().halfSize * 2.0f));
-  rect.setOrigin(convert(tc->getBounds().halfSize));
-  return true;
+  transform = parent->getComponent<TransformComponent>().lock();
+  return transform != nullptr;
+}
+
+void RectangleRenderComponent::destroy()
+{
+  transform = StrongTransformComponentPtr();
+  RenderComponent::destroy();
 }
 
 void RectangleRenderComponent::draw(sf::RenderTarget& tgt)
 {
-  auto tc = parent->getComponent<TransformComponent>().lock();
-  sf::Transform transform;
-  transform.translate(
-    tc->getPosition().x,
-    // SFML uses an inverted y axis, need to account for that
-    tgt.getSize().y - tc->getPosition().y
-    );
-  transform.rotate(tc->getRotation());
-  tgt.draw(rect, transform);
+  RenderCommand command;
+  buildCommand(command);
+  sf::Vertex quad[4];
+  command.writeQuad(quad, static_cast<float>(tgt.getSize().y));
+  tgt.draw(quad, 4, sf::Quads);
+}
+
+bool RectangleRenderComponent::buildCommand(RenderCommand& command) const
+{
+  assert(transform != nullptr);
+  command.texture = nullptr;
+  command.transform = transform->getTransform();
+  command.halfSize = transform->getBounds().halfSize;
+  command.color = color;
+  return true;
 }
 
 const sf::Color& RectangleRenderComponent::getColor() const
 {
-  return rect.getFillColor();
+  return color;
 }
 
-void RectangleRenderComponent::setColor(const sf::Color& color)
+void RectangleRenderComponent::setColor(const sf::Color& _color)
 {
-  rect.setFillColor(color);
+  color = _color;
 }
\ No newline at end of file
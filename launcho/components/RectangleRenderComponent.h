@@ -1,6 +1,7 @@
 #pragma once
 
 #include "RenderComponent.h"
+#include "TransformComponent.h"
 #include "types.h"
 
 class RectangleRenderComponent;
@@ -12,13 +13,17 @@ class RectangleRenderComponent
   : public RenderComponent
 {
 private:
-  sf::RectangleShape rect;
+  // cached at initialization so drawing doesn't look it up every frame
+  StrongTransformComponentPtr transform;
+  sf::Color color;
 
 public:
   RectangleRenderComponent(StrongEntityPtr parent);
 
   bool initialize() override;
+  void destroy() override;
   void draw(sf::RenderTarget& tgt) override;
+  bool buildCommand(RenderCommand& command) const override;
 
   const sf::Color& getColor() const;
   void setColor(const sf::Color& color);
@@ -23,3 +23,13 @@ void RenderComponent::setLayer(RenderLayer newLayer)
 {
   layer = newLayer;
 }
+
+bool RenderComponent::buildCommand(RenderCommand&) const
+{
+  return false;
+}
+
+bool RenderComponent::drawQuads(QuadTarget&)
+{
+  return false;
+}
\ No newline at end of file
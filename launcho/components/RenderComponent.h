@@ -2,10 +2,15 @@
 
 #include "Component.h"
 #include "types.h"
+#include "graphics/RenderCommand.h"
+#include "utility/FrameArena.h"
 #include <SFML/Graphics.hpp>
 
+class QuadTarget;
 class RenderComponent;
 using StrongRenderComponentPtr = std::shared_ptr<RenderComponent>;
+// renderables in draw order, rebuilt every frame in the frame arena
+using RenderList = ArenaVector<RenderComponent*>;
 using WeakRenderComponentPtr = std::weak_ptr<RenderComponent>;
 
 /**
@@ -33,4 +38,23 @@ public:
 
   // Draws the component onto a render target
   virtual void draw(sf::RenderTarget& tgt) = 0;
+
+  /**
+   * Describes the component as a quad for the command buffer. Called from
+   * worker threads while the frame is being built, so it must only read the
+   * component and the components it caches.
+   * @param command[out] Fill in the texture, transform, size, texture rect
+   * and color. The layer is already set.
+   * @return false if the component can't be described by a quad and has to
+   * be drawn with draw() instead. The default implementation returns false.
+   */
+  virtual bool buildCommand(RenderCommand& command) const;
+
+  /**
+   * Draws a component that buildCommand() can't describe, for renderers
+   * without an sf::RenderTarget.
+   * @return false if the component can only be drawn with draw(). The
+   * default implementation returns false.
+   */
+  virtual bool drawQuads(QuadTarget& tgt);
 };
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "SpriteRenderComponent.h"
+#include "Entity.h"
+#include "Game.h"
+#include "utility/Log.h"
+#include <cassert>
+
+const std::string SpriteRenderComponent::TAG = "SpriteRenderComponent";
+
+SpriteRenderComponent::SpriteRenderComponent(StrongEntityPtr parent,
+                                             const std::string& _imageName)
+: RenderComponent(parent),
+  transform(),
+  imageName(_imageName),
+  region(),
+  color(sf::Color::White)
+{
+}
+
+bool SpriteRenderComponent::initialize()
+{
+  transform = parent->getComponent<TransformComponent>().lock();
+  return transform != nullptr && setImage(imageName);
+}
+
+void SpriteRenderComponent::destroy()
+{
+  transform = StrongTransformComponentPtr();
+  RenderComponent::destroy();
+}
+
+void SpriteRenderComponent::draw(sf::RenderTarget& tgt)
+{
+  RenderCommand command;
+  buildCommand(command);
+  sf::Vertex quad[4];
+  command.writeQuad(quad, static_cast<float>(tgt.getSize().y));
+  sf::RenderStates states;
+  states.texture = command.texture;
+  tgt.draw(quad, 4, sf::Quads, states);
+}
+
+bool SpriteRenderComponent::buildCommand(RenderCommand& command) const
+{
+  assert(transform != nullptr);
+  command.texture = region.texture;
+  command.transform = transform->getTransform();
+  command.halfSize = transform->getBounds().halfSize;
+  command.texRect = region.rect;
+  command.color = color;
+  return true;
+}
+
+const std::string& SpriteRenderComponent::getImageName() const
+{
+  return imageName;
+}
+
+bool SpriteRenderComponent::setImage(const std::string& name)
+{
+  const AtlasRegion* found = Game::getInstance().getTextureAtlas()->find(name);
+  if (found == nullptr)
+  {
+    Log::error(TAG, "Image %s is not in the atlas", name.c_str());
+    return false;
+  }
+
+  imageName = name;
+  region = *found;
+  return true;
+}
+
+const sf::Color& SpriteRenderComponent::getColor() const
+{
+  return color;
+}
+
+void SpriteRenderComponent::setColor(const sf::Color& _color)
+{
+  color = _color;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "RenderComponent.h"
+#include "TransformComponent.h"
+#include "graphics/TextureAtlas.h"
+#include "types.h"
+#include <string>
+
+class SpriteRenderComponent;
+using StrongSpriteRenderComponentPtr = std::shared_ptr<SpriteRenderComponent>;
+using WeakSpriteRenderComponentPtr = std::weak_ptr<SpriteRenderComponent>;
+
+/**
+ * Draws an image from the game's texture atlas stretched over the entity's
+ * bounds. Sprites on the same atlas page are batched into one draw call.
+ */
+class SpriteRenderComponent
+  : public RenderComponent
+{
+private:
+  static const std::string TAG;
+
+  StrongTransformComponentPtr transform;
+  // name of the image in the atlas
+  std::string imageName;
+  AtlasRegion region;
+  sf::Color color;
+
+public:
+  /**
+   * @param parent The owner of this component.
+   * @param _imageName Name of the image in the game's texture atlas.
+   */
+  SpriteRenderComponent(StrongEntityPtr parent, const std::string& _imageName);
+
+  bool initialize() override;
+  void destroy() override;
+  void draw(sf::RenderTarget& tgt) override;
+  bool buildCommand(RenderCommand& command) const override;
+
+  const std::string& getImageName() const;
+  /**
+   * Switches to another image from the atlas.
+   * @return false if the atlas doesn't have the image.
+   */
+  bool setImage(const std::string& name);
+
+  // tint multiplied with the image, white draws it unchanged
+  const sf::Color& getColor() const;
+  void setColor(const sf::Color& _color);
+};
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "TileMapComponent.h"
+#include "Entity.h"
+#include "Game.h"
+#include "Box2DPhysics.h"
+#include "graphics/QuadTarget.h"
+#include "utility/Log.h"
+
+const std::string TileMapComponent::TAG = "TileMapComponent";
+
+TileMapComponent::TileMapComponent(StrongEntityPtr parent, const int width,
+                                   const int height, const float tileSize)
+: RenderComponent(parent),
+  transform(),
+  map(width, height, tileSize),
+  bodies(),
+  frame(0),
+  drawnChunks(0),
+  changedChunks(),
+  rects()
+{
+}
+
+bool TileMapComponent::initialize()
+{
+  transform = parent->getComponent<TransformComponent>().lock();
+  if (transform == nullptr)
+  {
+    return false;
+  }
+
+  // keep the lower left corner where it is and cover the map
+  const Vector2 origin = transform->getBounds().lowerLeft();
+  const float w = map.getWidth() * map.getTileSize();
+  const float h = map.getHeight() * map.getTileSize();
+  transform->setSize(w, h);
+  transform->setPosition(origin + Vector2(w / 2.0f, h / 2.0f));
+
+  bodies.assign(map.getChunksX() * map.getChunksY(), nullptr);
+  // tiles set before now
+  update(0.0f);
+  return true;
+}
+
+void TileMapComponent::update(const float)
+{
+  map.takeCollisionChanges(changedChunks);
+  for (int chunk : changedChunks)
+  {
+    rebuildCollision(chunk);
+  }
+}
+
+void TileMapComponent::rebuildPhysics()
+{
+  // the old bodies are freed with the old world
+  for (std::size_t chunk = 0; chunk < bodies.size(); chunk++)
+  {
+    if (bodies[chunk] != nullptr)
+    {
+      bodies[chunk] = nullptr;
+      rebuildCollision(static_cast<int>(chunk));
+    }
+  }
+}
+
+void TileMapComponent::destroy()
+{
+  auto world = Game::getInstance().getPhysicsSystem()->getWorld().lock();
+  for (auto& body : bodies)
+  {
+    if (body != nullptr)
+    {
+      world->DestroyBody(body);
+      body = nullptr;
+    }
+  }
+  transform = StrongTransformComponentPtr();
+  RenderComponent::destroy();
+}
+
+void TileMapComponent::draw(sf::RenderTarget& tgt)
+{
+  SFMLQuadTarget quads(tgt);
+  drawQuads(quads);
+}
+
+bool TileMapComponent::drawQuads(QuadTarget& tgt)
+{
+  frame++;
+  drawnChunks = 0;
+
+  // the view in world coordinates relative to the map
+  const float targetHeight = static_cast<float>(tgt.getSize().y);
+  const sf::View& view = tgt.getView();
+  const Vector2 origin = transform->getBounds().lowerLeft();
+  const AABB2 area(
+    Vector2(view.getCenter().x, targetHeight - view.getCenter().y) - origin,
+    view.getSize().x,
+    view.getSize().y
+    );
+
+  int minX, minY, maxX, maxY;
+  if (map.getChunkRange(area, minX, minY, maxX, maxY))
+  {
+    // meshes are relative to the map, flip them like everything else
+    sf::RenderStates states;
+    states.transform = sf::Transform(
+      1.0f, 0.0f, origin.x,
+      0.0f, -1.0f, targetHeight - origin.y,
+      0.0f, 0.0f, 1.0f
+      );
+
+    for (int cy = minY; cy <= maxY; cy++)
+    {
+      for (int cx = minX; cx <= maxX; cx++)
+      {
+        auto mesh = map.getChunkMesh(cx, cy, frame);
+        if (mesh == nullptr)
+        {
+          continue;
+        }
+        for (const auto& batch : *mesh)
+        {
+          states.texture = batch.texture;
+          tgt.drawQuads(&batch.vertices[0], batch.vertices.size(), states);
+        }
+        drawnChunks++;
+      }
+    }
+  }
+
+  map.releaseStaleMeshes(frame, MESH_MAX_AGE);
+  return true;
+}
+
+TileMap& TileMapComponent::getMap()
+{
+  return map;
+}
+
+const TileMap& TileMapComponent::getMap() const
+{
+  return map;
+}
+
+TileID TileMapComponent::addTileImage(const std::string& name,
+                                      const bool solid)
+{
+  const AtlasRegion* found = Game::getInstance().getTextureAtlas()->find(name);
+  if (found == nullptr)
+  {
+    Log::error(TAG, "Image %s is not in the atlas", name.c_str());
+    return 0;
+  }
+
+  TileType type;
+  type.texture = found->texture;
+  type.texRect = found->rect;
+  type.color = sf::Color::White;
+  type.solid = solid;
+  return map.addTileType(type);
+}
+
+TileID TileMapComponent::addTileColor(const sf::Color& color,
+                                      const bool solid)
+{
+  TileType type;
+  type.texture = nullptr;
+  type.color = color;
+  type.solid = solid;
+  return map.addTileType(type);
+}
+
+unsigned TileMapComponent::getDrawnChunks() const
+{
+  return drawnChunks;
+}
+
+void TileMapComponent::rebuildCollision(const int chunk)
+{
+  auto world = Game::getInstance().getPhysicsSystem()->getWorld().lock();
+  if (bodies[chunk] != nullptr)
+  {
+    world->DestroyBody(bodies[chunk]);
+    bodies[chunk] = nullptr;
+  }
+
+  map.buildCollision(chunk % map.getChunksX(), chunk / map.getChunksX(),
+                     rects);
+  if (rects.empty())
+  {
+    return;
+  }
+
+  const Vector2 origin = transform->getBounds().lowerLeft();
+  b2BodyDef bodyDef;
+  bodyDef.type = b2_staticBody;
+  bodyDef.position.Set(origin.x, origin.y);
+  bodyDef.userData = reinterpret_cast<void*>(parent->getID());
+  bodies[chunk] = world->CreateBody(&bodyDef);
+
+  const float size = map.getTileSize();
+  for (const auto& rect : rects)
+  {
+    const float hw = rect.width * size / 2.0f;
+    const float hh = rect.height * size / 2.0f;
+    b2PolygonShape shape;
+    shape.SetAsBox(hw, hh, b2Vec2((rect.x * size) + hw, (rect.y * size) + hh),
+                   0.0f);
+    b2FixtureDef fixture;
+    fixture.shape = &shape;
+    fixture.friction = 0.25f;
+    fixture.restitution = 0.5f;
+    bodies[chunk]->CreateFixture(&fixture);
+  }
+
+  Log::verbose(
+    TAG,
+    "Chunk %d collision rebuilt with %u boxes",
+    chunk,
+    static_cast<unsigned>(rects.size())
+    );
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "RenderComponent.h"
+#include "TransformComponent.h"
+#include "tilemap/TileMap.h"
+#include "types.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class b2Body;
+
+class TileMapComponent;
+using StrongTileMapComponentPtr = std::shared_ptr<TileMapComponent>;
+using WeakTileMapComponentPtr = std::weak_ptr<TileMapComponent>;
+
+/**
+ * Draws a TileMap and gives its solid tiles static collision. Only the chunks
+ * in view are drawn, with one call per texture in each chunk, and each chunk
+ * gets a single static body holding its solid tiles merged into boxes.
+ * The map's lower left corner is at the lower left of the entity's bounds,
+ * and the transform is resized to cover the whole map when the component is
+ * initialized. Rotation and scale are ignored.
+ * Like other components, changing tiles doesn't invalidate a cached layer, so
+ * keep maps that change often out of cached layers.
+ */
+class TileMapComponent
+  : public RenderComponent
+{
+private:
+  static const std::string TAG;
+  // frames a chunk can go without being drawn before its mesh is freed
+  static const uint32_t MESH_MAX_AGE = 300;
+
+  StrongTransformComponentPtr transform;
+  TileMap map;
+  // one per chunk, nullptr if the chunk has nothing solid
+  std::vector<b2Body*> bodies;
+  uint32_t frame;
+  unsigned drawnChunks;
+
+  // scratch for rebuilding collision
+  std::vector<int> changedChunks;
+  std::vector<TileMap::TileRect> rects;
+
+public:
+  /**
+   * @param parent The owner of this component.
+   * @param width Width of the map in tiles.
+   * @param height Height of the map in tiles.
+   * @param tileSize Width and height of a tile in world units.
+   */
+  TileMapComponent(StrongEntityPtr parent, const int width, const int height,
+                   const float tileSize);
+
+  bool initialize() override;
+  // rebuilds the collision of chunks whose solid tiles changed
+  void update(const float deltaMs) override;
+  void rebuildPhysics() override;
+  void destroy() override;
+  void draw(sf::RenderTarget& tgt) override;
+  bool drawQuads(QuadTarget& tgt) override;
+
+  TileMap& getMap();
+  const TileMap& getMap() const;
+
+  /**
+   * Adds a kind of tile drawn with an image from the game's texture atlas.
+   * @return The id of the tile, or 0 if the atlas doesn't have the image.
+   */
+  TileID addTileImage(const std::string& name, const bool solid);
+
+  /**
+   * Adds a kind of tile drawn as a solid color.
+   */
+  TileID addTileColor(const sf::Color& color, const bool solid);
+
+  // chunks drawn last frame
+  unsigned getDrawnChunks() const;
+
+private:
+  void rebuildCollision(const int chunk);
+};
\ No newline at end of file
@@ -1,8 +1,12 @@
 #include "TransformComponent.h"
+#include "Game.h"
+#include "SpatialSystem.h"
+#include "utility/ByteStream.h"
 #include <cassert>
+#include <cmath>
 
 TransformComponent::TransformComponent(StrongEntityPtr _parent)
-: Component(_parent), rotation(0.0f), bounds()
+: Component(_parent), rotation(0.0f), bounds(), moved(false)
 {
 }
 
@@ -11,6 +15,31 @@ ComponentID TransformComponent::getID() const
   return ID;
 }
 
+void TransformComponent::saveState(ByteWriter& out) const
+{
+  out.writeFloat(rotation);
+  out.writeFloat(bounds.center.x);
+  out.writeFloat(bounds.center.y);
+  out.writeFloat(bounds.halfSize.x);
+  out.writeFloat(bounds.halfSize.y);
+}
+
+bool TransformComponent::loadState(ByteReader& in)
+{
+  float degrees;
+  AABB2 saved;
+  if (!in.readFloat(degrees) ||
+      !in.readFloat(saved.center.x) || !in.readFloat(saved.center.y) ||
+      !in.readFloat(saved.halfSize.x) || !in.readFloat(saved.halfSize.y))
+  {
+    return false;
+  }
+  rotation = degrees;
+  bounds = saved;
+  markMoved();
+  return true;
+}
+
 float TransformComponent::getRotation() const
 {
   return rotation;
@@ -27,6 +56,7 @@ void TransformComponent::setRotation(float degrees)
   {
     rotation += 360.0f;
   }
+  markMoved();
 }
 
 void TransformComponent::rotate(float degrees)
@@ -39,6 +69,30 @@ const AABB2& TransformComponent::getBounds() const
   return bounds;
 }
 
+AABB2 TransformComponent::getWorldBounds() const
+{
+  if (rotation == 0.0f)
+  {
+    return bounds;
+  }
+
+  const float rad = rotation * Transform2::DEG_TO_RAD;
+  const float c = std::fabs(std::cos(rad));
+  const float s = std::fabs(std::sin(rad));
+  return AABB2(
+    bounds.center,
+    Vector2(
+      (c * bounds.halfSize.x) + (s * bounds.halfSize.y),
+      (s * bounds.halfSize.x) + (c * bounds.halfSize.y)
+      )
+    );
+}
+
+Transform2 TransformComponent::getTransform() const
+{
+  return Transform2::make(bounds.center, rotation);
+}
+
 const Vector2& TransformComponent::getPosition() const
 {
   return bounds.center;
@@ -47,11 +101,13 @@ const Vector2& TransformComponent::getPosition() const
 void TransformComponent::setPosition(const Vector2& pos)
 {
   bounds.center = pos;
+  markMoved();
 }
 
 void TransformComponent::move(const Vector2& offset)
 {
   bounds.center += offset;
+  markMoved();
 }
 
 float TransformComponent::getWidth() const
@@ -68,12 +124,14 @@ void TransformComponent::setWidth(float width)
 {
   assert(width > 0.0f);
   bounds.halfSize.x = width / 2.0f;
+  markMoved();
 }
 
 void TransformComponent::setHeight(float height)
 {
   assert(height > 0.0f);
   bounds.halfSize.y = height / 2.0f;
+  markMoved();
 }
 
 void TransformComponent::setSize(float width, float height)
@@ -102,3 +160,21 @@ Vector2 TransformComponent::getLowerRightCorner() const
   return bounds.center + Vector2(bounds.halfSize.x, -bounds.halfSize.y);
 }
 
+bool TransformComponent::isMoved() const
+{
+  return moved;
+}
+
+void TransformComponent::clearMoved()
+{
+  moved = false;
+}
+
+void TransformComponent::markMoved()
+{
+  if (!moved)
+  {
+    moved = true;
+    Game::getInstance().getSpatialSystem()->entityMoved(getParentID());
+  }
+}
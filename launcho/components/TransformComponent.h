@@ -3,6 +3,7 @@
 #include "Component.h"
 #include "types.h"
 #include "math/AABB2.h"
+#include "math/Transform2.h"
 
 class TransformComponent;
 using StrongTransformComponentPtr = std::shared_ptr<TransformComponent>;
@@ -18,12 +19,16 @@ private:
   float rotation;
   // position and size of object
   AABB2 bounds;
+  // set when the transform changes, until the spatial system picks it up
+  bool moved;
 
 public:
   static const ComponentID ID = 0x2e15c002;  
 
   explicit TransformComponent(StrongEntityPtr _parent);
   ComponentID getID() const override;
+  void saveState(ByteWriter& out) const override;
+  bool loadState(ByteReader& in) override;
 
   float getRotation() const;
   void setRotation(float degrees);
@@ -31,6 +36,12 @@ public:
 
   const AABB2& getBounds() const;
 
+  // box that contains the whole object once it is rotated
+  AABB2 getWorldBounds() const;
+
+  // rotation and translation of the object as a matrix
+  Transform2 getTransform() const;
+
   // the position is the center of the object
   const Vector2& getPosition() const;
   void setPosition(const Vector2& pos);
@@ -46,4 +57,12 @@ public:
   Vector2 getUpperLeftCorner() const;
   Vector2 getUpperRightCorner() const;
   Vector2 getLowerRightCorner() const;
+
+  // whether the transform has changed since clearMoved() was called
+  bool isMoved() const;
+  void clearMoved();
+
+private:
+  // notifies the spatial system the first time the transform changes
+  void markMoved();
 };
\ No newline at end of file
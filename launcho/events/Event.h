@@ -14,8 +14,9 @@ private:
   const float timestamp;
 
 public:
+  // nullptr if the event is of another type
   template<typename EventType>
-  static std::shared_ptr<EventType> cast(StrongEventPtr evt);
+  static const EventType* cast(const Event& evt);
 
   Event();
   Event& operator=(Event&) = delete;
@@ -31,22 +32,21 @@ public:
 };
 
 template<typename EventType>
-std::shared_ptr<EventType> Event::cast(StrongEventPtr evt)
+const EventType* Event::cast(const Event& evt)
 {
-  assert(evt != nullptr);
-
-  if (evt->getID() == EventType::ID)
+  if (evt.getID() == EventType::ID)
   {
-    return std::dynamic_pointer_cast<EventType>(evt);
+    // the id already says what type it is
+    return static_cast<const EventType*>(&evt);
   }
   else
   {
     Log::warning(TAG,
                  "Invalid pointer cast, expected %u, type was %u (%s)",
                  EventType::ID, 
-                 evt->getID(), 
-                 evt->getNameC()
+                 evt.getID(), 
+                 evt.getNameC()
                  );
-    return std::shared_ptr<EventType>();
+    return nullptr;
   }
 }
\ No newline at end of file
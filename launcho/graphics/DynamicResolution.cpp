@@ -0,0 +1,147 @@
+#include "DynamicResolution.h"
+#include "utility/Log.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+const std::string DynamicResolution::TAG = "DynamicResolution";
+
+constexpr float DynamicResolution::STEP;
+
+// weight of the newest frame in the smoothed render time
+static const float SMOOTHING = 0.1f;
+// frames over budget before stepping down
+static const unsigned DOWN_FRAMES = 10;
+// frames with room to spare before stepping up
+static const unsigned UP_FRAMES = 60;
+// frames ignored after a change while the average catches up
+static const unsigned SETTLE_FRAMES = 30;
+// a step up has to be predicted to fit in this much of the budget
+static const float UP_HEADROOM = 0.85f;
+
+// keeps repeated steps from drifting off multiples of STEP
+static float snap(const float scale)
+{
+  return std::round(scale / DynamicResolution::STEP) *
+         DynamicResolution::STEP;
+}
+
+DynamicResolution::DynamicResolution()
+: budget(0.0f),
+  minScale(1.0f),
+  scale(1.0f),
+  average(0.0f),
+  haveAverage(false),
+  framesOver(0),
+  framesUnder(0),
+  settleFrames(0),
+  changes(0)
+{
+}
+
+void DynamicResolution::initialize(const float budgetMs,
+                                   const float _minScale)
+{
+  assert(budgetMs >= 0.0f);
+  assert(_minScale > 0.0f && _minScale <= 1.0f);
+  budget = budgetMs;
+  minScale = _minScale;
+  scale = 1.0f;
+  haveAverage = false;
+  framesOver = 0;
+  framesUnder = 0;
+  settleFrames = 0;
+  changes = 0;
+}
+
+bool DynamicResolution::update(const float renderMs)
+{
+  if (!haveAverage)
+  {
+    average = renderMs;
+    haveAverage = true;
+  }
+  else
+  {
+    average += (renderMs - average) * SMOOTHING;
+  }
+
+  if (!isEnabled())
+  {
+    return false;
+  }
+  if (settleFrames > 0)
+  {
+    settleFrames--;
+    return false;
+  }
+
+  // fill cost grows with the area, assume all of the time does so the
+  // prediction errs on the side of staying down
+  const float up = std::min(1.0f, snap(scale + STEP));
+  const float predicted = average * (up * up) / (scale * scale);
+  if (average > budget)
+  {
+    framesOver++;
+    framesUnder = 0;
+  }
+  else if (scale < 1.0f && predicted < budget * UP_HEADROOM)
+  {
+    framesUnder++;
+    framesOver = 0;
+  }
+  else
+  {
+    framesOver = 0;
+    framesUnder = 0;
+  }
+
+  float next = scale;
+  if (framesOver >= DOWN_FRAMES)
+  {
+    next = std::max(minScale, snap(scale - STEP));
+  }
+  else if (framesUnder >= UP_FRAMES)
+  {
+    next = up;
+  }
+  if (next == scale)
+  {
+    return false;
+  }
+
+  Log::debug(
+    TAG,
+    "Render scale %.0f%% -> %.0f%%, averaging %.2fms for a %.2fms budget",
+    scale * 100.0f,
+    next * 100.0f,
+    average,
+    budget
+    );
+  scale = next;
+  framesOver = 0;
+  framesUnder = 0;
+  settleFrames = SETTLE_FRAMES;
+  changes++;
+  return true;
+}
+
+bool DynamicResolution::isEnabled() const
+{
+  return budget > 0.0f && minScale < 1.0f;
+}
+
+float DynamicResolution::getScale() const
+{
+  return scale;
+}
+
+float DynamicResolution::getAverageTime() const
+{
+  return average;
+}
+
+unsigned DynamicResolution::getChangeCount() const
+{
+  return changes;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Picks the fraction of the full resolution to render at from how long
+ * frames take to render. The scale drops quickly when the budget is blown and
+ * only comes back up after frames have been comfortably under budget for a
+ * while, and every change is followed by a settling period, so the
+ * resolution doesn't bounce between two steps.
+ */
+class DynamicResolution
+{
+private:
+  static const std::string TAG;
+
+  // render time budget in ms, 0 keeps the full resolution
+  float budget;
+  float minScale;
+  float scale;
+  // smoothed render time
+  float average;
+  bool haveAverage;
+  // consecutive frames over budget / with room for the next step up
+  unsigned framesOver;
+  unsigned framesUnder;
+  // frames left before the average reflects the current scale
+  unsigned settleFrames;
+  unsigned changes;
+
+public:
+  // how much the scale changes in one step
+  static constexpr float STEP = 0.1f;
+
+  DynamicResolution();
+
+  /**
+   * @param budgetMs Render time to stay under, 0 to disable scaling.
+   * @param _minScale Lowest fraction of the full resolution to render at.
+   */
+  void initialize(const float budgetMs, const float _minScale);
+
+  /**
+   * Feeds the time the last frame took to render.
+   * @return true if the scale changed.
+   */
+  bool update(const float renderMs);
+
+  bool isEnabled() const;
+  // fraction of the full width and height to render at
+  float getScale() const;
+  // smoothed render time in ms
+  float getAverageTime() const;
+  // number of times the scale has changed
+  unsigned getChangeCount() const;
+};
\ No newline at end of file
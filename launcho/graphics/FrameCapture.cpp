@@ -0,0 +1,382 @@
+#include "FrameCapture.h"
+#include "utility/Log.h"
+#include "utility/Lz.h"
+#include "utility/Timer.h"
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+const std::string FrameCapture::TAG = "FrameCapture";
+
+// stream files start with this, then the version, width and height
+static const char STREAM_MAGIC[4] = { 'L', 'C', 'A', 'P' };
+static const uint32_t STREAM_VERSION = 1;
+
+static bool writeU32(std::FILE* file, const uint32_t value)
+{
+  const uint8_t bytes[4] = {
+    static_cast<uint8_t>(value),
+    static_cast<uint8_t>(value >> 8),
+    static_cast<uint8_t>(value >> 16),
+    static_cast<uint8_t>(value >> 24)
+  };
+  return std::fwrite(bytes, 1, 4, file) == 4;
+}
+
+static bool readU32(std::FILE* file, uint32_t& value)
+{
+  uint8_t bytes[4];
+  if (std::fread(bytes, 1, 4, file) != 4)
+  {
+    return false;
+  }
+  value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) |
+          (static_cast<uint32_t>(bytes[3]) << 24);
+  return true;
+}
+
+FrameCapture::FrameCapture()
+: width(0),
+  height(0),
+  prefix(),
+  png(false),
+  interval(1),
+  pool(),
+  mutex(),
+  wake(),
+  freeFrames(),
+  queued(),
+  stopping(false),
+  encoder(),
+  stream(nullptr),
+  ordered(),
+  previous(),
+  delta(),
+  compressed(),
+  rawBytes(0),
+  compressedBytes(0),
+  failedWrites(0),
+  captured(0),
+  dropped(0),
+  submitTime(0.0f)
+{
+}
+
+FrameCapture::~FrameCapture()
+{
+  destroy();
+}
+
+void FrameCapture::initialize(const unsigned _width, const unsigned _height,
+                              const std::string& _prefix,
+                              const std::string& format,
+                              const uint32_t _interval,
+                              const unsigned bufferCount)
+{
+  assert(!encoder.joinable());
+  width = _width;
+  height = _height;
+  prefix = _prefix;
+  png = format == "png";
+  interval = std::max(1u, _interval);
+  if (prefix.empty())
+  {
+    return;
+  }
+
+  if (!png)
+  {
+    const std::string filename = prefix + ".lzc";
+    stream = std::fopen(filename.c_str(), "wb");
+    if (stream == nullptr)
+    {
+      Log::error(
+        TAG,
+        "Could not open %s, capture disabled",
+        filename.c_str()
+        );
+      prefix.clear();
+      return;
+    }
+    std::fwrite(STREAM_MAGIC, 1, sizeof(STREAM_MAGIC), stream);
+    writeU32(stream, STREAM_VERSION);
+    writeU32(stream, width);
+    writeU32(stream, height);
+    previous.assign(width * height * 4, 0);
+  }
+
+  pool.resize(std::max(1u, bufferCount));
+  for (auto& frame : pool)
+  {
+    frame.pixels.resize(width * height * 4);
+    freeFrames.push_back(&frame);
+  }
+  stopping = false;
+  encoder = std::thread(&FrameCapture::encodeLoop, this);
+
+  Log::debug(
+    TAG,
+    "Capturing every %u frames to %s%s with %u buffers",
+    interval,
+    prefix.c_str(),
+    png ? "*.png" : ".lzc",
+    static_cast<unsigned>(pool.size())
+    );
+}
+
+void FrameCapture::destroy()
+{
+  if (!encoder.joinable())
+  {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_one();
+  encoder.join();
+
+  if (stream != nullptr)
+  {
+    std::fclose(stream);
+    stream = nullptr;
+  }
+
+  Log::info(
+    TAG,
+    "Captured %u frames, dropped %u, %.3fms average to submit",
+    captured,
+    dropped,
+    captured > 0 ? submitTime / captured : 0.0f
+    );
+  if (failedWrites > 0)
+  {
+    Log::error(TAG, "%u frames could not be written", failedWrites.load());
+  }
+  if (!png && compressedBytes > 0)
+  {
+    Log::info(
+      TAG,
+      "Stream compressed %.1f:1",
+      static_cast<double>(rawBytes) / compressedBytes
+      );
+  }
+
+  pool.clear();
+  freeFrames.clear();
+  queued.clear();
+  prefix.clear();
+}
+
+bool FrameCapture::isEnabled() const
+{
+  return !prefix.empty();
+}
+
+bool FrameCapture::wantsFrame(const uint32_t frameNumber) const
+{
+  return isEnabled() && (frameNumber % interval) == 0;
+}
+
+bool FrameCapture::submit(const uint8_t* pixels, const bool bottomUp,
+                          const uint32_t frameNumber)
+{
+  Timer timer(true);
+
+  Frame* frame = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!freeFrames.empty())
+    {
+      frame = freeFrames.back();
+      freeFrames.pop_back();
+    }
+  }
+  if (frame == nullptr)
+  {
+    dropped++;
+    Log::verbose(TAG, "Dropped frame %u, encoder is behind", frameNumber);
+    return false;
+  }
+
+  // the copy is the only real work done on the caller's thread
+  std::memcpy(frame->pixels.data(), pixels, frame->pixels.size());
+  frame->number = frameNumber;
+  frame->bottomUp = bottomUp;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queued.push_back(frame);
+  }
+  wake.notify_one();
+
+  captured++;
+  submitTime += timer.elapsedMilliF();
+  return true;
+}
+
+unsigned FrameCapture::getCapturedCount() const
+{
+  return captured;
+}
+
+unsigned FrameCapture::getDroppedCount() const
+{
+  return dropped;
+}
+
+bool FrameCapture::extract(const std::string& filename,
+                           const std::string& outPrefix)
+{
+  std::FILE* file = std::fopen(filename.c_str(), "rb");
+  if (file == nullptr)
+  {
+    Log::error(TAG, "Could not open %s", filename.c_str());
+    return false;
+  }
+
+  char magic[4];
+  uint32_t version = 0;
+  uint32_t w = 0;
+  uint32_t h = 0;
+  if (std::fread(magic, 1, 4, file) != 4 ||
+      std::memcmp(magic, STREAM_MAGIC, 4) != 0 ||
+      !readU32(file, version) || version != STREAM_VERSION ||
+      !readU32(file, w) || !readU32(file, h))
+  {
+    Log::error(TAG, "%s is not a capture stream", filename.c_str());
+    std::fclose(file);
+    return false;
+  }
+
+  std::vector<uint8_t> image(w * h * 4, 0);
+  std::vector<uint8_t> data;
+  std::vector<uint8_t> frameDelta;
+  uint32_t number;
+  uint32_t size;
+  unsigned count = 0;
+  bool ok = true;
+  while (readU32(file, number))
+  {
+    if (!readU32(file, size))
+    {
+      ok = false;
+      break;
+    }
+    data.resize(size);
+    if (std::fread(data.data(), 1, size, file) != size ||
+        !lzDecompress(data.data(), size, frameDelta) ||
+        frameDelta.size() != image.size())
+    {
+      ok = false;
+      break;
+    }
+
+    for (std::size_t i = 0; i < image.size(); i++)
+    {
+      image[i] ^= frameDelta[i];
+    }
+
+    char out[256];
+    snprintf(out, sizeof(out), "%s%06u.png", outPrefix.c_str(), number);
+    sf::Image png;
+    png.create(w, h, image.data());
+    if (!png.saveToFile(out))
+    {
+      Log::error(TAG, "Could not write %s", out);
+    }
+    count++;
+  }
+  std::fclose(file);
+
+  if (!ok)
+  {
+    Log::error(TAG, "%s is truncated or corrupt", filename.c_str());
+  }
+  Log::info(TAG, "Extracted %u frames from %s", count, filename.c_str());
+  return ok;
+}
+
+void FrameCapture::encodeLoop()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    wake.wait(lock, [this] { return stopping || !queued.empty(); });
+    if (queued.empty())
+    {
+      // stopping and everything has been written
+      return;
+    }
+
+    Frame* frame = queued.front();
+    queued.pop_front();
+    lock.unlock();
+    encode(*frame);
+    lock.lock();
+    freeFrames.push_back(frame);
+  }
+}
+
+void FrameCapture::encode(Frame& frame)
+{
+  // put the rows top first
+  const uint8_t* pixels = frame.pixels.data();
+  if (frame.bottomUp)
+  {
+    const std::size_t rowBytes = width * 4;
+    ordered.resize(frame.pixels.size());
+    for (unsigned y = 0; y < height; y++)
+    {
+      std::memcpy(
+        &ordered[y * rowBytes],
+        &frame.pixels[(height - 1 - y) * rowBytes],
+        rowBytes
+        );
+    }
+    pixels = ordered.data();
+  }
+
+  if (png)
+  {
+    char filename[256];
+    snprintf(
+      filename,
+      sizeof(filename),
+      "%s%06u.png",
+      prefix.c_str(),
+      frame.number
+      );
+    sf::Image image;
+    image.create(width, height, pixels);
+    if (!image.saveToFile(filename))
+    {
+      failedWrites++;
+    }
+    return;
+  }
+
+  // consecutive frames are mostly the same, so the difference is mostly
+  // zeros and compresses far better than the frame itself
+  delta.resize(previous.size());
+  for (std::size_t i = 0; i < delta.size(); i++)
+  {
+    delta[i] = pixels[i] ^ previous[i];
+  }
+  std::memcpy(previous.data(), pixels, previous.size());
+
+  lzCompress(delta.data(), delta.size(), compressed);
+  const bool written =
+    writeU32(stream, frame.number) &&
+    writeU32(stream, static_cast<uint32_t>(compressed.size())) &&
+    std::fwrite(compressed.data(), 1, compressed.size(), stream) ==
+      compressed.size();
+  if (!written)
+  {
+    failedWrites++;
+  }
+  rawBytes += delta.size();
+  compressedBytes += compressed.size();
+}
\ No newline at end of file
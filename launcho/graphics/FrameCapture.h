@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Records frames to disk without holding up the main loop. Submitting a frame
+ * only copies its pixels into a free buffer from a small pool, and a
+ * background thread does the encoding and writing. If the encoder falls
+ * behind and every buffer is in use the frame is dropped rather than waiting.
+ * Frames are either written as one PNG each, or appended to a single stream
+ * file where each frame is the difference from the previous one, compressed
+ * with lzCompress(). Streams are turned back into PNGs with extract().
+ */
+class FrameCapture
+{
+private:
+  static const std::string TAG;
+
+  struct Frame
+  {
+    std::vector<uint8_t> pixels;
+    uint32_t number;
+    // rows are stored bottom up, as OpenGL reads them
+    bool bottomUp;
+  };
+
+  unsigned width;
+  unsigned height;
+  // empty when capture is disabled
+  std::string prefix;
+  bool png;
+  // capture every nth frame
+  uint32_t interval;
+
+  std::vector<Frame> pool;
+  std::mutex mutex;
+  // signals the encoder that a frame was queued or capture is stopping
+  std::condition_variable wake;
+  std::vector<Frame*> freeFrames;
+  std::deque<Frame*> queued;
+  bool stopping;
+  std::thread encoder;
+
+  // only touched by the encoder thread
+  std::FILE* stream;
+  // top row first, the last frame written to the stream
+  std::vector<uint8_t> ordered;
+  std::vector<uint8_t> previous;
+  std::vector<uint8_t> delta;
+  std::vector<uint8_t> compressed;
+  uint64_t rawBytes;
+  uint64_t compressedBytes;
+  // the log isn't thread safe, failures are reported when capture stops
+  std::atomic<unsigned> failedWrites;
+
+  // only touched by the submitting thread
+  unsigned captured;
+  unsigned dropped;
+  float submitTime;
+
+public:
+  FrameCapture();
+  ~FrameCapture();
+  FrameCapture(const FrameCapture&) = delete;
+  FrameCapture& operator=(const FrameCapture&) = delete;
+
+  /**
+   * Allocates the buffers and starts the encoder.
+   * @param _prefix Start of the output file names, empty disables capture.
+   * @param format "png" for a file per frame, or "lz" for a single stream.
+   * @param _interval Capture every nth frame.
+   * @param bufferCount Frames that can wait for the encoder at once.
+   */
+  void initialize(const unsigned _width, const unsigned _height,
+                  const std::string& _prefix, const std::string& format,
+                  const uint32_t _interval, const unsigned bufferCount);
+
+  /**
+   * Encodes whatever is still queued, then stops the encoder.
+   */
+  void destroy();
+
+  bool isEnabled() const;
+
+  /**
+   * Checks if a frame falls on the capture interval.
+   */
+  bool wantsFrame(const uint32_t frameNumber) const;
+
+  /**
+   * Copies a frame and queues it for the encoder.
+   * @param pixels RGBA, width * height * 4 bytes.
+   * @param bottomUp True if the last row comes first.
+   * @return false if the frame was dropped.
+   */
+  bool submit(const uint8_t* pixels, const bool bottomUp,
+              const uint32_t frameNumber);
+
+  unsigned getCapturedCount() const;
+  unsigned getDroppedCount() const;
+
+  /**
+   * Writes every frame of a stream as a PNG.
+   * @param filename The stream file.
+   * @param outPrefix Start of the PNG file names.
+   * @return false if the stream couldn't be read.
+   */
+  static bool extract(const std::string& filename,
+                      const std::string& outPrefix);
+
+private:
+  void encodeLoop();
+  // writes a frame as a PNG or appends it to the stream
+  void encode(Frame& frame);
+};
\ No newline at end of file
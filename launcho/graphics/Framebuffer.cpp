@@ -0,0 +1,404 @@
+#include "Framebuffer.h"
+#include "math/BatchMath.h"
+#include "utility/CpuFeatures.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+
+#if LAUNCHO_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+/****************************************************************************
+ * Span kernels
+ *
+ * Translucent pixels are blended as (src * a + dst * (256 - a)) >> 8 per
+ * channel, with a scaled to [0, 256] so that opaque colors are exact. Every
+ * path uses the same integer math so the output doesn't depend on the
+ * processor.
+ ****************************************************************************/
+
+static void fillScalar(uint32_t* dst, const int n, const uint32_t color)
+{
+  for (int i = 0; i < n; i++)
+  {
+    dst[i] = color;
+  }
+}
+
+static uint32_t blendPixel(const uint32_t dst, const uint32_t color,
+                           const uint32_t alpha)
+{
+  const uint32_t inverse = 256 - alpha;
+  uint32_t result = 0;
+  for (int shift = 0; shift < 32; shift += 8)
+  {
+    const uint32_t s = (color >> shift) & 0xFF;
+    const uint32_t d = (dst >> shift) & 0xFF;
+    result |= (((s * alpha) + (d * inverse)) >> 8) << shift;
+  }
+  return result;
+}
+
+static void blendScalar(uint32_t* dst, const int n, const uint32_t color,
+                        const uint32_t alpha)
+{
+  for (int i = 0; i < n; i++)
+  {
+    dst[i] = blendPixel(dst[i], color, alpha);
+  }
+}
+
+#if LAUNCHO_X86
+
+static void fillSse2(uint32_t* dst, const int n, const uint32_t color)
+{
+  const __m128i c = _mm_set1_epi32(static_cast<int>(color));
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), c);
+  }
+  fillScalar(dst + i, n - i, color);
+}
+
+static void blendSse2(uint32_t* dst, const int n, const uint32_t color,
+                      const uint32_t alpha)
+{
+  const __m128i zero = _mm_setzero_si128();
+  // src * alpha doesn't change over the span
+  const __m128i src = _mm_mullo_epi16(
+    _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color)), zero),
+    _mm_set1_epi16(static_cast<short>(alpha))
+    );
+  const __m128i inverse = _mm_set1_epi16(static_cast<short>(256 - alpha));
+
+  int i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    __m128i* p = reinterpret_cast<__m128i*>(dst + i);
+    const __m128i d = _mm_loadu_si128(p);
+    __m128i lo = _mm_unpacklo_epi8(d, zero);
+    __m128i hi = _mm_unpackhi_epi8(d, zero);
+    lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(lo, inverse), src), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(hi, inverse), src), 8);
+    _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+  }
+  blendScalar(dst + i, n - i, color, alpha);
+}
+
+LAUNCHO_TARGET_AVX2
+static void fillAvx2(uint32_t* dst, const int n, const uint32_t color)
+{
+  const __m256i c = _mm256_set1_epi32(static_cast<int>(color));
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), c);
+  }
+  _mm256_zeroupper();
+  fillScalar(dst + i, n - i, color);
+}
+
+LAUNCHO_TARGET_AVX2
+static void blendAvx2(uint32_t* dst, const int n, const uint32_t color,
+                      const uint32_t alpha)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i src = _mm256_mullo_epi16(
+    _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(color)), zero),
+    _mm256_set1_epi16(static_cast<short>(alpha))
+    );
+  const __m256i inverse = _mm256_set1_epi16(static_cast<short>(256 - alpha));
+
+  int i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    __m256i* p = reinterpret_cast<__m256i*>(dst + i);
+    const __m256i d = _mm256_loadu_si256(p);
+    // unpacking works within each 128 bit lane and packing undoes it the
+    // same way, so pixels end up back where they started
+    __m256i lo = _mm256_unpacklo_epi8(d, zero);
+    __m256i hi = _mm256_unpackhi_epi8(d, zero);
+    lo = _mm256_srli_epi16(
+      _mm256_add_epi16(_mm256_mullo_epi16(lo, inverse), src), 8);
+    hi = _mm256_srli_epi16(
+      _mm256_add_epi16(_mm256_mullo_epi16(hi, inverse), src), 8);
+    _mm256_storeu_si256(p, _mm256_packus_epi16(lo, hi));
+  }
+  _mm256_zeroupper();
+  blendScalar(dst + i, n - i, color, alpha);
+}
+
+#endif // LAUNCHO_X86
+
+static void fill(uint32_t* dst, const int n, const uint32_t color)
+{
+  switch (BatchMath::getPath())
+  {
+#if LAUNCHO_X86
+  case SimdPath::Avx2:
+    fillAvx2(dst, n, color);
+    break;
+
+  case SimdPath::Sse2:
+    fillSse2(dst, n, color);
+    break;
+#endif
+
+  default:
+    fillScalar(dst, n, color);
+    break;
+  }
+}
+
+static void blend(uint32_t* dst, const int n, const uint32_t color,
+                  const uint32_t alpha)
+{
+  switch (BatchMath::getPath())
+  {
+#if LAUNCHO_X86
+  case SimdPath::Avx2:
+    blendAvx2(dst, n, color, alpha);
+    break;
+
+  case SimdPath::Sse2:
+    blendSse2(dst, n, color, alpha);
+    break;
+#endif
+
+  default:
+    blendScalar(dst, n, color, alpha);
+    break;
+  }
+}
+
+/****************************************************************************
+ * Framebuffer
+ ****************************************************************************/
+
+uint32_t Framebuffer::pack(const sf::Color& color)
+{
+  return static_cast<uint32_t>(color.r) |
+         (static_cast<uint32_t>(color.g) << 8) |
+         (static_cast<uint32_t>(color.b) << 16) |
+         (static_cast<uint32_t>(color.a) << 24);
+}
+
+Framebuffer::Framebuffer(const unsigned _width, const unsigned _height)
+: width(_width),
+  height(_height),
+  pixels(_width * _height)
+{
+}
+
+unsigned Framebuffer::getWidth() const
+{
+  return width;
+}
+
+unsigned Framebuffer::getHeight() const
+{
+  return height;
+}
+
+const uint32_t* Framebuffer::getPixels() const
+{
+  return pixels.data();
+}
+
+uint32_t Framebuffer::getPixel(const unsigned x, const unsigned y) const
+{
+  assert(x < width && y < height);
+  return pixels[(y * width) + x];
+}
+
+void Framebuffer::clear(const sf::Color& color)
+{
+  fill(pixels.data(), static_cast<int>(pixels.size()), pack(color));
+}
+
+void Framebuffer::fillSpan(const int y, const int x0, const int x1,
+                           const sf::Color& color)
+{
+  assert(y >= 0 && y < static_cast<int>(height));
+  assert(x0 >= 0 && x1 <= static_cast<int>(width));
+  if (x1 <= x0 || color.a == 0)
+  {
+    return;
+  }
+
+  uint32_t* row = pixels.data() + (y * width) + x0;
+  if (color.a == 255)
+  {
+    fill(row, x1 - x0, pack(color));
+  }
+  else
+  {
+    blend(row, x1 - x0, pack(color), color.a + (color.a >> 7));
+  }
+}
+
+void Framebuffer::drawQuad(const sf::Vertex* quad, const sf::Image* texture)
+{
+  float minY = quad[0].position.y;
+  float maxY = quad[0].position.y;
+  for (int i = 1; i < 4; i++)
+  {
+    minY = std::min(minY, quad[i].position.y);
+    maxY = std::max(maxY, quad[i].position.y);
+  }
+
+  // rows whose centers are inside the quad
+  const int yStart = std::max(0, static_cast<int>(std::ceil(minY - 0.5f)));
+  const int yEnd = std::min(
+    static_cast<int>(height),
+    static_cast<int>(std::ceil(maxY - 0.5f))
+    );
+
+  // texture coordinates are an affine function of the position, found from
+  // the two edges leaving the first corner
+  float uX = 0.0f, uY = 0.0f, uC = 0.0f;
+  float vX = 0.0f, vY = 0.0f, vC = 0.0f;
+  if (texture != nullptr)
+  {
+    const sf::Vector2f p0 = quad[0].position;
+    const sf::Vector2f e1 = quad[1].position - p0;
+    const sf::Vector2f e2 = quad[3].position - p0;
+    const float det = (e1.x * e2.y) - (e1.y * e2.x);
+    if (std::fabs(det) < 1e-6f)
+    {
+      return;
+    }
+    const sf::Vector2f t0 = quad[0].texCoords;
+    const sf::Vector2f t1 = quad[1].texCoords - t0;
+    const sf::Vector2f t2 = quad[3].texCoords - t0;
+    // s = (dx * e2.y - dy * e2.x) / det, t = (e1.x * dy - e1.y * dx) / det
+    const float sX = e2.y / det, sY = -e2.x / det;
+    const float tX = -e1.y / det, tY = e1.x / det;
+    uX = (sX * t1.x) + (tX * t2.x);
+    uY = (sY * t1.x) + (tY * t2.x);
+    vX = (sX * t1.y) + (tX * t2.y);
+    vY = (sY * t1.y) + (tY * t2.y);
+    uC = t0.x - (uX * p0.x) - (uY * p0.y);
+    vC = t0.y - (vX * p0.x) - (vY * p0.y);
+  }
+
+  for (int y = yStart; y < yEnd; y++)
+  {
+    const float centerY = y + 0.5f;
+    float left = static_cast<float>(width);
+    float right = 0.0f;
+    bool hit = false;
+    for (int i = 0; i < 4; i++)
+    {
+      const sf::Vector2f& a = quad[i].position;
+      const sf::Vector2f& b = quad[(i + 1) % 4].position;
+      // half open so a shared vertex is only counted once
+      if ((a.y <= centerY && centerY < b.y) ||
+          (b.y <= centerY && centerY < a.y))
+      {
+        const float x = a.x + ((centerY - a.y) * (b.x - a.x) / (b.y - a.y));
+        left = std::min(left, x);
+        right = std::max(right, x);
+        hit = true;
+      }
+    }
+    if (!hit)
+    {
+      continue;
+    }
+
+    const int x0 = std::max(0, static_cast<int>(std::ceil(left - 0.5f)));
+    const int x1 = std::min(
+      static_cast<int>(width),
+      static_cast<int>(std::ceil(right - 0.5f))
+      );
+    if (texture == nullptr)
+    {
+      fillSpan(y, x0, x1, quad[0].color);
+    }
+    else
+    {
+      const float centerX = x0 + 0.5f;
+      drawTexturedSpan(
+        y, x0, x1, *texture, quad[0].color,
+        (uX * centerX) + (uY * centerY) + uC,
+        (vX * centerX) + (vY * centerY) + vC,
+        uX, vX
+        );
+    }
+  }
+}
+
+void Framebuffer::drawTexturedSpan(const int y, const int x0, const int x1,
+                                   const sf::Image& texture,
+                                   const sf::Color& tint, float u, float v,
+                                   const float du, const float dv)
+{
+  const sf::Vector2u size = texture.getSize();
+  const uint8_t* texels = texture.getPixelsPtr();
+  uint32_t* row = pixels.data() + (y * width);
+
+  for (int x = x0; x < x1; x++, u += du, v += dv)
+  {
+    const unsigned tx = std::min(
+      size.x - 1, static_cast<unsigned>(std::max(0.0f, u)));
+    const unsigned ty = std::min(
+      size.y - 1, static_cast<unsigned>(std::max(0.0f, v)));
+    const uint8_t* texel = texels + (((ty * size.x) + tx) * 4);
+
+    // tint like SFML does, by multiplying each channel
+    const sf::Color color(
+      static_cast<sf::Uint8>((texel[0] * tint.r) / 255),
+      static_cast<sf::Uint8>((texel[1] * tint.g) / 255),
+      static_cast<sf::Uint8>((texel[2] * tint.b) / 255),
+      static_cast<sf::Uint8>((texel[3] * tint.a) / 255)
+      );
+    if (color.a == 255)
+    {
+      row[x] = pack(color);
+    }
+    else if (color.a != 0)
+    {
+      row[x] = blendPixel(row[x], pack(color), color.a + (color.a >> 7));
+    }
+  }
+}
+
+bool Framebuffer::savePPM(const std::string& filename) const
+{
+  std::ofstream out(filename.c_str(), std::ios::binary);
+  if (!out)
+  {
+    return false;
+  }
+
+  out << "P6\n" << width << " " << height << "\n255\n";
+  std::vector<char> rgb(width * 3);
+  for (unsigned y = 0; y < height; y++)
+  {
+    for (unsigned x = 0; x < width; x++)
+    {
+      const uint32_t pixel = pixels[(y * width) + x];
+      rgb[(x * 3) + 0] = static_cast<char>(pixel & 0xFF);
+      rgb[(x * 3) + 1] = static_cast<char>((pixel >> 8) & 0xFF);
+      rgb[(x * 3) + 2] = static_cast<char>((pixel >> 16) & 0xFF);
+    }
+    out.write(rgb.data(), rgb.size());
+  }
+  return out.good();
+}
+
+bool Framebuffer::savePNG(const std::string& filename) const
+{
+  sf::Image image;
+  image.create(
+    width,
+    height,
+    reinterpret_cast<const sf::Uint8*>(pixels.data())
+    );
+  return image.saveToFile(filename);
+}
\ No newline at end of file
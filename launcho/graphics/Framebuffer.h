@@ -0,0 +1,59 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * 32 bit RGBA image in system memory for the software renderer. Pixels use
+ * the same byte order as sf::Image so they can be saved without converting.
+ * Spans are filled with the SIMD path BatchMath has selected.
+ */
+class Framebuffer
+{
+private:
+  unsigned width;
+  unsigned height;
+  std::vector<uint32_t> pixels;
+
+public:
+  // packs a color in the framebuffer's pixel format
+  static uint32_t pack(const sf::Color& color);
+
+  Framebuffer(const unsigned _width, const unsigned _height);
+
+  unsigned getWidth() const;
+  unsigned getHeight() const;
+  const uint32_t* getPixels() const;
+  uint32_t getPixel(const unsigned x, const unsigned y) const;
+
+  void clear(const sf::Color& color);
+
+  /**
+   * Fills pixels [x0, x1) of row y with a color, blending when the color is
+   * translucent. The span must already be clipped to the framebuffer.
+   */
+  void fillSpan(const int y, const int x0, const int x1,
+                const sf::Color& color);
+
+  /**
+   * Rasterizes a convex quad, such as the ones render components append to
+   * batches. Positions are in pixels and pixel centers are sampled, so quads
+   * that share an edge never overlap or leave gaps.
+   * @param quad Four vertices in order around the quad. The quad is drawn
+   * with the color of the first vertex.
+   * @param texture Sampled with the vertex texture coordinates (nearest
+   * texel) and tinted by the color, nullptr for a solid quad.
+   */
+  void drawQuad(const sf::Vertex* quad, const sf::Image* texture);
+
+  // image dumps
+  bool savePPM(const std::string& filename) const;
+  bool savePNG(const std::string& filename) const;
+
+private:
+  void drawTexturedSpan(const int y, const int x0, const int x1,
+                        const sf::Image& texture, const sf::Color& tint,
+                        float u, float v, const float du, const float dv);
+};
\ No newline at end of file
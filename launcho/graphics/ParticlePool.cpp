@@ -0,0 +1,315 @@
+#include "ParticlePool.h"
+#include "math/BatchMath.h"
+#include "utility/CpuFeatures.h"
+#include <cassert>
+
+#if LAUNCHO_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+/****************************************************************************
+ * Kernels
+ *
+ * Integration moves, accelerates and ages every particle. Removal walks the
+ * pool from the back, so the particle swapped into a dead one's place has
+ * always been checked already. The SIMD paths test a whole block of ages at
+ * once and only drop to scalar code for blocks that have a dead particle.
+ ****************************************************************************/
+
+// raw pointers into the pool's arrays
+struct PoolPtrs
+{
+  float* x;
+  float* y;
+  float* vx;
+  float* vy;
+  float* age;
+  float* lifetime;
+};
+
+static void integrateScalar(const PoolPtrs& p, const std::size_t begin,
+                            const std::size_t n, const float dt,
+                            const Vector2& accel)
+{
+  for (std::size_t i = begin; i < n; i++)
+  {
+    p.x[i] += p.vx[i] * dt;
+    p.y[i] += p.vy[i] * dt;
+    p.vx[i] += accel.x * dt;
+    p.vy[i] += accel.y * dt;
+    p.age[i] += dt;
+  }
+}
+
+static void swapRemove(const PoolPtrs& p, const std::size_t i,
+                       std::size_t& count)
+{
+  count--;
+  p.x[i] = p.x[count];
+  p.y[i] = p.y[count];
+  p.vx[i] = p.vx[count];
+  p.vy[i] = p.vy[count];
+  p.age[i] = p.age[count];
+  p.lifetime[i] = p.lifetime[count];
+}
+
+// removes dead particles in [begin, end), everything past end is alive
+static void removeDeadScalar(const PoolPtrs& p, const std::size_t begin,
+                             const std::size_t end, std::size_t& count)
+{
+  for (std::size_t i = end; i > begin; i--)
+  {
+    if (p.age[i - 1] >= p.lifetime[i - 1])
+    {
+      swapRemove(p, i - 1, count);
+    }
+  }
+}
+
+// removes the dead particles flagged in mask from a block starting at base
+static void removeMasked(const PoolPtrs& p, const std::size_t base, int mask,
+                         const int lanes, std::size_t& count)
+{
+  for (int lane = lanes - 1; lane >= 0; lane--)
+  {
+    if ((mask >> lane) & 1)
+    {
+      swapRemove(p, base + lane, count);
+    }
+  }
+}
+
+#if LAUNCHO_X86
+
+static void integrateSse2(const PoolPtrs& p, const std::size_t n,
+                          const float dt, const Vector2& accel)
+{
+  const __m128 vdt = _mm_set1_ps(dt);
+  const __m128 dvx = _mm_set1_ps(accel.x * dt);
+  const __m128 dvy = _mm_set1_ps(accel.y * dt);
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m128 vx = _mm_loadu_ps(p.vx + i);
+    const __m128 vy = _mm_loadu_ps(p.vy + i);
+    _mm_storeu_ps(p.x + i, _mm_add_ps(_mm_loadu_ps(p.x + i),
+                                      _mm_mul_ps(vx, vdt)));
+    _mm_storeu_ps(p.y + i, _mm_add_ps(_mm_loadu_ps(p.y + i),
+                                      _mm_mul_ps(vy, vdt)));
+    _mm_storeu_ps(p.vx + i, _mm_add_ps(vx, dvx));
+    _mm_storeu_ps(p.vy + i, _mm_add_ps(vy, dvy));
+    _mm_storeu_ps(p.age + i, _mm_add_ps(_mm_loadu_ps(p.age + i), vdt));
+  }
+  integrateScalar(p, i, n, dt, accel);
+}
+
+static void removeDeadSse2(const PoolPtrs& p, std::size_t& count)
+{
+  const std::size_t blocks = count / 4;
+  removeDeadScalar(p, blocks * 4, count, count);
+  for (std::size_t b = blocks; b > 0; b--)
+  {
+    const std::size_t base = (b - 1) * 4;
+    const int mask = _mm_movemask_ps(_mm_cmpge_ps(
+      _mm_loadu_ps(p.age + base),
+      _mm_loadu_ps(p.lifetime + base)
+      ));
+    if (mask != 0)
+    {
+      removeMasked(p, base, mask, 4, count);
+    }
+  }
+}
+
+LAUNCHO_TARGET_AVX2
+static void integrateAvx2(const PoolPtrs& p, const std::size_t n,
+                          const float dt, const Vector2& accel)
+{
+  const __m256 vdt = _mm256_set1_ps(dt);
+  const __m256 dvx = _mm256_set1_ps(accel.x * dt);
+  const __m256 dvy = _mm256_set1_ps(accel.y * dt);
+
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256 vx = _mm256_loadu_ps(p.vx + i);
+    const __m256 vy = _mm256_loadu_ps(p.vy + i);
+    // a fused multiply add would round differently from the other paths
+    _mm256_storeu_ps(p.x + i, _mm256_add_ps(_mm256_loadu_ps(p.x + i),
+                                            _mm256_mul_ps(vx, vdt)));
+    _mm256_storeu_ps(p.y + i, _mm256_add_ps(_mm256_loadu_ps(p.y + i),
+                                            _mm256_mul_ps(vy, vdt)));
+    _mm256_storeu_ps(p.vx + i, _mm256_add_ps(vx, dvx));
+    _mm256_storeu_ps(p.vy + i, _mm256_add_ps(vy, dvy));
+    _mm256_storeu_ps(p.age + i, _mm256_add_ps(_mm256_loadu_ps(p.age + i),
+                                              vdt));
+  }
+  _mm256_zeroupper();
+  integrateScalar(p, i, n, dt, accel);
+}
+
+LAUNCHO_TARGET_AVX2
+static void removeDeadAvx2(const PoolPtrs& p, std::size_t& count)
+{
+  const std::size_t blocks = count / 8;
+  removeDeadScalar(p, blocks * 8, count, count);
+  for (std::size_t b = blocks; b > 0; b--)
+  {
+    const std::size_t base = (b - 1) * 8;
+    const int mask = _mm256_movemask_ps(_mm256_cmp_ps(
+      _mm256_loadu_ps(p.age + base),
+      _mm256_loadu_ps(p.lifetime + base),
+      _CMP_GE_OQ
+      ));
+    if (mask != 0)
+    {
+      removeMasked(p, base, mask, 8, count);
+    }
+  }
+  _mm256_zeroupper();
+}
+
+#endif // LAUNCHO_X86
+
+/****************************************************************************
+ * ParticlePool
+ ****************************************************************************/
+
+ParticlePool::ParticlePool(const std::size_t _capacity)
+: capacity(_capacity),
+  count(0),
+  x(_capacity),
+  y(_capacity),
+  vx(_capacity),
+  vy(_capacity),
+  age(_capacity),
+  lifetime(_capacity)
+{
+}
+
+std::size_t ParticlePool::size() const
+{
+  return count;
+}
+
+std::size_t ParticlePool::getCapacity() const
+{
+  return capacity;
+}
+
+bool ParticlePool::full() const
+{
+  return count == capacity;
+}
+
+void ParticlePool::clear()
+{
+  count = 0;
+}
+
+bool ParticlePool::add(const Vector2& position, const Vector2& velocity,
+                       const float life)
+{
+  if (full())
+  {
+    return false;
+  }
+
+  x[count] = position.x;
+  y[count] = position.y;
+  vx[count] = velocity.x;
+  vy[count] = velocity.y;
+  age[count] = 0.0f;
+  lifetime[count] = life;
+  count++;
+  return true;
+}
+
+void ParticlePool::update(const float dt, const Vector2& acceleration)
+{
+  if (count == 0)
+  {
+    return;
+  }
+
+  const PoolPtrs p = { &x[0], &y[0], &vx[0], &vy[0], &age[0], &lifetime[0] };
+  switch (BatchMath::getPath())
+  {
+#if LAUNCHO_X86
+  case SimdPath::Avx2:
+    integrateAvx2(p, count, dt, acceleration);
+    removeDeadAvx2(p, count);
+    break;
+
+  case SimdPath::Sse2:
+    integrateSse2(p, count, dt, acceleration);
+    removeDeadSse2(p, count);
+    break;
+#endif
+
+  default:
+    integrateScalar(p, 0, count, dt, acceleration);
+    removeDeadScalar(p, 0, count, count);
+    break;
+  }
+}
+
+void ParticlePool::writeQuads(sf::Vertex* quads,
+                              const ParticleLook& look) const
+{
+  const float u0 = static_cast<float>(look.texRect.left);
+  const float v0 = static_cast<float>(look.texRect.top);
+  const float u1 = u0 + look.texRect.width;
+  const float v1 = v0 + look.texRect.height;
+  const float halfStart = look.startSize * 0.5f;
+  const float halfDelta = (look.endSize - look.startSize) * 0.5f;
+  const float r = look.startColor.r;
+  const float g = look.startColor.g;
+  const float b = look.startColor.b;
+  const float a = look.startColor.a;
+  const float dr = look.endColor.r - r;
+  const float dg = look.endColor.g - g;
+  const float db = look.endColor.b - b;
+  const float da = look.endColor.a - a;
+
+  // members are written directly, the SFML constructors aren't inline and
+  // calling them dominates the loop
+  for (std::size_t i = 0; i < count; i++)
+  {
+    const float t = age[i] / lifetime[i];
+    const float half = halfStart + (halfDelta * t);
+    const float left = x[i] - half;
+    const float right = x[i] + half;
+    const float top = y[i] + half;
+    const float bottom = y[i] - half;
+
+    sf::Vertex* quad = quads + (i * 4);
+    quad[0].position.x = left;
+    quad[0].position.y = top;
+    quad[1].position.x = right;
+    quad[1].position.y = top;
+    quad[2].position.x = right;
+    quad[2].position.y = bottom;
+    quad[3].position.x = left;
+    quad[3].position.y = bottom;
+    quad[0].texCoords.x = u0;
+    quad[0].texCoords.y = v0;
+    quad[1].texCoords.x = u1;
+    quad[1].texCoords.y = v0;
+    quad[2].texCoords.x = u1;
+    quad[2].texCoords.y = v1;
+    quad[3].texCoords.x = u0;
+    quad[3].texCoords.y = v1;
+
+    sf::Color& color = quad[0].color;
+    color.r = static_cast<sf::Uint8>(r + (dr * t));
+    color.g = static_cast<sf::Uint8>(g + (dg * t));
+    color.b = static_cast<sf::Uint8>(b + (db * t));
+    color.a = static_cast<sf::Uint8>(a + (da * t));
+    quad[1].color = color;
+    quad[2].color = color;
+    quad[3].color = color;
+  }
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "math/Vector2.h"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * How live particles are drawn, shared by every particle of an emitter.
+ * Size and color are interpolated over each particle's life.
+ */
+struct ParticleLook
+{
+  float startSize;
+  float endSize;
+  sf::Color startColor;
+  sf::Color endColor;
+  // pixel rectangle in the texture, ignored for untextured particles
+  sf::IntRect texRect;
+};
+
+/**
+ * Fixed capacity structure of arrays storage for particles. Live particles
+ * are kept packed at the front of the arrays, dead ones are removed by
+ * swapping the last live particle into their place, so order isn't kept.
+ * Updates run with the SIMD path selected by BatchMath.
+ */
+class ParticlePool
+{
+private:
+  std::size_t capacity;
+  std::size_t count;
+
+public:
+  // positions and velocities in world units, ages and lifetimes in seconds
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> vx;
+  std::vector<float> vy;
+  std::vector<float> age;
+  std::vector<float> lifetime;
+
+  explicit ParticlePool(const std::size_t _capacity);
+
+  std::size_t size() const;
+  std::size_t getCapacity() const;
+  bool full() const;
+  void clear();
+
+  /**
+   * Adds a particle.
+   * @return false if the pool is full.
+   */
+  bool add(const Vector2& position, const Vector2& velocity,
+           const float life);
+
+  /**
+   * Moves every particle, ages it and removes those that outlived their
+   * lifetime.
+   * @param dt Elapsed time in seconds.
+   * @param acceleration Applied to every particle, e.g. gravity.
+   */
+  void update(const float dt, const Vector2& acceleration);
+
+  /**
+   * Writes a quad per particle in world coordinates, with y up. The order is
+   * upper left, upper right, lower right, lower left, like render commands.
+   * @param quads[out] Room for 4 * size() vertices.
+   */
+  void writeQuads(sf::Vertex* quads, const ParticleLook& look) const;
+};
\ No newline at end of file
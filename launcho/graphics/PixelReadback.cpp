@@ -0,0 +1,203 @@
+#include "PixelReadback.h"
+#include "utility/Log.h"
+#include <SFML/OpenGL.hpp>
+#include <cassert>
+#include <cstddef>
+
+const std::string PixelReadback::TAG = "PixelReadback";
+
+// SFML 2.1 only exposes OpenGL 1.1, buffer objects are loaded by hand
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_READ_ONLY
+#define GL_READ_ONLY 0x88B8
+#endif
+
+using GenBuffersFn = void (APIENTRY*)(GLsizei, GLuint*);
+using DeleteBuffersFn = void (APIENTRY*)(GLsizei, const GLuint*);
+using BindBufferFn = void (APIENTRY*)(GLenum, GLuint);
+using BufferDataFn = void (APIENTRY*)(GLenum, std::ptrdiff_t, const void*,
+                                      GLenum);
+using MapBufferFn = void* (APIENTRY*)(GLenum, GLenum);
+using UnmapBufferFn = GLboolean (APIENTRY*)(GLenum);
+
+static GenBuffersFn genBuffers = nullptr;
+static DeleteBuffersFn deleteBuffers = nullptr;
+static BindBufferFn bindBuffer = nullptr;
+static BufferDataFn bufferData = nullptr;
+static MapBufferFn mapBuffer = nullptr;
+static UnmapBufferFn unmapBuffer = nullptr;
+
+// tries the core name and then the ARB one
+static void* loadFunction(const char* name, const char* arbName)
+{
+#ifdef _WIN32
+  void* fn = reinterpret_cast<void*>(wglGetProcAddress(name));
+  if (fn == nullptr)
+  {
+    fn = reinterpret_cast<void*>(wglGetProcAddress(arbName));
+  }
+  return fn;
+#else
+  // the game only ships on windows, other platforms use the slow path
+  (void) name;
+  (void) arbName;
+  return nullptr;
+#endif
+}
+
+static bool loadFunctions()
+{
+  genBuffers = reinterpret_cast<GenBuffersFn>(
+    loadFunction("glGenBuffers", "glGenBuffersARB"));
+  deleteBuffers = reinterpret_cast<DeleteBuffersFn>(
+    loadFunction("glDeleteBuffers", "glDeleteBuffersARB"));
+  bindBuffer = reinterpret_cast<BindBufferFn>(
+    loadFunction("glBindBuffer", "glBindBufferARB"));
+  bufferData = reinterpret_cast<BufferDataFn>(
+    loadFunction("glBufferData", "glBufferDataARB"));
+  mapBuffer = reinterpret_cast<MapBufferFn>(
+    loadFunction("glMapBuffer", "glMapBufferARB"));
+  unmapBuffer = reinterpret_cast<UnmapBufferFn>(
+    loadFunction("glUnmapBuffer", "glUnmapBufferARB"));
+  return genBuffers != nullptr && deleteBuffers != nullptr &&
+         bindBuffer != nullptr && bufferData != nullptr &&
+         mapBuffer != nullptr && unmapBuffer != nullptr;
+}
+
+PixelReadback::PixelReadback()
+: width(0),
+  height(0),
+  buffers(),
+  pending(),
+  frames(),
+  next(0),
+  mapped(-1)
+{
+}
+
+PixelReadback::~PixelReadback()
+{
+  destroy();
+}
+
+bool PixelReadback::initialize(const unsigned _width, const unsigned _height)
+{
+  assert(buffers[0] == 0);
+  if (!loadFunctions())
+  {
+    Log::warning(TAG, "Pixel buffer objects are not supported");
+    return false;
+  }
+
+  width = _width;
+  height = _height;
+  GLuint names[SLOTS];
+  genBuffers(SLOTS, names);
+  for (int i = 0; i < SLOTS; i++)
+  {
+    buffers[i] = names[i];
+    pending[i] = false;
+    bindBuffer(GL_PIXEL_PACK_BUFFER, names[i]);
+    bufferData(
+      GL_PIXEL_PACK_BUFFER,
+      static_cast<std::ptrdiff_t>(width) * height * 4,
+      nullptr,
+      GL_STREAM_READ
+      );
+  }
+  bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  next = 0;
+  mapped = -1;
+  return true;
+}
+
+void PixelReadback::destroy()
+{
+  if (buffers[0] == 0)
+  {
+    return;
+  }
+
+  unmap();
+  GLuint names[SLOTS];
+  for (int i = 0; i < SLOTS; i++)
+  {
+    names[i] = buffers[i];
+    buffers[i] = 0;
+    pending[i] = false;
+  }
+  deleteBuffers(SLOTS, names);
+}
+
+void PixelReadback::start(const uint32_t frameNumber)
+{
+  assert(buffers[0] != 0 && !pending[next] && mapped != next);
+
+  // with a pack buffer bound the read is queued and returns right away
+  bindBuffer(GL_PIXEL_PACK_BUFFER, buffers[next]);
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+  glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  pending[next] = true;
+  frames[next] = frameNumber;
+  next = (next + 1) % SLOTS;
+}
+
+const uint8_t* PixelReadback::map(uint32_t& frameNumber)
+{
+  assert(mapped < 0);
+
+  // slots are filled in order, so the oldest read is the first pending one
+  // starting from the slot that will be written next
+  int slot = -1;
+  for (int i = 0; i < SLOTS && slot < 0; i++)
+  {
+    const int candidate = (next + i) % SLOTS;
+    if (pending[candidate])
+    {
+      slot = candidate;
+    }
+  }
+  if (slot < 0)
+  {
+    return nullptr;
+  }
+
+  bindBuffer(GL_PIXEL_PACK_BUFFER, buffers[slot]);
+  void* pixels = mapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+  bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  pending[slot] = false;
+  if (pixels == nullptr)
+  {
+    Log::error(TAG, "Could not map the pixels of frame %u", frames[slot]);
+    return nullptr;
+  }
+
+  mapped = slot;
+  frameNumber = frames[slot];
+  return static_cast<const uint8_t*>(pixels);
+}
+
+void PixelReadback::unmap()
+{
+  if (mapped < 0)
+  {
+    return;
+  }
+
+  bindBuffer(GL_PIXEL_PACK_BUFFER, buffers[mapped]);
+  unmapBuffer(GL_PIXEL_PACK_BUFFER);
+  bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  mapped = -1;
+}
+
+bool PixelReadback::isFull() const
+{
+  return pending[next];
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Reads the pixels of the active OpenGL framebuffer without waiting for the
+ * GPU. Each read goes into one of two pixel buffer objects and is only mapped
+ * a capture later, by which point the GPU has long finished with it.
+ * Needs OpenGL 2.1 or ARB_pixel_buffer_object. The pixels come back bottom
+ * row first, the way OpenGL stores them.
+ */
+class PixelReadback
+{
+private:
+  static const std::string TAG;
+  static const int SLOTS = 2;
+
+  unsigned width;
+  unsigned height;
+  // GLuint, 0 when not created
+  unsigned buffers[SLOTS];
+  bool pending[SLOTS];
+  uint32_t frames[SLOTS];
+  // slot the next read goes into
+  int next;
+  // slot that is mapped, -1 for none
+  int mapped;
+
+public:
+  PixelReadback();
+  ~PixelReadback();
+  PixelReadback(const PixelReadback&) = delete;
+  PixelReadback& operator=(const PixelReadback&) = delete;
+
+  /**
+   * Creates the buffers, the context to read from must be active.
+   * @return false if the driver doesn't support pixel buffer objects.
+   */
+  bool initialize(const unsigned _width, const unsigned _height);
+  void destroy();
+
+  /**
+   * Starts reading the framebuffer of the active context. Call map() first
+   * if both reads are still pending.
+   * @param frameNumber Handed back by map() with the pixels.
+   */
+  void start(const uint32_t frameNumber);
+
+  /**
+   * Maps the oldest pending read, call unmap() once done with the pixels.
+   * @param frameNumber[out] The frame the pixels are from.
+   * @return nullptr if there is no pending read.
+   */
+  const uint8_t* map(uint32_t& frameNumber);
+  void unmap();
+
+  bool isFull() const;
+};
\ No newline at end of file
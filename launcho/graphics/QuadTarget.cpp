@@ -0,0 +1,23 @@
+#include "QuadTarget.h"
+
+SFMLQuadTarget::SFMLQuadTarget(sf::RenderTarget& _target)
+: target(_target)
+{
+}
+
+sf::Vector2u SFMLQuadTarget::getSize() const
+{
+  return target.getSize();
+}
+
+const sf::View& SFMLQuadTarget::getView() const
+{
+  return target.getView();
+}
+
+void SFMLQuadTarget::drawQuads(const sf::Vertex* vertices,
+                               const std::size_t count,
+                               const sf::RenderStates& states)
+{
+  target.draw(vertices, count, sf::Quads, states);
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+/**
+ * The parts of sf::RenderTarget that custom drawn components use, so they
+ * can be drawn by renderers that don't have one. Components that draw
+ * through this are measured by headless runs too.
+ */
+class QuadTarget
+{
+public:
+  virtual ~QuadTarget() = default;
+
+  virtual sf::Vector2u getSize() const = 0;
+  virtual const sf::View& getView() const = 0;
+
+  /**
+   * Draws quads like sf::RenderTarget::draw() does with sf::Quads. Only the
+   * transform and texture of the states are used.
+   */
+  virtual void drawQuads(const sf::Vertex* vertices, const std::size_t count,
+                         const sf::RenderStates& states) = 0;
+};
+
+/**
+ * Passes quads on to an SFML render target.
+ */
+class SFMLQuadTarget final
+  : public QuadTarget
+{
+private:
+  sf::RenderTarget& target;
+
+public:
+  explicit SFMLQuadTarget(sf::RenderTarget& _target);
+
+  sf::Vector2u getSize() const override;
+  const sf::View& getView() const override;
+  void drawQuads(const sf::Vertex* vertices, const std::size_t count,
+                 const sf::RenderStates& states) override;
+};
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include "RenderCommand.h"
+
+void RenderCommand::writeQuad(sf::Vertex* quad, const float targetHeight) const
+{
+  const Vector2 corners[4] = {
+    Vector2(-halfSize.x, halfSize.y),
+    Vector2(halfSize.x, halfSize.y),
+    Vector2(halfSize.x, -halfSize.y),
+    Vector2(-halfSize.x, -halfSize.y)
+  };
+
+  for (int i = 0; i < 4; i++)
+  {
+    // SFML has y pointing down, flip against the target
+    const Vector2 pt = transform.transformPoint(corners[i]);
+    quad[i].position = sf::Vector2f(pt.x, targetHeight - pt.y);
+    quad[i].color = color;
+  }
+
+  if (texture != nullptr)
+  {
+    // image rows run top to bottom, matching the corner order
+    const float left = static_cast<float>(texRect.left);
+    const float top = static_cast<float>(texRect.top);
+    const float right = left + texRect.width;
+    const float bottom = top + texRect.height;
+    quad[0].texCoords = sf::Vector2f(left, top);
+    quad[1].texCoords = sf::Vector2f(right, top);
+    quad[2].texCoords = sf::Vector2f(right, bottom);
+    quad[3].texCoords = sf::Vector2f(left, bottom);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "types.h"
+#include "math/Transform2.h"
+#include "math/Vector2.h"
+#include <SFML/Graphics.hpp>
+
+class RenderComponent;
+
+/**
+ * Everything needed to draw one renderable as a quad, copied out of its
+ * components. Commands are built in parallel and then drawn without touching
+ * the components again.
+ */
+struct RenderCommand
+{
+  // the component the command came from
+  RenderComponent* component;
+  // nullptr for a solid quad
+  const sf::Texture* texture;
+  Transform2 transform;
+  // half the width and height of the quad, centered on the transform origin
+  Vector2 halfSize;
+  // pixel rectangle of the texture to stretch over the quad
+  sf::IntRect texRect;
+  sf::Color color;
+  RenderLayer layer;
+  // the component couldn't describe itself and has to be drawn with draw()
+  bool custom;
+
+  /**
+   * Writes the corners of the quad in target coordinates. The order is upper
+   * left, upper right, lower right, lower left.
+   * @param targetHeight Height of the render target, used to flip the y axis.
+   */
+  void writeQuad(sf::Vertex* quad, const float targetHeight) const;
+};
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "RenderCommandBuffer.h"
+#include <cassert>
+
+// renderables handed to a worker at a time
+static const std::size_t CHUNK_SIZE = 256;
+
+RenderCommandBuffer::RenderCommandBuffer()
+: commands(),
+  vertices()
+{
+}
+
+void RenderCommandBuffer::build(const RenderList& components,
+                                const float targetHeight, WorkerPool& workers)
+{
+  // the last build's lists may have gone with an arena reset, so they are
+  // allocated again rather than resized
+  clear();
+  // every renderable gets a fixed slot, so chunks never write to the same
+  // place and the result is in the same order as the input
+  commands.resize(components.size());
+  vertices.resize(components.size() * 4);
+
+  workers.parallelFor(
+    components.size(),
+    CHUNK_SIZE,
+    [&](const std::size_t begin, const std::size_t end) {
+      for (std::size_t i = begin; i < end; i++)
+      {
+        RenderCommand& command = commands[i];
+        command.component = components[i];
+        command.texture = nullptr;
+        command.layer = components[i]->getLayer();
+        command.custom = !components[i]->buildCommand(command);
+        if (!command.custom)
+        {
+          command.writeQuad(&vertices[i * 4], targetHeight);
+        }
+      }
+    });
+}
+
+void RenderCommandBuffer::clear()
+{
+  commands = ArenaVector<RenderCommand>();
+  vertices = ArenaVector<sf::Vertex>();
+}
+
+std::size_t RenderCommandBuffer::size() const
+{
+  return commands.size();
+}
+
+const RenderCommand& RenderCommandBuffer::getCommand(const std::size_t i) const
+{
+  assert(i < commands.size());
+  return commands[i];
+}
+
+const sf::Vertex* RenderCommandBuffer::getQuad(const std::size_t i) const
+{
+  assert(i < commands.size());
+  return &vertices[i * 4];
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "graphics/RenderCommand.h"
+#include "components/RenderComponent.h"
+#include "utility/FrameArena.h"
+#include "utility/WorkerPool.h"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+/**
+ * The draw list for one frame: a command and a quad of vertices for every
+ * renderable, in draw order. Building it is the CPU heavy part of rendering
+ * and is spread over the worker pool, submitting it to a target only has to
+ * walk the finished list.
+ * The lists are allocated from the frame arena of the thread that builds
+ * them, so a buffer is only valid until that arena is reset.
+ */
+class RenderCommandBuffer
+{
+private:
+  ArenaVector<RenderCommand> commands;
+  // four per command, left unused by custom commands
+  ArenaVector<sf::Vertex> vertices;
+
+public:
+  RenderCommandBuffer();
+  RenderCommandBuffer(const RenderCommandBuffer&) = delete;
+  RenderCommandBuffer& operator=(const RenderCommandBuffer&) = delete;
+
+  /**
+   * Replaces the contents with commands for a list of renderables. The
+   * components are only read, but nothing may change them until this
+   * returns.
+   * @param components The renderables in draw order.
+   * @param targetHeight Height of the target the quads are for.
+   * @param workers Pool the building is split over.
+   */
+  void build(const RenderList& components,
+             const float targetHeight, WorkerPool& workers);
+
+  void clear();
+  std::size_t size() const;
+  const RenderCommand& getCommand(const std::size_t i) const;
+
+  /**
+   * Returns the four vertices of a command. The quads of consecutive
+   * commands are contiguous, so a run of them can be drawn with one call.
+   */
+  const sf::Vertex* getQuad(const std::size_t i) const;
+};
\ No newline at end of file
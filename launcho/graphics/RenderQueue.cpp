@@ -0,0 +1,277 @@
+#include "RenderQueue.h"
+#include "Game.h"
+#include "Entity.h"
+#include "SpatialSystem.h"
+#include "events/EntityEvents.h"
+#include "utility/Log.h"
+#include "utility/RadixSort.h"
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+const std::string RenderQueue::TAG = "RenderQueue";
+
+RenderQueue::RenderQueue()
+: renderables(),
+  layers(),
+  versions(),
+  foundIDs(),
+  foundSlots(),
+  sortKeys(),
+  sortScratch(),
+  indices(),
+  addedCallbackID(0),
+  removedCallbackID(0)
+{
+}
+
+void RenderQueue::initialize()
+{
+  auto evtMgr = Game::getInstance().getEventSystem();
+  addedCallbackID = evtMgr->generateNextCallbackID();
+  evtMgr->addListener(
+    EntityAddedEvent::ID,
+    addedCallbackID,
+    EventCallback::bind<RenderQueue, &RenderQueue::entityAddedCallback>(this)
+    );
+  removedCallbackID = evtMgr->generateNextCallbackID();
+  evtMgr->addListener(
+    EntityRemovedEvent::ID,
+    removedCallbackID,
+    EventCallback::bind<RenderQueue, &RenderQueue::entityRemovedCallback>(this)
+    );
+}
+
+void RenderQueue::destroy()
+{
+  auto evtMgr = Game::getInstance().getEventSystem();
+  evtMgr->removeListener(EntityAddedEvent::ID, addedCallbackID);
+  evtMgr->removeListener(EntityRemovedEvent::ID, removedCallbackID);
+
+  renderables.clear();
+  for (auto& bucket : layers)
+  {
+    bucket.clear();
+  }
+}
+
+void RenderQueue::update()
+{
+  for (EntityID id : Game::getInstance().getSpatialSystem()->getLastMoved())
+  {
+    auto itr = renderables.find(id);
+    if (itr != renderables.end())
+    {
+      versions[static_cast<int>(itr->second.layer)]++;
+      versions[static_cast<int>(itr->second.component->getLayer())]++;
+    }
+  }
+}
+
+void RenderQueue::findVisible(const AABB2& area, const bool cull,
+                              const LayerMask& skip, RenderList& out)
+{
+  // last frame's list went with the arena reset
+  out = RenderList();
+
+  if (!cull)
+  {
+    out.reserve(renderables.size());
+    for (auto& entry : renderables)
+    {
+      refreshLayer(entry.second);
+    }
+    for (int layer = LAYER_COUNT - 1; layer >= 0; layer--)
+    {
+      if (!skip[layer])
+      {
+        out.insert(out.end(), layers[layer].begin(), layers[layer].end());
+      }
+    }
+    return;
+  }
+
+  foundIDs.clear();
+  Game::getInstance().getSpatialSystem()->query(area, foundIDs);
+  collectFoundSlots();
+
+  // the farthest layer sorts first
+  sortKeys.clear();
+  for (const LayerSlot* slot : foundSlots)
+  {
+    if (skip[static_cast<int>(slot->layer)])
+    {
+      continue;
+    }
+    const uint64_t inverted = LAYER_COUNT - 1 - static_cast<int>(slot->layer);
+    sortKeys.push_back((inverted << 32) | slot->index);
+  }
+  radixSort(sortKeys, sortScratch);
+
+  out.reserve(sortKeys.size());
+  for (uint64_t key : sortKeys)
+  {
+    const int layer = LAYER_COUNT - 1 - static_cast<int>(key >> 32);
+    out.push_back(layers[layer][static_cast<uint32_t>(key)]);
+  }
+}
+
+void RenderQueue::findInLayer(const int layer, const AABB2& area,
+                              RenderList& out)
+{
+  out = RenderList();
+
+  foundIDs.clear();
+  Game::getInstance().getSpatialSystem()->query(area, foundIDs);
+  collectFoundSlots();
+
+  indices.clear();
+  for (const LayerSlot* slot : foundSlots)
+  {
+    if (static_cast<int>(slot->layer) == layer)
+    {
+      indices.push_back(slot->index);
+    }
+  }
+  std::sort(indices.begin(), indices.end());
+
+  out.reserve(indices.size());
+  for (uint32_t index : indices)
+  {
+    out.push_back(layers[layer][index]);
+  }
+}
+
+uint32_t RenderQueue::getLayerVersion(const int layer) const
+{
+  return versions[layer];
+}
+
+std::size_t RenderQueue::getLayerSize(const int layer) const
+{
+  return layers[layer].size();
+}
+
+std::size_t RenderQueue::size() const
+{
+  return renderables.size();
+}
+
+void RenderQueue::addToLayer(LayerSlot& slot, const RenderLayer layer)
+{
+  auto& bucket = layers[static_cast<int>(layer)];
+  slot.layer = layer;
+  slot.index = static_cast<uint32_t>(bucket.size());
+  bucket.push_back(slot.component.get());
+  versions[static_cast<int>(layer)]++;
+}
+
+void RenderQueue::removeFromLayer(LayerSlot& slot)
+{
+  auto& bucket = layers[static_cast<int>(slot.layer)];
+  assert(slot.index < bucket.size());
+  assert(bucket[slot.index] == slot.component.get());
+
+  RenderComponent* last = bucket.back();
+  bucket[slot.index] = last;
+  bucket.pop_back();
+  if (last != slot.component.get())
+  {
+    renderables[last->getParentID()].index = slot.index;
+  }
+  versions[static_cast<int>(slot.layer)]++;
+}
+
+void RenderQueue::refreshLayer(LayerSlot& slot)
+{
+  const RenderLayer layer = slot.component->getLayer();
+  if (layer != slot.layer)
+  {
+    removeFromLayer(slot);
+    addToLayer(slot, layer);
+  }
+}
+
+void RenderQueue::collectFoundSlots()
+{
+  // every layer change is applied before any index is read, since a change
+  // moves another renderable within its bucket
+  foundSlots.clear();
+  for (EntityID id : foundIDs)
+  {
+    auto itr = renderables.find(id);
+    if (itr != renderables.end())
+    {
+      refreshLayer(itr->second);
+      foundSlots.push_back(&itr->second);
+    }
+  }
+}
+
+void RenderQueue::entityAddedCallback(const Event& evt)
+{
+  auto eae = Event::cast<EntityAddedEvent>(evt);
+  if (eae == nullptr)
+  {
+    Log::error(
+      TAG,
+      "Couldn't cast to EntityAddedEvent, type %u (%s)",
+      evt.getID(),
+      evt.getNameC()
+      );
+    return;
+  }
+
+  auto entity = 
+    Game::getInstance().getLogicSystem()->getEntity(eae->entity).lock();
+  assert(entity != nullptr);
+
+  auto rc = entity->getComponent<RenderComponent>().lock();
+  if (rc != nullptr)
+  {
+    if (renderables.find(entity->getID()) != renderables.end())
+    {
+      Log::error(TAG, "Tried to add duplicate entity %u", entity->getID());
+    }
+    else
+    {
+      LayerSlot& slot = renderables[entity->getID()];
+      slot.component = rc;
+      addToLayer(slot, rc->getLayer());
+    }
+  }
+  else
+  {
+    Log::debug(
+      TAG,
+      "Ignoring add of non-renderable entity %u",
+      entity->getID()
+      );
+  }
+}
+
+void RenderQueue::entityRemovedCallback(const Event& evt)
+{
+  auto ere = Event::cast<EntityRemovedEvent>(evt);
+  if (ere == nullptr)
+  {
+    Log::error(
+      TAG,
+      "Couldn't cast to EntityRemovedEvent, type %u (%s)",
+      evt.getID(),
+      evt.getNameC()
+      );
+    return;
+  }
+
+  auto itr = renderables.find(ere->entity);
+  if (itr != renderables.end())
+  {
+    removeFromLayer(itr->second);
+    renderables.erase(itr);
+  }
+  else
+  {
+    Log::debug(TAG, "Entity %u not found in renderable list", ere->entity);
+  }
+}
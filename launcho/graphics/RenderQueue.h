@@ -0,0 +1,112 @@
+#pragma once
+
+#include "types.h"
+#include "components/RenderComponent.h"
+#include "math/AABB2.h"
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Keeps every renderable entity sorted into layers and works out what has to
+ * be drawn each frame, independent of how it gets drawn. Render systems own
+ * one of these and only have to rasterize the lists it hands out.
+ * Renderables are kept in one bucket per layer, adding and removing them is
+ * O(1) and nothing is ever fully re-sorted.
+ */
+class RenderQueue
+{
+public:
+  static const int LAYER_COUNT = 256;
+  // a bit for each layer
+  using LayerMask = std::bitset<LAYER_COUNT>;
+
+private:
+  static const std::string TAG;
+
+  // where a renderable is filed in the layer buckets
+  struct LayerSlot
+  {
+    StrongRenderComponentPtr component;
+    RenderLayer layer;
+    uint32_t index;
+  };
+
+  std::unordered_map<EntityID, LayerSlot> renderables;
+  // one bucket per layer, drawn from the last bucket to the first
+  std::array<std::vector<RenderComponent*>, LAYER_COUNT> layers;
+  // bumped whenever the contents of a layer change
+  std::array<uint32_t, LAYER_COUNT> versions;
+
+  std::vector<EntityID> foundIDs;
+  std::vector<LayerSlot*> foundSlots;
+  // (inverted layer, bucket index) keys for putting culled results in order
+  std::vector<uint64_t> sortKeys;
+  std::vector<uint64_t> sortScratch;
+  std::vector<uint32_t> indices;
+
+  EventCallbackID addedCallbackID;
+  EventCallbackID removedCallbackID;
+
+public:
+  RenderQueue();
+  RenderQueue(const RenderQueue&) = delete;
+  RenderQueue& operator=(const RenderQueue&) = delete;
+
+  // starts and stops tracking entities
+  void initialize();
+  void destroy();
+
+  /**
+   * Bumps the version of every layer that has an entity the spatial system
+   * moved this frame. Call once per frame before drawing.
+   */
+  void update();
+
+  /**
+   * Finds what to draw this frame, farthest layer first.
+   * @param area The world area being drawn.
+   * @param cull If false everything is returned, otherwise only the
+   * renderables intersecting area are found through the spatial system.
+   * @param skip Layers to leave out, such as ones drawn from a cache.
+   * @param out[out] Replaced with the renderables in draw order, allocated
+   * from the calling thread's frame arena.
+   */
+  void findVisible(const AABB2& area, const bool cull, const LayerMask& skip,
+                   RenderList& out);
+
+  /**
+   * Finds the renderables of a single layer that intersect an area, in draw
+   * order. Allocates the list like findVisible().
+   */
+  void findInLayer(const int layer, const AABB2& area, RenderList& out);
+
+  /**
+   * Returns a counter that changes whenever a renderable is added to,
+   * removed from or moved within the layer. Caches compare it against the
+   * version they were built from. Changes to a component's appearance alone
+   * are not tracked.
+   */
+  uint32_t getLayerVersion(const int layer) const;
+  // number of renderables in a layer
+  std::size_t getLayerSize(const int layer) const;
+
+  // number of renderables being tracked
+  std::size_t size() const;
+
+private:
+  // bucket maintenance, removal swaps the last renderable into the hole
+  void addToLayer(LayerSlot& slot, const RenderLayer layer);
+  void removeFromLayer(LayerSlot& slot);
+  // moves the renderable if its layer changed since it was filed
+  void refreshLayer(LayerSlot& slot);
+  // looks up the slots for foundIDs, applying any layer changes
+  void collectFoundSlots();
+
+  // callbacks
+  void entityAddedCallback(const Event& evt);
+  void entityRemovedCallback(const Event& evt);
+};
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "TextPanel.h"
+#include "utility/Log.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+const std::string TextPanel::TAG = "TextPanel";
+
+// space around the text inside the background
+static const float MARGIN = 4.0f;
+
+TextPanel::TextPanel()
+: font(nullptr),
+  characterSize(0),
+  position(),
+  color(),
+  glyphs(),
+  cellWidth(0.0f),
+  lineHeight(0.0f),
+  panelWidth(0.0f),
+  vertices(),
+  fields()
+{
+}
+
+void TextPanel::initialize(const sf::Font& _font, const unsigned _characterSize,
+                           const sf::Vector2f& _position,
+                           const sf::Color& _color)
+{
+  font = &_font;
+  characterSize = _characterSize;
+  position = _position;
+  color = _color;
+  lineHeight = static_cast<float>(font->getLineSpacing(characterSize));
+  vertices.clear();
+  fields.clear();
+
+  // loading every glyph up front keeps the font texture from growing later
+  cellWidth = 0.0f;
+  for (char c = FIRST_CHAR; c <= LAST_CHAR; c++)
+  {
+    const sf::Glyph& glyph = font->getGlyph(c, characterSize, false);
+    GlyphQuad& quad = glyphs[c - FIRST_CHAR];
+    quad.bounds = sf::FloatRect(glyph.bounds);
+    quad.texRect = sf::FloatRect(glyph.textureRect);
+    quad.advance = static_cast<float>(glyph.advance);
+    if ((c >= '0' && c <= '9') || c == '.' || c == '-')
+    {
+      cellWidth = std::max(cellWidth, quad.advance);
+    }
+  }
+  panelWidth = 0.0f;
+}
+
+std::size_t TextPanel::addLine(const std::string& label,
+                               const unsigned valueWidth)
+{
+  assert(font != nullptr);
+  sf::Vector2f pen(
+    position.x + MARGIN,
+    position.y + MARGIN + (lineHeight * (fields.size() + 1))
+    );
+
+  for (char c : label)
+  {
+    vertices.resize(vertices.size() + 4);
+    writeGlyph(&vertices[vertices.size() - 4], pen, c);
+    pen.x += getGlyph(c).advance;
+  }
+  pen.x += getGlyph(' ').advance;
+
+  Field field;
+  field.origin = pen;
+  field.firstVertex = vertices.size();
+  field.text.assign(valueWidth, ' ');
+  vertices.resize(vertices.size() + (valueWidth * 4));
+  for (unsigned i = 0; i < valueWidth; i++)
+  {
+    writeGlyph(&vertices[field.firstVertex + (i * 4)], pen, ' ');
+  }
+  fields.push_back(field);
+
+  // the background grows to fit the widest line
+  panelWidth = std::max(
+    panelWidth,
+    pen.x + (cellWidth * valueWidth) + MARGIN - position.x
+    );
+  const float panelHeight = (lineHeight * fields.size()) + (MARGIN * 3);
+  background[0].position = position;
+  background[1].position = position + sf::Vector2f(panelWidth, 0.0f);
+  background[2].position = position + sf::Vector2f(panelWidth, panelHeight);
+  background[3].position = position + sf::Vector2f(0.0f, panelHeight);
+  for (auto& vertex : background)
+  {
+    vertex.color = sf::Color(255, 255, 255, 192);
+  }
+
+  return fields.size() - 1;
+}
+
+void TextPanel::setValue(const std::size_t line, const char* text)
+{
+  assert(line < fields.size());
+  Field& field = fields[line];
+  const std::size_t width = field.text.size();
+  const std::size_t length = std::min(std::strlen(text), width);
+  const std::size_t padding = width - length;
+
+  for (std::size_t i = 0; i < width; i++)
+  {
+    const char c = i < padding ? ' ' : text[i - padding];
+    if (field.text[i] != c)
+    {
+      writeCell(field, i, c);
+    }
+  }
+}
+
+void TextPanel::setValue(const std::size_t line, const float value,
+                         const int decimals)
+{
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+  setValue(line, buffer);
+}
+
+void TextPanel::setValue(const std::size_t line, const unsigned value)
+{
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%u", value);
+  setValue(line, buffer);
+}
+
+void TextPanel::draw(sf::RenderTarget& target) const
+{
+  if (vertices.empty())
+  {
+    return;
+  }
+
+  target.draw(background, 4, sf::Quads);
+  sf::RenderStates states;
+  states.texture = &font->getTexture(characterSize);
+  target.draw(&vertices[0], vertices.size(), sf::Quads, states);
+}
+
+const TextPanel::GlyphQuad& TextPanel::getGlyph(const char c) const
+{
+  if (c < FIRST_CHAR || c > LAST_CHAR)
+  {
+    return glyphs['?' - FIRST_CHAR];
+  }
+  return glyphs[c - FIRST_CHAR];
+}
+
+void TextPanel::writeCell(Field& field, const std::size_t cell, const char c)
+{
+  field.text[cell] = c;
+
+  // glyphs are centered in their cell so the digits line up
+  const GlyphQuad& glyph = getGlyph(c);
+  const sf::Vector2f origin(
+    field.origin.x + (cellWidth * cell) + ((cellWidth - glyph.advance) / 2.0f),
+    field.origin.y
+    );
+  writeGlyph(&vertices[field.firstVertex + (cell * 4)], origin, c);
+}
+
+void TextPanel::writeGlyph(sf::Vertex* quad, const sf::Vector2f& origin,
+                           const char c) const
+{
+  const GlyphQuad& glyph = getGlyph(c);
+  const float left = origin.x + glyph.bounds.left;
+  const float top = origin.y + glyph.bounds.top;
+  const float right = left + glyph.bounds.width;
+  const float bottom = top + glyph.bounds.height;
+  const float u0 = glyph.texRect.left;
+  const float v0 = glyph.texRect.top;
+  const float u1 = u0 + glyph.texRect.width;
+  const float v1 = v0 + glyph.texRect.height;
+
+  quad[0] = sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u0, v0));
+  quad[1] = sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u1, v0));
+  quad[2] = sf::Vertex(sf::Vector2f(right, bottom), color,
+                       sf::Vector2f(u1, v1));
+  quad[3] = sf::Vertex(sf::Vector2f(left, bottom), color,
+                       sf::Vector2f(u0, v1));
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Lines of "label value" text drawn with one call, for overlays that change
+ * every frame. The glyph geometry is laid out once. Values sit in fixed width
+ * cells, and setting one only rewrites the cells whose character changed,
+ * so updating the panel costs about as much as comparing the strings.
+ * Only printable ASCII is supported.
+ */
+class TextPanel
+{
+private:
+  static const std::string TAG;
+  static const char FIRST_CHAR = ' ';
+  static const char LAST_CHAR = '~';
+
+  // glyph geometry relative to the pen position on the baseline
+  struct GlyphQuad
+  {
+    sf::FloatRect bounds;
+    sf::FloatRect texRect;
+    float advance;
+  };
+
+  struct Field
+  {
+    // position of the first cell's pen on the baseline
+    sf::Vector2f origin;
+    // first of the four vertices per cell
+    std::size_t firstVertex;
+    // what the cells currently show, padded with spaces
+    std::string text;
+  };
+
+  const sf::Font* font;
+  unsigned characterSize;
+  sf::Vector2f position;
+  sf::Color color;
+  std::array<GlyphQuad, LAST_CHAR - FIRST_CHAR + 1> glyphs;
+  // width of every value cell, wide enough for any digit
+  float cellWidth;
+  float lineHeight;
+  float panelWidth;
+
+  std::vector<sf::Vertex> vertices;
+  std::vector<Field> fields;
+  sf::Vertex background[4];
+
+public:
+  TextPanel();
+
+  /**
+   * Caches the glyphs of a font.
+   * @param _font Must outlive the panel.
+   * @param _characterSize Size of the text in pixels.
+   * @param _position Upper left corner of the panel.
+   */
+  void initialize(const sf::Font& _font, const unsigned _characterSize,
+                  const sf::Vector2f& _position, const sf::Color& _color);
+
+  /**
+   * Adds a line below the existing ones.
+   * @param label Text that never changes.
+   * @param valueWidth Number of characters the value can have.
+   * @return The index used to set the value.
+   */
+  std::size_t addLine(const std::string& label, const unsigned valueWidth);
+
+  /**
+   * Changes the value of a line, right aligned in its cells. Text longer
+   * than the value width is cut off.
+   */
+  void setValue(const std::size_t line, const char* text);
+
+  // formats a number into a line's value
+  void setValue(const std::size_t line, const float value,
+                const int decimals);
+  void setValue(const std::size_t line, const unsigned value);
+
+  void draw(sf::RenderTarget& target) const;
+
+private:
+  const GlyphQuad& getGlyph(const char c) const;
+  void writeCell(Field& field, const std::size_t cell, const char c);
+  // writes a glyph's quad with its pen at origin
+  void writeGlyph(sf::Vertex* quad, const sf::Vector2f& origin,
+                  const char c) const;
+};
\ No newline at end of file
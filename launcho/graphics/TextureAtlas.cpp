@@ -0,0 +1,228 @@
+#include "TextureAtlas.h"
+#include "utility/Log.h"
+#include <algorithm>
+#include <climits>
+
+const std::string TextureAtlas::TAG = "TextureAtlas";
+
+TextureAtlas::TextureAtlas(const unsigned _pageSize, const unsigned _padding)
+: pageSize(_pageSize),
+  padding(_padding),
+  pages(),
+  regions()
+{
+}
+
+bool TextureAtlas::add(const std::string& name, const sf::Image& image)
+{
+  if (regions.find(name) != regions.end())
+  {
+    Log::error(TAG, "Image %s is already in the atlas", name.c_str());
+    return false;
+  }
+
+  const sf::Vector2u size = image.getSize();
+  const int width = static_cast<int>(size.x + padding);
+  const int height = static_cast<int>(size.y + padding);
+  if (size.x == 0 || size.y == 0 || width > static_cast<int>(pageSize) ||
+      height > static_cast<int>(pageSize))
+  {
+    Log::error(
+      TAG,
+      "Image %s (%ux%u) doesn't fit in a %u page",
+      name.c_str(),
+      size.x,
+      size.y,
+      pageSize
+      );
+    return false;
+  }
+
+  int x = 0;
+  int y = 0;
+  Page* target = nullptr;
+  for (auto& page : pages)
+  {
+    if (pack(*page, width, height, x, y))
+    {
+      target = page.get();
+      break;
+    }
+  }
+  if (target == nullptr)
+  {
+    target = &createPage();
+    if (!pack(*target, width, height, x, y))
+    {
+      return false;
+    }
+  }
+
+  target->image.copy(image, x, y);
+  target->dirty = true;
+
+  AtlasRegion region;
+  region.texture = &target->texture;
+  region.rect = sf::IntRect(x, y, size.x, size.y);
+  regions[name] = region;
+  return true;
+}
+
+bool TextureAtlas::addFromFile(const std::string& name,
+                               const std::string& filename)
+{
+  sf::Image image;
+  if (!image.loadFromFile(filename))
+  {
+    Log::error(TAG, "Could not load %s", filename.c_str());
+    return false;
+  }
+  return add(name, image);
+}
+
+const AtlasRegion* TextureAtlas::find(const std::string& name) const
+{
+  auto itr = regions.find(name);
+  if (itr != regions.end())
+  {
+    return &itr->second;
+  }
+  return nullptr;
+}
+
+void TextureAtlas::upload()
+{
+  for (auto& page : pages)
+  {
+    if (page->dirty)
+    {
+      page->texture.update(page->image);
+      page->dirty = false;
+    }
+  }
+}
+
+const sf::Image* TextureAtlas::getPageImage(const sf::Texture* texture) const
+{
+  for (auto& page : pages)
+  {
+    if (&page->texture == texture)
+    {
+      return &page->image;
+    }
+  }
+  return nullptr;
+}
+
+std::size_t TextureAtlas::getPageCount() const
+{
+  return pages.size();
+}
+
+std::size_t TextureAtlas::getImageCount() const
+{
+  return regions.size();
+}
+
+TextureAtlas::Page& TextureAtlas::createPage()
+{
+  std::unique_ptr<Page> page(new Page());
+  page->image.create(pageSize, pageSize, sf::Color::Transparent);
+  if (!page->texture.create(pageSize, pageSize))
+  {
+    Log::error(TAG, "Unable to create %ux%u page texture", pageSize, pageSize);
+  }
+  SkylineNode node = { 0, 0, static_cast<int>(pageSize) };
+  page->skyline.push_back(node);
+  page->dirty = true;
+
+  pages.push_back(std::move(page));
+  Log::debug(TAG, "Created page %u", static_cast<unsigned>(pages.size()));
+  return *pages.back();
+}
+
+bool TextureAtlas::pack(Page& page, const int width, const int height,
+                        int& outX, int& outY)
+{
+  // bottom left rule, the lowest spot wins and ties go to the leftmost
+  int bestY = INT_MAX;
+  std::size_t bestIndex = page.skyline.size();
+  for (std::size_t i = 0; i < page.skyline.size(); i++)
+  {
+    const int y = fitAt(page, i, width, height);
+    if (y >= 0 && y < bestY)
+    {
+      bestY = y;
+      bestIndex = i;
+    }
+  }
+  if (bestIndex == page.skyline.size())
+  {
+    return false;
+  }
+
+  outX = page.skyline[bestIndex].x;
+  outY = bestY;
+
+  // raise the skyline over the new rectangle
+  SkylineNode node = { outX, outY + height, width };
+  page.skyline.insert(page.skyline.begin() + bestIndex, node);
+
+  // trim the nodes the rectangle now covers
+  const int right = outX + width;
+  std::size_t i = bestIndex + 1;
+  while (i < page.skyline.size() && page.skyline[i].x < right)
+  {
+    SkylineNode& covered = page.skyline[i];
+    const int coveredRight = covered.x + covered.width;
+    if (coveredRight <= right)
+    {
+      page.skyline.erase(page.skyline.begin() + i);
+    }
+    else
+    {
+      covered.width = coveredRight - right;
+      covered.x = right;
+      break;
+    }
+  }
+
+  // merge neighbors at the same height
+  for (i = 0; i + 1 < page.skyline.size();)
+  {
+    if (page.skyline[i].y == page.skyline[i + 1].y)
+    {
+      page.skyline[i].width += page.skyline[i + 1].width;
+      page.skyline.erase(page.skyline.begin() + i + 1);
+    }
+    else
+    {
+      i++;
+    }
+  }
+  return true;
+}
+
+int TextureAtlas::fitAt(const Page& page, const std::size_t index,
+                        const int width, const int height) const
+{
+  const int x = page.skyline[index].x;
+  if (x + width > static_cast<int>(pageSize))
+  {
+    return -1;
+  }
+
+  // the rectangle rests on the highest node under it
+  int y = 0;
+  int remaining = width;
+  for (std::size_t i = index; remaining > 0; i++)
+  {
+    y = std::max(y, page.skyline[i].y);
+    if (y + height > static_cast<int>(pageSize))
+    {
+      return -1;
+    }
+    remaining -= page.skyline[i].width;
+  }
+  return y;
+}
\ No newline at end of file
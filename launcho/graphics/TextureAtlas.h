@@ -0,0 +1,119 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Where an image ended up inside of an atlas.
+ */
+struct AtlasRegion
+{
+  // the page texture, stays valid for the lifetime of the atlas
+  const sf::Texture* texture;
+  // pixel rectangle of the image inside of the texture, SFML uses pixel
+  // texture coordinates so this is also the UV rectangle
+  sf::IntRect rect;
+};
+
+/**
+ * Packs many small images into a few large textures at runtime, so that
+ * everything drawn from the same page can share a single batched draw call.
+ * Images are placed with a skyline bottom-left packer. A new page is started
+ * when an image doesn't fit on any of the existing ones.
+ * Pages are kept on the CPU as images and uploaded to their textures by
+ * upload(), which the renderer calls once per frame.
+ */
+class TextureAtlas
+{
+private:
+  static const std::string TAG;
+
+  // top edge of the packed area over one horizontal span of a page
+  struct SkylineNode
+  {
+    int x;
+    int y;
+    int width;
+  };
+
+  struct Page
+  {
+    sf::Image image;
+    sf::Texture texture;
+    std::vector<SkylineNode> skyline;
+    // the image has changes that haven't been uploaded
+    bool dirty;
+  };
+
+  const unsigned pageSize;
+  // empty pixels kept around each image so filtering doesn't bleed
+  const unsigned padding;
+  std::vector<std::unique_ptr<Page>> pages;
+  std::unordered_map<std::string, AtlasRegion> regions;
+
+public:
+  /**
+   * @param _pageSize Width and height of each page texture.
+   * @param _padding Empty pixels left between images.
+   */
+  explicit TextureAtlas(const unsigned _pageSize = 2048,
+                        const unsigned _padding = 1);
+  TextureAtlas(const TextureAtlas&) = delete;
+  TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+  /**
+   * Packs an image into the atlas.
+   * @param name The name used to look up the image later.
+   * @param image The pixels to copy in.
+   * @return false if the name is already used or the image can't fit on a
+   * page.
+   */
+  bool add(const std::string& name, const sf::Image& image);
+
+  /**
+   * Loads an image file and packs it into the atlas. See add().
+   */
+  bool addFromFile(const std::string& name, const std::string& filename);
+
+  /**
+   * Looks up a packed image.
+   * @return nullptr if there is no image with that name.
+   */
+  const AtlasRegion* find(const std::string& name) const;
+
+  /**
+   * Uploads pages that changed since the last call to their textures.
+   */
+  void upload();
+
+  /**
+   * Returns the CPU copy of a page, for renderers that don't use the GPU.
+   * @param texture The texture of an AtlasRegion.
+   * @return nullptr if the texture isn't one of the atlas pages.
+   */
+  const sf::Image* getPageImage(const sf::Texture* texture) const;
+
+  std::size_t getPageCount() const;
+  std::size_t getImageCount() const;
+
+private:
+  Page& createPage();
+
+  /**
+   * Finds the lowest spot on a page for a width x height rectangle and
+   * reserves it.
+   * @return false if there is no room.
+   */
+  bool pack(Page& page, const int width, const int height, int& outX,
+            int& outY);
+
+  /**
+   * Returns the y the rectangle would sit at if its left edge was placed at
+   * skyline node index, or -1 if it doesn't fit there.
+   */
+  int fitAt(const Page& page, const std::size_t index, const int width,
+            const int height) const;
+};
\ No newline at end of file
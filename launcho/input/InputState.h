@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+
+// things the player can do, each one is a bit in an InputMask
+enum class InputAction
+{
+  MoveUp,
+  MoveDown,
+  MoveLeft,
+  MoveRight,
+  Fire,
+  Count
+};
+
+using InputMask = uint32_t;
+
+/**
+ * Returns the bit of an action in an InputMask.
+ */
+constexpr InputMask inputBit(const InputAction action)
+{
+  return 1u << static_cast<unsigned>(action);
+}
+
+/**
+ * The player's input for one logic tick.
+ */
+struct InputState
+{
+  // actions held down during the tick, including ones that were pressed and
+  // released again between ticks
+  InputMask held;
+  // actions that went down since the previous tick
+  InputMask pressed;
+  // actions that went up since the previous tick
+  InputMask released;
+
+  constexpr InputState();
+  constexpr InputState(const InputMask _held, const InputMask _pressed,
+                       const InputMask _released);
+
+  constexpr bool isHeld(const InputAction action) const;
+  constexpr bool wasPressed(const InputAction action) const;
+  constexpr bool wasReleased(const InputAction action) const;
+};
+
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+
+constexpr InputState::InputState()
+  : held(0), pressed(0), released(0)
+{}
+
+constexpr InputState::InputState(const InputMask _held,
+                                 const InputMask _pressed,
+                                 const InputMask _released)
+  : held(_held), pressed(_pressed), released(_released)
+{}
+
+constexpr bool InputState::isHeld(const InputAction action) const
+{
+  return (held & inputBit(action)) != 0;
+}
+
+constexpr bool InputState::wasPressed(const InputAction action) const
+{
+  return (pressed & inputBit(action)) != 0;
+}
+
+constexpr bool InputState::wasReleased(const InputAction action) const
+{
+  return (released & inputBit(action)) != 0;
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Layout of replay files, all values little endian.
+ *
+ * Header: REPLAY_MAGIC, then u32 version, seed, tick rate and keyframe
+ * interval.
+ *
+ * Blocks follow, one per keyframe interval. Each starts with u32 first tick,
+ * tick count, raw size and compressed size, then the lzCompress()ed body.
+ * The body is a varint keyframe size, the keyframe, then the ticks as runs
+ * of identical ticks: varint run length, held, pressed and released.
+ *
+ * The index is written once the replay is closed: REPLAY_INDEX_MAGIC, u32
+ * block count, then u32 first tick, tick count and file offset of each
+ * block. The file ends with the u32 offset of the index and REPLAY_END_MAGIC.
+ * A replay that was never closed has no index, and is read by walking the
+ * block headers instead.
+ */
+
+static const char REPLAY_MAGIC[4] = { 'L', 'R', 'E', 'P' };
+static const char REPLAY_INDEX_MAGIC[4] = { 'L', 'I', 'D', 'X' };
+static const char REPLAY_END_MAGIC[4] = { 'L', 'E', 'N', 'D' };
+// 2 resets the physics world at every keyframe
+static const uint32_t REPLAY_VERSION = 2;
+static const uint32_t REPLAY_HEADER_SIZE = 20;
+static const uint32_t REPLAY_BLOCK_HEADER_SIZE = 16;
\ No newline at end of file
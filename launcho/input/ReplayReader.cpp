@@ -0,0 +1,311 @@
+#include "ReplayReader.h"
+#include "input/ReplayFormat.h"
+#include "utility/ByteStream.h"
+#include "utility/Log.h"
+#include "utility/Lz.h"
+#include <algorithm>
+#include <cstring>
+
+const std::string ReplayReader::TAG = "ReplayReader";
+
+// reads a fixed size chunk at an offset
+static bool readAt(std::FILE* file, const long offset, uint8_t* out,
+                   const std::size_t size)
+{
+  return std::fseek(file, offset, SEEK_SET) == 0 &&
+         std::fread(out, 1, size, file) == size;
+}
+
+ReplayReader::ReplayReader()
+: filename(),
+  file(nullptr),
+  seed(0),
+  tickRate(0),
+  keyframeInterval(0),
+  tickCount(0),
+  index(),
+  loadedBlock(0),
+  keyframe(),
+  ticks()
+{
+}
+
+ReplayReader::~ReplayReader()
+{
+  close();
+}
+
+bool ReplayReader::open(const std::string& _filename)
+{
+  close();
+  file = std::fopen(_filename.c_str(), "rb");
+  if (file == nullptr)
+  {
+    Log::error(TAG, "Could not open %s", _filename.c_str());
+    return false;
+  }
+  filename = _filename;
+
+  uint8_t header[REPLAY_HEADER_SIZE];
+  ByteReader in(header, sizeof(header));
+  const uint8_t* magic;
+  uint32_t version;
+  if (!readAt(file, 0, header, sizeof(header)) ||
+      !in.readBytes(magic, 4) || std::memcmp(magic, REPLAY_MAGIC, 4) != 0 ||
+      !in.readU32(version) || version != REPLAY_VERSION ||
+      !in.readU32(seed) || !in.readU32(tickRate) ||
+      !in.readU32(keyframeInterval))
+  {
+    Log::error(TAG, "%s is not a replay", filename.c_str());
+    close();
+    return false;
+  }
+
+  if (!readIndex())
+  {
+    Log::warning(
+      TAG,
+      "%s was not closed, reading the blocks that were written",
+      filename.c_str()
+      );
+    scanBlocks();
+  }
+  tickCount = index.empty() ?
+    0 : index.back().firstTick + index.back().tickCount;
+  loadedBlock = index.size();
+
+  Log::info(
+    TAG,
+    "Opened %s, %u ticks at %u/s in %u blocks",
+    filename.c_str(),
+    tickCount,
+    tickRate,
+    static_cast<unsigned>(index.size())
+    );
+  return true;
+}
+
+void ReplayReader::close()
+{
+  if (file != nullptr)
+  {
+    std::fclose(file);
+    file = nullptr;
+  }
+  index.clear();
+  keyframe.clear();
+  ticks.clear();
+  tickCount = 0;
+  loadedBlock = 0;
+}
+
+bool ReplayReader::isOpen() const
+{
+  return file != nullptr;
+}
+
+uint32_t ReplayReader::getSeed() const
+{
+  return seed;
+}
+
+uint32_t ReplayReader::getTickRate() const
+{
+  return tickRate;
+}
+
+uint32_t ReplayReader::getTickCount() const
+{
+  return tickCount;
+}
+
+bool ReplayReader::getTick(const uint32_t tick, InputState& state)
+{
+  const std::size_t block = findBlock(tick);
+  if (block == index.size() || !loadBlock(block))
+  {
+    return false;
+  }
+  state = ticks[tick - index[block].firstTick];
+  return true;
+}
+
+bool ReplayReader::getKeyframe(const uint32_t tick, uint32_t& keyTick,
+                               std::vector<uint8_t>& state)
+{
+  const std::size_t block = findBlock(std::min(tick, tickCount - 1));
+  if (block == index.size() || !loadBlock(block))
+  {
+    return false;
+  }
+  keyTick = index[block].firstTick;
+  state = keyframe;
+  return true;
+}
+
+bool ReplayReader::isKeyframeTick(const uint32_t tick) const
+{
+  const std::size_t block = findBlock(tick);
+  return block != index.size() && index[block].firstTick == tick;
+}
+
+bool ReplayReader::readIndex()
+{
+  if (std::fseek(file, 0, SEEK_END) != 0)
+  {
+    return false;
+  }
+  const long size = std::ftell(file);
+  uint8_t trailer[8];
+  ByteReader trailerIn(trailer, sizeof(trailer));
+  uint32_t offset;
+  const uint8_t* magic;
+  if (size < static_cast<long>(REPLAY_HEADER_SIZE + sizeof(trailer)) ||
+      !readAt(file, size - sizeof(trailer), trailer, sizeof(trailer)) ||
+      !trailerIn.readU32(offset) || !trailerIn.readBytes(magic, 4) ||
+      std::memcmp(magic, REPLAY_END_MAGIC, 4) != 0 ||
+      offset < REPLAY_HEADER_SIZE ||
+      offset > static_cast<uint32_t>(size - sizeof(trailer)))
+  {
+    return false;
+  }
+
+  std::vector<uint8_t> data(size - sizeof(trailer) - offset);
+  ByteReader in(data.data(), data.size());
+  uint32_t count;
+  if (!readAt(file, offset, data.data(), data.size()) ||
+      !in.readBytes(magic, 4) ||
+      std::memcmp(magic, REPLAY_INDEX_MAGIC, 4) != 0 ||
+      !in.readU32(count) || count > in.getRemaining() / 12)
+  {
+    return false;
+  }
+
+  index.resize(count);
+  for (auto& entry : index)
+  {
+    in.readU32(entry.firstTick);
+    in.readU32(entry.tickCount);
+    in.readU32(entry.offset);
+  }
+  return true;
+}
+
+void ReplayReader::scanBlocks()
+{
+  index.clear();
+  long offset = REPLAY_HEADER_SIZE;
+  uint8_t header[REPLAY_BLOCK_HEADER_SIZE];
+  while (readAt(file, offset, header, sizeof(header)))
+  {
+    ByteReader in(header, sizeof(header));
+    IndexEntry entry;
+    uint32_t rawSize;
+    uint32_t compressedSize;
+    in.readU32(entry.firstTick);
+    in.readU32(entry.tickCount);
+    in.readU32(rawSize);
+    in.readU32(compressedSize);
+    const uint32_t expected = index.empty() ?
+      0 : index.back().firstTick + index.back().tickCount;
+    if (entry.firstTick != expected || entry.tickCount == 0)
+    {
+      break;
+    }
+
+    // the last block may have been cut off while it was written
+    const long next = offset + sizeof(header) + compressedSize;
+    if (std::fseek(file, 0, SEEK_END) != 0 || std::ftell(file) < next)
+    {
+      break;
+    }
+    entry.offset = static_cast<uint32_t>(offset);
+    index.push_back(entry);
+    offset = next;
+  }
+}
+
+std::size_t ReplayReader::findBlock(const uint32_t tick) const
+{
+  if (tick >= tickCount)
+  {
+    return index.size();
+  }
+  // the last block starting at or before the tick
+  auto itr = std::upper_bound(
+    index.begin(),
+    index.end(),
+    tick,
+    [](const uint32_t t, const IndexEntry& entry) {
+      return t < entry.firstTick;
+    });
+  return static_cast<std::size_t>(itr - index.begin()) - 1;
+}
+
+bool ReplayReader::loadBlock(const std::size_t block)
+{
+  if (block == loadedBlock)
+  {
+    return true;
+  }
+  loadedBlock = index.size();
+
+  const IndexEntry& entry = index[block];
+  uint8_t header[REPLAY_BLOCK_HEADER_SIZE];
+  ByteReader headerIn(header, sizeof(header));
+  uint32_t firstTick;
+  uint32_t count;
+  uint32_t rawSize;
+  uint32_t compressedSize;
+  std::vector<uint8_t> compressed;
+  std::vector<uint8_t> raw;
+  bool ok =
+    readAt(file, entry.offset, header, sizeof(header)) &&
+    headerIn.readU32(firstTick) && headerIn.readU32(count) &&
+    headerIn.readU32(rawSize) && headerIn.readU32(compressedSize) &&
+    firstTick == entry.firstTick && count == entry.tickCount;
+  if (ok)
+  {
+    compressed.resize(compressedSize);
+    ok = std::fread(compressed.data(), 1, compressedSize, file) ==
+           compressedSize &&
+         lzDecompress(compressed.data(), compressedSize, raw) &&
+         raw.size() == rawSize;
+  }
+
+  ByteReader in(raw.data(), raw.size());
+  uint32_t keyframeSize;
+  const uint8_t* keyframeData;
+  ok = ok && in.readVarint(keyframeSize) &&
+       in.readBytes(keyframeData, keyframeSize);
+  if (ok)
+  {
+    keyframe.assign(keyframeData, keyframeData + keyframeSize);
+    ticks.clear();
+    while (ok && ticks.size() < count)
+    {
+      uint32_t run;
+      InputState state;
+      ok = in.readVarint(run) && run > 0 && run <= count - ticks.size() &&
+           in.readVarint(state.held) && in.readVarint(state.pressed) &&
+           in.readVarint(state.released);
+      if (ok)
+      {
+        ticks.insert(ticks.end(), run, state);
+      }
+    }
+  }
+
+  if (!ok)
+  {
+    Log::error(
+      TAG,
+      "Block at tick %u of %s is corrupt",
+      entry.firstTick,
+      filename.c_str()
+      );
+    return false;
+  }
+  loadedBlock = block;
+  return true;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "input/InputState.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * Reads a file written by ReplayWriter. Only the index is read up front, and
+ * blocks are loaded as their ticks are asked for, so playing or seeking in a
+ * long replay only ever holds one block in memory.
+ */
+class ReplayReader
+{
+private:
+  static const std::string TAG;
+
+  struct IndexEntry
+  {
+    uint32_t firstTick;
+    uint32_t tickCount;
+    uint32_t offset;
+  };
+
+  std::string filename;
+  std::FILE* file;
+  uint32_t seed;
+  uint32_t tickRate;
+  uint32_t keyframeInterval;
+  uint32_t tickCount;
+  std::vector<IndexEntry> index;
+
+  // the loaded block, or index.size() if none is
+  std::size_t loadedBlock;
+  std::vector<uint8_t> keyframe;
+  std::vector<InputState> ticks;
+
+public:
+  ReplayReader();
+  ~ReplayReader();
+  ReplayReader(const ReplayReader&) = delete;
+  ReplayReader& operator=(const ReplayReader&) = delete;
+
+  /**
+   * Reads the header and index.
+   * @return false if the file isn't a replay.
+   */
+  bool open(const std::string& _filename);
+  void close();
+  bool isOpen() const;
+
+  uint32_t getSeed() const;
+  uint32_t getTickRate() const;
+  uint32_t getTickCount() const;
+
+  /**
+   * Reads the input of a tick, loading its block if needed.
+   * @return false if the tick is past the end or its block is corrupt.
+   */
+  bool getTick(const uint32_t tick, InputState& state);
+
+  /**
+   * Finds the last keyframe at or before a tick.
+   * @param keyTick[out] The tick the keyframe was taken at.
+   * @param state[out] The saved world state.
+   */
+  bool getKeyframe(const uint32_t tick, uint32_t& keyTick,
+                   std::vector<uint8_t>& state);
+
+  // checks if a keyframe was taken right before a tick
+  bool isKeyframeTick(const uint32_t tick) const;
+
+private:
+  // reads the index at the end of the file
+  bool readIndex();
+  // rebuilds the index from the block headers, for unclosed replays
+  void scanBlocks();
+  // the block holding a tick
+  std::size_t findBlock(const uint32_t tick) const;
+  bool loadBlock(const std::size_t block);
+};
\ No newline at end of file
@@ -0,0 +1,249 @@
+#include "ReplayWriter.h"
+#include "input/ReplayFormat.h"
+#include "utility/ByteStream.h"
+#include "utility/Log.h"
+#include "utility/Lz.h"
+#include <algorithm>
+#include <cassert>
+
+const std::string ReplayWriter::TAG = "ReplayWriter";
+
+ReplayWriter::ReplayWriter()
+: filename(),
+  keyframeInterval(1),
+  tickCount(0),
+  current(),
+  mutex(),
+  wake(),
+  queued(),
+  stopping(false),
+  writer(),
+  file(nullptr),
+  index(),
+  raw(),
+  compressed(),
+  rawBytes(0),
+  compressedBytes(0),
+  failedWrites(0)
+{
+}
+
+ReplayWriter::~ReplayWriter()
+{
+  close();
+}
+
+bool ReplayWriter::open(const std::string& _filename, const uint32_t seed,
+                        const uint32_t tickRate,
+                        const uint32_t _keyframeInterval)
+{
+  assert(!isOpen());
+  file = std::fopen(_filename.c_str(), "wb");
+  if (file == nullptr)
+  {
+    Log::error(TAG, "Could not open %s", _filename.c_str());
+    return false;
+  }
+
+  std::vector<uint8_t> header;
+  ByteWriter out(header);
+  out.writeBytes(reinterpret_cast<const uint8_t*>(REPLAY_MAGIC), 4);
+  out.writeU32(REPLAY_VERSION);
+  out.writeU32(seed);
+  out.writeU32(tickRate);
+  out.writeU32(std::max(1u, _keyframeInterval));
+  std::fwrite(header.data(), 1, header.size(), file);
+
+  filename = _filename;
+  keyframeInterval = std::max(1u, _keyframeInterval);
+  tickCount = 0;
+  current = Block();
+  index.clear();
+  rawBytes = 0;
+  compressedBytes = 0;
+  failedWrites = 0;
+  stopping = false;
+  writer = std::thread(&ReplayWriter::writeLoop, this);
+
+  Log::info(
+    TAG,
+    "Recording to %s with a keyframe every %u ticks",
+    filename.c_str(),
+    keyframeInterval
+    );
+  return true;
+}
+
+void ReplayWriter::close()
+{
+  if (!isOpen())
+  {
+    return;
+  }
+
+  queueCurrent();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_one();
+  writer.join();
+
+  // the index goes at the end so it can list every block
+  const long indexOffset = std::ftell(file);
+  std::vector<uint8_t> trailer;
+  ByteWriter out(trailer);
+  out.writeBytes(reinterpret_cast<const uint8_t*>(REPLAY_INDEX_MAGIC), 4);
+  out.writeU32(static_cast<uint32_t>(index.size()));
+  for (auto& entry : index)
+  {
+    out.writeU32(entry.firstTick);
+    out.writeU32(entry.tickCount);
+    out.writeU32(entry.offset);
+  }
+  out.writeU32(static_cast<uint32_t>(indexOffset));
+  out.writeBytes(reinterpret_cast<const uint8_t*>(REPLAY_END_MAGIC), 4);
+  if (indexOffset < 0 ||
+      std::fwrite(trailer.data(), 1, trailer.size(), file) != trailer.size())
+  {
+    failedWrites++;
+  }
+  std::fclose(file);
+  file = nullptr;
+
+  Log::info(
+    TAG,
+    "Recorded %u ticks in %u blocks to %s, compressed %.1f:1",
+    tickCount,
+    static_cast<unsigned>(index.size()),
+    filename.c_str(),
+    compressedBytes > 0 ? static_cast<double>(rawBytes) / compressedBytes : 0.0
+    );
+  if (failedWrites > 0)
+  {
+    Log::error(
+      TAG,
+      "%u writes to %s failed",
+      failedWrites.load(),
+      filename.c_str()
+      );
+  }
+}
+
+bool ReplayWriter::isOpen() const
+{
+  return file != nullptr;
+}
+
+bool ReplayWriter::needsKeyframe() const
+{
+  return isOpen() && (tickCount % keyframeInterval) == 0;
+}
+
+void ReplayWriter::addKeyframe(std::vector<uint8_t>&& state)
+{
+  assert(needsKeyframe());
+  queueCurrent();
+  current.firstTick = tickCount;
+  current.keyframe = std::move(state);
+}
+
+void ReplayWriter::addTick(const InputState& state)
+{
+  assert(isOpen());
+  assert(current.firstTick + current.ticks.size() == tickCount);
+  current.ticks.push_back(state);
+  tickCount++;
+}
+
+void ReplayWriter::queueCurrent()
+{
+  if (current.ticks.empty())
+  {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queued.push_back(std::move(current));
+  }
+  wake.notify_one();
+  current = Block();
+}
+
+void ReplayWriter::writeLoop()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    wake.wait(lock, [this] { return stopping || !queued.empty(); });
+    if (queued.empty())
+    {
+      // stopping and everything has been written
+      return;
+    }
+
+    Block block = std::move(queued.front());
+    queued.pop_front();
+    lock.unlock();
+    write(block);
+    lock.lock();
+  }
+}
+
+void ReplayWriter::write(const Block& block)
+{
+  raw.clear();
+  ByteWriter body(raw);
+  body.writeVarint(static_cast<uint32_t>(block.keyframe.size()));
+  body.writeBytes(block.keyframe.data(), block.keyframe.size());
+  std::size_t i = 0;
+  while (i < block.ticks.size())
+  {
+    // most ticks are the same as the one before
+    const InputState& tick = block.ticks[i];
+    std::size_t run = 1;
+    while (i + run < block.ticks.size() &&
+           block.ticks[i + run].held == tick.held &&
+           block.ticks[i + run].pressed == tick.pressed &&
+           block.ticks[i + run].released == tick.released)
+    {
+      run++;
+    }
+    body.writeVarint(static_cast<uint32_t>(run));
+    body.writeVarint(tick.held);
+    body.writeVarint(tick.pressed);
+    body.writeVarint(tick.released);
+    i += run;
+  }
+  lzCompress(raw.data(), raw.size(), compressed);
+
+  std::vector<uint8_t> header;
+  ByteWriter out(header);
+  out.writeU32(block.firstTick);
+  out.writeU32(static_cast<uint32_t>(block.ticks.size()));
+  out.writeU32(static_cast<uint32_t>(raw.size()));
+  out.writeU32(static_cast<uint32_t>(compressed.size()));
+
+  const long offset = std::ftell(file);
+  const bool written =
+    offset >= 0 &&
+    std::fwrite(header.data(), 1, header.size(), file) == header.size() &&
+    std::fwrite(compressed.data(), 1, compressed.size(), file) ==
+      compressed.size();
+  if (!written)
+  {
+    failedWrites++;
+    return;
+  }
+  // flushed so a crash still leaves every finished block readable
+  std::fflush(file);
+
+  IndexEntry entry;
+  entry.firstTick = block.firstTick;
+  entry.tickCount = static_cast<uint32_t>(block.ticks.size());
+  entry.offset = static_cast<uint32_t>(offset);
+  index.push_back(entry);
+  rawBytes += raw.size();
+  compressedBytes += compressed.size();
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "input/InputState.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Writes a replay file as the game runs. Every keyframe interval the world
+ * state is saved as a keyframe, and it starts a block with the input of the
+ * ticks up to the next one, so a reader can jump to any keyframe and only
+ * simulate the ticks after it. Finished blocks are compressed and written by
+ * a background thread, so the main loop only ever copies a tick's input.
+ * See ReplayFormat.h for the file layout.
+ */
+class ReplayWriter
+{
+private:
+  static const std::string TAG;
+
+  struct Block
+  {
+    uint32_t firstTick;
+    std::vector<uint8_t> keyframe;
+    std::vector<InputState> ticks;
+  };
+
+  struct IndexEntry
+  {
+    uint32_t firstTick;
+    uint32_t tickCount;
+    uint32_t offset;
+  };
+
+  std::string filename;
+  uint32_t keyframeInterval;
+  // ticks added so far
+  uint32_t tickCount;
+  // the block being filled, only touched by the main thread
+  Block current;
+
+  std::mutex mutex;
+  // signals the writer that a block was queued or the replay is closing
+  std::condition_variable wake;
+  std::deque<Block> queued;
+  bool stopping;
+  std::thread writer;
+
+  // only touched by the writer thread until it is joined
+  std::FILE* file;
+  std::vector<IndexEntry> index;
+  std::vector<uint8_t> raw;
+  std::vector<uint8_t> compressed;
+  uint64_t rawBytes;
+  uint64_t compressedBytes;
+  // the log isn't thread safe, failures are reported when the replay closes
+  std::atomic<unsigned> failedWrites;
+
+public:
+  ReplayWriter();
+  ~ReplayWriter();
+  ReplayWriter(const ReplayWriter&) = delete;
+  ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+  /**
+   * Creates the file and starts the writer thread.
+   * @param _keyframeInterval Ticks between keyframes.
+   * @return false if the file couldn't be created.
+   */
+  bool open(const std::string& _filename, const uint32_t seed,
+            const uint32_t tickRate, const uint32_t _keyframeInterval);
+
+  /**
+   * Writes whatever is left and the index, then stops the writer thread.
+   */
+  void close();
+
+  bool isOpen() const;
+
+  /**
+   * Checks if the next tick starts a block, and needs a keyframe first.
+   */
+  bool needsKeyframe() const;
+
+  /**
+   * Starts a block with the world state as of the next tick.
+   */
+  void addKeyframe(std::vector<uint8_t>&& state);
+
+  /**
+   * Adds the input of a tick to the current block.
+   */
+  void addTick(const InputState& state);
+
+private:
+  void queueCurrent();
+  void writeLoop();
+  // compresses a block and appends it to the file
+  void write(const Block& block);
+};
\ No newline at end of file
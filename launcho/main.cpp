@@ -2,9 +2,13 @@
 #include "GameOptions.h"
 #include "options.h"
 #include "utility/Log.h"
+#include "benchmarks/Benchmark.h"
+#include "graphics/FrameCapture.h"
 #include <string>
 
 static const std::string TAG = "main";
+// options are loaded from here, then overridden by the command line
+static const std::string CONFIG_FILE = "launcho.cfg";
 
 int main(int argc, char* argv[])
 {
@@ -21,12 +25,69 @@ int main(int argc, char* argv[])
   GameOptions::getInstance().setString(WINDOW_TITLE, "Launch-o-Libre");
   GameOptions::getInstance().setInt(SCREEN_WIDTH, 800);
   GameOptions::getInstance().setInt(SCREEN_HEIGHT, 600);
-  
-  // TODO: Implement these
-  //GameOptions::getInstance().loadFromFile("filename goes here");
-  //GameOptions::getInstance().parseCommandLine(argc, argv); 
-  
+  GameOptions::getInstance().setString(RENDER_SYSTEM, "sfml");
+  GameOptions::getInstance().setInt(MAX_FRAMES, 0);
+  GameOptions::getInstance().setInt(LOGIC_TICK_RATE, 30);
+  GameOptions::getInstance().setFloat(EVENT_BUDGET, 5.0f);
+  GameOptions::getInstance().setInt(PHYSICS_STEP_RATE, 60);
+  GameOptions::getInstance().setInt(PHYSICS_VELOCITY_ITERATIONS, 8);
+  GameOptions::getInstance().setInt(PHYSICS_POSITION_ITERATIONS, 3);
+  GameOptions::getInstance().setInt(OPTIONS_WATCH, 1);
+  GameOptions::getInstance().setString(INPUT_MOVE_UP, "Up,W");
+  GameOptions::getInstance().setString(INPUT_MOVE_DOWN, "Down,S");
+  GameOptions::getInstance().setString(INPUT_MOVE_LEFT, "Left,A");
+  GameOptions::getInstance().setString(INPUT_MOVE_RIGHT, "Right,D");
+  GameOptions::getInstance().setString(INPUT_FIRE, "Space");
+  GameOptions::getInstance().setString(INPUT_RECORD, "");
+  GameOptions::getInstance().setInt(INPUT_KEYFRAME_INTERVAL, 300);
+  GameOptions::getInstance().setString(INPUT_REPLAY, "");
+  GameOptions::getInstance().setFloat(REPLAY_SEEK, 0.0f);
+  GameOptions::getInstance().setInt(RANDOM_SEED, 0);
+  GameOptions::getInstance().setString(NET_MODE, "");
+  GameOptions::getInstance().setString(NET_ADDRESS, "127.0.0.1");
+  GameOptions::getInstance().setInt(NET_PORT, 27015);
+  GameOptions::getInstance().setInt(NET_SNAPSHOT_RATE, 10);
+  GameOptions::getInstance().setFloat(NET_TIMEOUT, 5.0f);
+  GameOptions::getInstance().setInt(WORKER_THREADS, -1);
+  GameOptions::getInstance().setString(SPATIAL_INDEX, "quadtree");
+  GameOptions::getInstance().setInt(STATS_OVERLAY, 1);
+  GameOptions::getInstance().setInt(RENDER_BATCHING, 1);
+  GameOptions::getInstance().setInt(RENDER_CULLING, 1);
+  GameOptions::getInstance().setInt(RENDER_LAYER_CACHE, 1);
+  GameOptions::getInstance().setInt(DYNAMIC_RESOLUTION_BUDGET, 14);
+  GameOptions::getInstance().setInt(DYNAMIC_RESOLUTION_MIN, 50);
+  GameOptions::getInstance().setString(RENDER_DUMP_PREFIX, "");
+  GameOptions::getInstance().setInt(RENDER_DUMP_INTERVAL, 60);
+  GameOptions::getInstance().setString(RENDER_DUMP_FORMAT, "ppm");
+  GameOptions::getInstance().setString(CAPTURE_PREFIX, "");
+  GameOptions::getInstance().setInt(CAPTURE_INTERVAL, 1);
+  GameOptions::getInstance().setString(CAPTURE_FORMAT, "lz");
+  GameOptions::getInstance().setInt(CAPTURE_BUFFERS, 4);
+  GameOptions::getInstance().setString(CAPTURE_EXTRACT, "");
+
+  GameOptions::getInstance().loadFromFile(CONFIG_FILE);
+  GameOptions::getInstance().parseCommandLine(argc, argv);
+  // logs what the file and command line changed
+  GameOptions::getInstance().update();
+
   GameOptions::getInstance().dumpToLog();
+#ifdef LAUNCHO_BENCHMARK
+  Benchmark::runAll();
+#else
+  const std::string extract =
+    GameOptions::getInstance().getString(CAPTURE_EXTRACT);
+  if (!extract.empty())
+  {
+    // frames are written next to the stream
+    const std::string outPrefix = extract.substr(0, extract.rfind('.'));
+    return FrameCapture::extract(extract, outPrefix) ? 0 : 1;
+  }
+  if (GameOptions::getInstance().getInt(OPTIONS_WATCH) != 0)
+  {
+    GameOptions::getInstance().watchFile(CONFIG_FILE);
+  }
   Game::getInstance().run();
+  GameOptions::getInstance().stopWatchingFile();
+#endif
   return 0;
 }
\ No newline at end of file
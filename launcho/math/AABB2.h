@@ -8,43 +8,165 @@
 class AABB2
 {
 public:
+  /**
+   * Builds a box from its lower left and upper right corners.
+   */
+  static constexpr AABB2 fromCorners(const Vector2& lowerLeft,
+                                     const Vector2& upperRight);
+
   // center of the box (pretend vector is a point)
   Vector2 center;
   // width is 2*x component, height is 2*y component
   Vector2 halfSize;
 
   // constructors
-  AABB2();
-  AABB2(const float x, const float y, const float _width, const float _height);
-  AABB2(const Vector2& _center, const float _width, const float _height);
-  AABB2(const Vector2& _center, const Vector2& _halfSize);
-  AABB2(const Vector2& _center, float sideLength);
-  AABB2(const AABB2& copy);
-  AABB2& operator=(const AABB2& rhs);
+  constexpr AABB2();
+  constexpr AABB2(const float x, const float y, const float _width,
+                  const float _height);
+  constexpr AABB2(const Vector2& _center, const float _width,
+                  const float _height);
+  constexpr AABB2(const Vector2& _center, const Vector2& _halfSize);
+  constexpr AABB2(const Vector2& _center, float sideLength);
 
   /**
    * Using vector as a point, checks if the point is in this box.
    */
-  bool contains(const Vector2& pt) const;
+  constexpr bool contains(const Vector2& pt) const;
+
+  /**
+   * Checks if other is completely inside this box.
+   */
+  constexpr bool contains(const AABB2& other) const;
 
   /**
    * Checks if these boxes have an intersection.
    */
-  bool intersect(const AABB2& other) const;
+  constexpr bool intersect(const AABB2& other) const;
+
+  /**
+   * Returns the squared distance from a point to the closest point on the box,
+   * 0 if the point is inside.
+   */
+  constexpr float distanceSquared(const Vector2& pt) const;
 
   // box information
-  float width() const;
-  float height() const;
-  float area() const;
-  float perimeter() const;
+  constexpr float width() const;
+  constexpr float height() const;
+  constexpr float area() const;
+  constexpr float perimeter() const;
 
   /**
    * Returns the lower left corner of the box.
    */
-  Vector2 lowerLeft() const;
+  constexpr Vector2 lowerLeft() const;
 
-  /** 
+  /**
    * Returns the upper right corner of the box.
    */
-  Vector2 upperRight() const;
-};
\ No newline at end of file
+  constexpr Vector2 upperRight() const;
+
+private:
+  // std::fabs is not constexpr
+  static constexpr float absf(const float f);
+  // distance along one axis from the edge of the box, 0 if inside
+  static constexpr float excess(const float delta, const float half);
+};
+
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+
+constexpr AABB2 AABB2::fromCorners(const Vector2& lowerLeft,
+                                   const Vector2& upperRight)
+{
+  return AABB2((lowerLeft + upperRight) * 0.5f,
+               (upperRight - lowerLeft) * 0.5f);
+}
+
+constexpr AABB2::AABB2()
+  : center(), halfSize()
+{}
+
+constexpr AABB2::AABB2(const float x, const float y, const float _width,
+                       const float _height)
+  : center(x, y), halfSize(_width / 2.0f, _height / 2.0f)
+{}
+
+constexpr AABB2::AABB2(const Vector2& _center, const float _width,
+                       const float _height)
+  : center(_center), halfSize(_width / 2.0f, _height / 2.0f)
+{}
+
+constexpr AABB2::AABB2(const Vector2& _center, const Vector2& _halfSize)
+  : center(_center), halfSize(_halfSize)
+{}
+
+constexpr AABB2::AABB2(const Vector2& _center, float sideLength)
+  : center(_center), halfSize(sideLength / 2.0f, sideLength / 2.0f)
+{}
+
+constexpr bool AABB2::contains(const Vector2& pt) const
+{
+  return (absf(center.x - pt.x) <= halfSize.x) &&
+         (absf(center.y - pt.y) <= halfSize.y);
+}
+
+constexpr bool AABB2::contains(const AABB2& other) const
+{
+  return (absf(center.x - other.center.x) + other.halfSize.x <= halfSize.x) &&
+         (absf(center.y - other.center.y) + other.halfSize.y <= halfSize.y);
+}
+
+constexpr bool AABB2::intersect(const AABB2& other) const
+{
+  return (absf(center.x - other.center.x) <= halfSize.x + other.halfSize.x) &&
+         (absf(center.y - other.center.y) <= halfSize.y + other.halfSize.y);
+}
+
+constexpr float AABB2::distanceSquared(const Vector2& pt) const
+{
+  return (excess(pt.x - center.x, halfSize.x) *
+          excess(pt.x - center.x, halfSize.x)) +
+         (excess(pt.y - center.y, halfSize.y) *
+          excess(pt.y - center.y, halfSize.y));
+}
+
+constexpr float AABB2::width() const
+{
+  return halfSize.x * 2.0f;
+}
+
+constexpr float AABB2::height() const
+{
+  return halfSize.y * 2.0f;
+}
+
+constexpr float AABB2::area() const
+{
+  return width() * height();
+}
+
+constexpr float AABB2::perimeter() const
+{
+  return (width() + height()) * 2.0f;
+}
+
+constexpr Vector2 AABB2::lowerLeft() const
+{
+  return center - halfSize;
+}
+
+constexpr Vector2 AABB2::upperRight() const
+{
+  return center + halfSize;
+}
+
+constexpr float AABB2::absf(const float f)
+{
+  return f < 0.0f ? -f : f;
+}
+
+constexpr float AABB2::excess(const float delta, const float half)
+{
+  return absf(delta) > half ? absf(delta) - half : 0.0f;
+}
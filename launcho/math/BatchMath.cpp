@@ -0,0 +1,898 @@
+#include "math/BatchMath.h"
+#include "utility/CpuFeatures.h"
+#include <cassert>
+#include <cmath>
+
+#if LAUNCHO_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+/****************************************************************************
+ * Array containers
+ ****************************************************************************/
+
+std::size_t Vector2Array::size() const
+{
+  return x.size();
+}
+
+void Vector2Array::resize(const std::size_t count)
+{
+  x.resize(count);
+  y.resize(count);
+}
+
+void Vector2Array::clear()
+{
+  x.clear();
+  y.clear();
+}
+
+void Vector2Array::push_back(const Vector2& v)
+{
+  x.push_back(v.x);
+  y.push_back(v.y);
+}
+
+Vector2 Vector2Array::get(const std::size_t i) const
+{
+  return Vector2(x[i], y[i]);
+}
+
+void Vector2Array::set(const std::size_t i, const Vector2& v)
+{
+  x[i] = v.x;
+  y[i] = v.y;
+}
+
+std::size_t AABB2Array::size() const
+{
+  return centerX.size();
+}
+
+void AABB2Array::resize(const std::size_t count)
+{
+  centerX.resize(count);
+  centerY.resize(count);
+  halfX.resize(count);
+  halfY.resize(count);
+}
+
+void AABB2Array::clear()
+{
+  centerX.clear();
+  centerY.clear();
+  halfX.clear();
+  halfY.clear();
+}
+
+void AABB2Array::push_back(const AABB2& box)
+{
+  centerX.push_back(box.center.x);
+  centerY.push_back(box.center.y);
+  halfX.push_back(box.halfSize.x);
+  halfY.push_back(box.halfSize.y);
+}
+
+AABB2 AABB2Array::get(const std::size_t i) const
+{
+  return AABB2(Vector2(centerX[i], centerY[i]), Vector2(halfX[i], halfY[i]));
+}
+
+void AABB2Array::set(const std::size_t i, const AABB2& box)
+{
+  centerX[i] = box.center.x;
+  centerY[i] = box.center.y;
+  halfX[i] = box.halfSize.x;
+  halfY[i] = box.halfSize.y;
+}
+
+/****************************************************************************
+ * Kernels
+ ****************************************************************************/
+
+// raw pointers into an AABB2Array
+struct BoxPtrs
+{
+  const float* cx;
+  const float* cy;
+  const float* hx;
+  const float* hy;
+};
+
+static BoxPtrs boxPtrs(const AABB2Array& boxes)
+{
+  BoxPtrs p = {
+    boxes.centerX.data(),
+    boxes.centerY.data(),
+    boxes.halfX.data(),
+    boxes.halfY.data()
+  };
+  return p;
+}
+
+// shortest length that Vector2::normalize() will scale
+static const float MIN_NORMALIZE_LENGTH = 1e-8f;
+
+// Every kernel processes elements [begin, end) so that the SIMD versions can
+// hand their leftover elements to the scalar version.
+
+static void transformScalar(const Transform2& t, const float* x,
+                            const float* y, float* ox, float* oy,
+                            std::size_t begin, std::size_t end)
+{
+  for (std::size_t i = begin; i < end; i++)
+  {
+    const float px = x[i];
+    const float py = y[i];
+    ox[i] = (t.m00 * px) + (t.m01 * py) + t.m02;
+    oy[i] = (t.m10 * px) + (t.m11 * py) + t.m12;
+  }
+}
+
+static std::size_t intersectOneScalar(const AABB2& box, const BoxPtrs& b,
+                                      std::size_t begin, std::size_t end,
+                                      uint32_t* out)
+{
+  std::size_t count = 0;
+  for (std::size_t i = begin; i < end; i++)
+  {
+    const bool hit =
+      (std::fabs(box.center.x - b.cx[i]) <= box.halfSize.x + b.hx[i]) &&
+      (std::fabs(box.center.y - b.cy[i]) <= box.halfSize.y + b.hy[i]);
+    out[count] = static_cast<uint32_t>(i);
+    count += hit ? 1 : 0;
+  }
+  return count;
+}
+
+static void intersectPairsScalar(const BoxPtrs& a, const BoxPtrs& b,
+                                 std::size_t begin, std::size_t end,
+                                 uint8_t* out)
+{
+  for (std::size_t i = begin; i < end; i++)
+  {
+    out[i] = (std::fabs(a.cx[i] - b.cx[i]) <= a.hx[i] + b.hx[i]) &&
+             (std::fabs(a.cy[i] - b.cy[i]) <= a.hy[i] + b.hy[i]);
+  }
+}
+
+static std::size_t containsOneScalar(const AABB2& box, const float* x,
+                                     const float* y, std::size_t begin,
+                                     std::size_t end, uint32_t* out)
+{
+  std::size_t count = 0;
+  for (std::size_t i = begin; i < end; i++)
+  {
+    const bool hit = (std::fabs(box.center.x - x[i]) <= box.halfSize.x) &&
+                     (std::fabs(box.center.y - y[i]) <= box.halfSize.y);
+    out[count] = static_cast<uint32_t>(i);
+    count += hit ? 1 : 0;
+  }
+  return count;
+}
+
+static void containsPairsScalar(const BoxPtrs& b, const float* x,
+                                const float* y, std::size_t begin,
+                                std::size_t end, uint8_t* out)
+{
+  for (std::size_t i = begin; i < end; i++)
+  {
+    out[i] = (std::fabs(b.cx[i] - x[i]) <= b.hx[i]) &&
+             (std::fabs(b.cy[i] - y[i]) <= b.hy[i]);
+  }
+}
+
+static void distanceOneScalar(const Vector2& pt, const float* x,
+                              const float* y, std::size_t begin,
+                              std::size_t end, float* out)
+{
+  for (std::size_t i = begin; i < end; i++)
+  {
+    const float dx = pt.x - x[i];
+    const float dy = pt.y - y[i];
+    out[i] = std::sqrt((dx * dx) + (dy * dy));
+  }
+}
+
+static void distancePairsScalar(const float* ax, const float* ay,
+                                const float* bx, const float* by,
+                                std::size_t begin, std::size_t end, float* out)
+{
+  for (std::size_t i = begin; i < end; i++)
+  {
+    const float dx = ax[i] - bx[i];
+    const float dy = ay[i] - by[i];
+    out[i] = std::sqrt((dx * dx) + (dy * dy));
+  }
+}
+
+static void normalizeScalar(float* x, float* y, std::size_t begin,
+                            std::size_t end)
+{
+  for (std::size_t i = begin; i < end; i++)
+  {
+    const float len = std::sqrt((x[i] * x[i]) + (y[i] * y[i]));
+    if (len >= MIN_NORMALIZE_LENGTH)
+    {
+      x[i] /= len;
+      y[i] /= len;
+    }
+  }
+}
+
+#if LAUNCHO_X86
+
+// writes the indices of the set bits in mask, returns how many were written
+static inline std::size_t emitIndices(int mask, int lanes, std::size_t base,
+                                      uint32_t* out)
+{
+  std::size_t count = 0;
+  for (int lane = 0; lane < lanes; lane++)
+  {
+    out[count] = static_cast<uint32_t>(base + lane);
+    count += (mask >> lane) & 1;
+  }
+  return count;
+}
+
+static inline void emitFlags(int mask, int lanes, uint8_t* out)
+{
+  for (int lane = 0; lane < lanes; lane++)
+  {
+    out[lane] = static_cast<uint8_t>((mask >> lane) & 1);
+  }
+}
+
+/****************************************************************************
+ * SSE2, 4 lanes
+ ****************************************************************************/
+
+static inline __m128 absSse(__m128 v)
+{
+  return _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+}
+
+static void transformSse2(const Transform2& t, const float* x, const float* y,
+                          float* ox, float* oy, std::size_t n)
+{
+  const __m128 m00 = _mm_set1_ps(t.m00);
+  const __m128 m01 = _mm_set1_ps(t.m01);
+  const __m128 m02 = _mm_set1_ps(t.m02);
+  const __m128 m10 = _mm_set1_ps(t.m10);
+  const __m128 m11 = _mm_set1_ps(t.m11);
+  const __m128 m12 = _mm_set1_ps(t.m12);
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m128 px = _mm_loadu_ps(x + i);
+    const __m128 py = _mm_loadu_ps(y + i);
+    const __m128 rx =
+      _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, px), _mm_mul_ps(m01, py)), m02);
+    const __m128 ry =
+      _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, px), _mm_mul_ps(m11, py)), m12);
+    _mm_storeu_ps(ox + i, rx);
+    _mm_storeu_ps(oy + i, ry);
+  }
+  transformScalar(t, x, y, ox, oy, i, n);
+}
+
+static std::size_t intersectOneSse2(const AABB2& box, const BoxPtrs& b,
+                                    std::size_t n, uint32_t* out)
+{
+  const __m128 cx = _mm_set1_ps(box.center.x);
+  const __m128 cy = _mm_set1_ps(box.center.y);
+  const __m128 hx = _mm_set1_ps(box.halfSize.x);
+  const __m128 hy = _mm_set1_ps(box.halfSize.y);
+
+  std::size_t count = 0;
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m128 dx = absSse(_mm_sub_ps(cx, _mm_loadu_ps(b.cx + i)));
+    const __m128 dy = absSse(_mm_sub_ps(cy, _mm_loadu_ps(b.cy + i)));
+    const __m128 ex = _mm_add_ps(hx, _mm_loadu_ps(b.hx + i));
+    const __m128 ey = _mm_add_ps(hy, _mm_loadu_ps(b.hy + i));
+    const __m128 hit = _mm_and_ps(_mm_cmple_ps(dx, ex), _mm_cmple_ps(dy, ey));
+    count += emitIndices(_mm_movemask_ps(hit), 4, i, out + count);
+  }
+  return count + intersectOneScalar(box, b, i, n, out + count);
+}
+
+static void intersectPairsSse2(const BoxPtrs& a, const BoxPtrs& b,
+                               std::size_t n, uint8_t* out)
+{
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m128 dx =
+      absSse(_mm_sub_ps(_mm_loadu_ps(a.cx + i), _mm_loadu_ps(b.cx + i)));
+    const __m128 dy =
+      absSse(_mm_sub_ps(_mm_loadu_ps(a.cy + i), _mm_loadu_ps(b.cy + i)));
+    const __m128 ex = _mm_add_ps(_mm_loadu_ps(a.hx + i), _mm_loadu_ps(b.hx + i));
+    const __m128 ey = _mm_add_ps(_mm_loadu_ps(a.hy + i), _mm_loadu_ps(b.hy + i));
+    const __m128 hit = _mm_and_ps(_mm_cmple_ps(dx, ex), _mm_cmple_ps(dy, ey));
+    emitFlags(_mm_movemask_ps(hit), 4, out + i);
+  }
+  intersectPairsScalar(a, b, i, n, out);
+}
+
+static std::size_t containsOneSse2(const AABB2& box, const float* x,
+                                   const float* y, std::size_t n,
+                                   uint32_t* out)
+{
+  const __m128 cx = _mm_set1_ps(box.center.x);
+  const __m128 cy = _mm_set1_ps(box.center.y);
+  const __m128 hx = _mm_set1_ps(box.halfSize.x);
+  const __m128 hy = _mm_set1_ps(box.halfSize.y);
+
+  std::size_t count = 0;
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m128 dx = absSse(_mm_sub_ps(cx, _mm_loadu_ps(x + i)));
+    const __m128 dy = absSse(_mm_sub_ps(cy, _mm_loadu_ps(y + i)));
+    const __m128 hit = _mm_and_ps(_mm_cmple_ps(dx, hx), _mm_cmple_ps(dy, hy));
+    count += emitIndices(_mm_movemask_ps(hit), 4, i, out + count);
+  }
+  return count + containsOneScalar(box, x, y, i, n, out + count);
+}
+
+static void containsPairsSse2(const BoxPtrs& b, const float* x,
+                              const float* y, std::size_t n, uint8_t* out)
+{
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m128 dx =
+      absSse(_mm_sub_ps(_mm_loadu_ps(b.cx + i), _mm_loadu_ps(x + i)));
+    const __m128 dy =
+      absSse(_mm_sub_ps(_mm_loadu_ps(b.cy + i), _mm_loadu_ps(y + i)));
+    const __m128 hit = _mm_and_ps(
+      _mm_cmple_ps(dx, _mm_loadu_ps(b.hx + i)),
+      _mm_cmple_ps(dy, _mm_loadu_ps(b.hy + i))
+      );
+    emitFlags(_mm_movemask_ps(hit), 4, out + i);
+  }
+  containsPairsScalar(b, x, y, i, n, out);
+}
+
+static void distanceOneSse2(const Vector2& pt, const float* x, const float* y,
+                            std::size_t n, float* out)
+{
+  const __m128 ptx = _mm_set1_ps(pt.x);
+  const __m128 pty = _mm_set1_ps(pt.y);
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m128 dx = _mm_sub_ps(ptx, _mm_loadu_ps(x + i));
+    const __m128 dy = _mm_sub_ps(pty, _mm_loadu_ps(y + i));
+    const __m128 sq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    _mm_storeu_ps(out + i, _mm_sqrt_ps(sq));
+  }
+  distanceOneScalar(pt, x, y, i, n, out);
+}
+
+static void distancePairsSse2(const float* ax, const float* ay,
+                              const float* bx, const float* by, std::size_t n,
+                              float* out)
+{
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m128 dx = _mm_sub_ps(_mm_loadu_ps(ax + i), _mm_loadu_ps(bx + i));
+    const __m128 dy = _mm_sub_ps(_mm_loadu_ps(ay + i), _mm_loadu_ps(by + i));
+    const __m128 sq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+    _mm_storeu_ps(out + i, _mm_sqrt_ps(sq));
+  }
+  distancePairsScalar(ax, ay, bx, by, i, n, out);
+}
+
+static void normalizeSse2(float* x, float* y, std::size_t n)
+{
+  const __m128 minLen = _mm_set1_ps(MIN_NORMALIZE_LENGTH);
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m128 vx = _mm_loadu_ps(x + i);
+    const __m128 vy = _mm_loadu_ps(y + i);
+    const __m128 len =
+      _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)));
+    // lanes that are too short keep their original value
+    const __m128 keep = _mm_cmplt_ps(len, minLen);
+    const __m128 nx = _mm_div_ps(vx, len);
+    const __m128 ny = _mm_div_ps(vy, len);
+    _mm_storeu_ps(x + i, _mm_or_ps(_mm_and_ps(keep, vx), _mm_andnot_ps(keep, nx)));
+    _mm_storeu_ps(y + i, _mm_or_ps(_mm_and_ps(keep, vy), _mm_andnot_ps(keep, ny)));
+  }
+  normalizeScalar(x, y, i, n);
+}
+
+/****************************************************************************
+ * AVX2, 8 lanes
+ ****************************************************************************/
+
+LAUNCHO_TARGET_AVX2
+static inline __m256 absAvx(__m256 v)
+{
+  return _mm256_and_ps(v, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)));
+}
+
+LAUNCHO_TARGET_AVX2
+static void transformAvx2(const Transform2& t, const float* x, const float* y,
+                          float* ox, float* oy, std::size_t n)
+{
+  const __m256 m00 = _mm256_set1_ps(t.m00);
+  const __m256 m01 = _mm256_set1_ps(t.m01);
+  const __m256 m02 = _mm256_set1_ps(t.m02);
+  const __m256 m10 = _mm256_set1_ps(t.m10);
+  const __m256 m11 = _mm256_set1_ps(t.m11);
+  const __m256 m12 = _mm256_set1_ps(t.m12);
+
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256 px = _mm256_loadu_ps(x + i);
+    const __m256 py = _mm256_loadu_ps(y + i);
+    const __m256 rx = _mm256_add_ps(
+      _mm256_add_ps(_mm256_mul_ps(m00, px), _mm256_mul_ps(m01, py)),
+      m02
+      );
+    const __m256 ry = _mm256_add_ps(
+      _mm256_add_ps(_mm256_mul_ps(m10, px), _mm256_mul_ps(m11, py)),
+      m12
+      );
+    _mm256_storeu_ps(ox + i, rx);
+    _mm256_storeu_ps(oy + i, ry);
+  }
+  _mm256_zeroupper();
+  transformScalar(t, x, y, ox, oy, i, n);
+}
+
+LAUNCHO_TARGET_AVX2
+static std::size_t intersectOneAvx2(const AABB2& box, const BoxPtrs& b,
+                                    std::size_t n, uint32_t* out)
+{
+  const __m256 cx = _mm256_set1_ps(box.center.x);
+  const __m256 cy = _mm256_set1_ps(box.center.y);
+  const __m256 hx = _mm256_set1_ps(box.halfSize.x);
+  const __m256 hy = _mm256_set1_ps(box.halfSize.y);
+
+  std::size_t count = 0;
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256 dx = absAvx(_mm256_sub_ps(cx, _mm256_loadu_ps(b.cx + i)));
+    const __m256 dy = absAvx(_mm256_sub_ps(cy, _mm256_loadu_ps(b.cy + i)));
+    const __m256 ex = _mm256_add_ps(hx, _mm256_loadu_ps(b.hx + i));
+    const __m256 ey = _mm256_add_ps(hy, _mm256_loadu_ps(b.hy + i));
+    const __m256 hit = _mm256_and_ps(
+      _mm256_cmp_ps(dx, ex, _CMP_LE_OQ),
+      _mm256_cmp_ps(dy, ey, _CMP_LE_OQ)
+      );
+    count += emitIndices(_mm256_movemask_ps(hit), 8, i, out + count);
+  }
+  _mm256_zeroupper();
+  return count + intersectOneScalar(box, b, i, n, out + count);
+}
+
+LAUNCHO_TARGET_AVX2
+static void intersectPairsAvx2(const BoxPtrs& a, const BoxPtrs& b,
+                               std::size_t n, uint8_t* out)
+{
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256 dx = absAvx(
+      _mm256_sub_ps(_mm256_loadu_ps(a.cx + i), _mm256_loadu_ps(b.cx + i))
+      );
+    const __m256 dy = absAvx(
+      _mm256_sub_ps(_mm256_loadu_ps(a.cy + i), _mm256_loadu_ps(b.cy + i))
+      );
+    const __m256 ex =
+      _mm256_add_ps(_mm256_loadu_ps(a.hx + i), _mm256_loadu_ps(b.hx + i));
+    const __m256 ey =
+      _mm256_add_ps(_mm256_loadu_ps(a.hy + i), _mm256_loadu_ps(b.hy + i));
+    const __m256 hit = _mm256_and_ps(
+      _mm256_cmp_ps(dx, ex, _CMP_LE_OQ),
+      _mm256_cmp_ps(dy, ey, _CMP_LE_OQ)
+      );
+    emitFlags(_mm256_movemask_ps(hit), 8, out + i);
+  }
+  _mm256_zeroupper();
+  intersectPairsScalar(a, b, i, n, out);
+}
+
+LAUNCHO_TARGET_AVX2
+static std::size_t containsOneAvx2(const AABB2& box, const float* x,
+                                   const float* y, std::size_t n,
+                                   uint32_t* out)
+{
+  const __m256 cx = _mm256_set1_ps(box.center.x);
+  const __m256 cy = _mm256_set1_ps(box.center.y);
+  const __m256 hx = _mm256_set1_ps(box.halfSize.x);
+  const __m256 hy = _mm256_set1_ps(box.halfSize.y);
+
+  std::size_t count = 0;
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256 dx = absAvx(_mm256_sub_ps(cx, _mm256_loadu_ps(x + i)));
+    const __m256 dy = absAvx(_mm256_sub_ps(cy, _mm256_loadu_ps(y + i)));
+    const __m256 hit = _mm256_and_ps(
+      _mm256_cmp_ps(dx, hx, _CMP_LE_OQ),
+      _mm256_cmp_ps(dy, hy, _CMP_LE_OQ)
+      );
+    count += emitIndices(_mm256_movemask_ps(hit), 8, i, out + count);
+  }
+  _mm256_zeroupper();
+  return count + containsOneScalar(box, x, y, i, n, out + count);
+}
+
+LAUNCHO_TARGET_AVX2
+static void containsPairsAvx2(const BoxPtrs& b, const float* x,
+                              const float* y, std::size_t n, uint8_t* out)
+{
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256 dx = absAvx(
+      _mm256_sub_ps(_mm256_loadu_ps(b.cx + i), _mm256_loadu_ps(x + i))
+      );
+    const __m256 dy = absAvx(
+      _mm256_sub_ps(_mm256_loadu_ps(b.cy + i), _mm256_loadu_ps(y + i))
+      );
+    const __m256 hit = _mm256_and_ps(
+      _mm256_cmp_ps(dx, _mm256_loadu_ps(b.hx + i), _CMP_LE_OQ),
+      _mm256_cmp_ps(dy, _mm256_loadu_ps(b.hy + i), _CMP_LE_OQ)
+      );
+    emitFlags(_mm256_movemask_ps(hit), 8, out + i);
+  }
+  _mm256_zeroupper();
+  containsPairsScalar(b, x, y, i, n, out);
+}
+
+LAUNCHO_TARGET_AVX2
+static void distanceOneAvx2(const Vector2& pt, const float* x, const float* y,
+                            std::size_t n, float* out)
+{
+  const __m256 ptx = _mm256_set1_ps(pt.x);
+  const __m256 pty = _mm256_set1_ps(pt.y);
+
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256 dx = _mm256_sub_ps(ptx, _mm256_loadu_ps(x + i));
+    const __m256 dy = _mm256_sub_ps(pty, _mm256_loadu_ps(y + i));
+    const __m256 sq =
+      _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    _mm256_storeu_ps(out + i, _mm256_sqrt_ps(sq));
+  }
+  _mm256_zeroupper();
+  distanceOneScalar(pt, x, y, i, n, out);
+}
+
+LAUNCHO_TARGET_AVX2
+static void distancePairsAvx2(const float* ax, const float* ay,
+                              const float* bx, const float* by, std::size_t n,
+                              float* out)
+{
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256 dx =
+      _mm256_sub_ps(_mm256_loadu_ps(ax + i), _mm256_loadu_ps(bx + i));
+    const __m256 dy =
+      _mm256_sub_ps(_mm256_loadu_ps(ay + i), _mm256_loadu_ps(by + i));
+    const __m256 sq =
+      _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    _mm256_storeu_ps(out + i, _mm256_sqrt_ps(sq));
+  }
+  _mm256_zeroupper();
+  distancePairsScalar(ax, ay, bx, by, i, n, out);
+}
+
+LAUNCHO_TARGET_AVX2
+static void normalizeAvx2(float* x, float* y, std::size_t n)
+{
+  const __m256 minLen = _mm256_set1_ps(MIN_NORMALIZE_LENGTH);
+
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256 vx = _mm256_loadu_ps(x + i);
+    const __m256 vy = _mm256_loadu_ps(y + i);
+    const __m256 len = _mm256_sqrt_ps(
+      _mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy))
+      );
+    // lanes that are too short keep their original value
+    const __m256 keep = _mm256_cmp_ps(len, minLen, _CMP_LT_OQ);
+    _mm256_storeu_ps(
+      x + i,
+      _mm256_blendv_ps(_mm256_div_ps(vx, len), vx, keep)
+      );
+    _mm256_storeu_ps(
+      y + i,
+      _mm256_blendv_ps(_mm256_div_ps(vy, len), vy, keep)
+      );
+  }
+  _mm256_zeroupper();
+  normalizeScalar(x, y, i, n);
+}
+
+#endif // LAUNCHO_X86
+
+/****************************************************************************
+ * Dispatch
+ ****************************************************************************/
+
+static SimdPath bestPath()
+{
+#if LAUNCHO_X86
+  const CpuFeatures& cpu = CpuFeatures::get();
+  if (cpu.avx2)
+  {
+    return SimdPath::Avx2;
+  }
+  if (cpu.sse2)
+  {
+    return SimdPath::Sse2;
+  }
+#endif
+  return SimdPath::Scalar;
+}
+
+static SimdPath activePath = bestPath();
+
+SimdPath BatchMath::getPath()
+{
+  return activePath;
+}
+
+SimdPath BatchMath::setPath(const SimdPath path)
+{
+  const SimdPath best = bestPath();
+  activePath = static_cast<int>(path) <= static_cast<int>(best) ? path : best;
+  return activePath;
+}
+
+const char* BatchMath::getPathName(const SimdPath path)
+{
+  switch (path)
+  {
+  case SimdPath::Scalar:
+    return "Scalar";
+
+  case SimdPath::Sse2:
+    return "SSE2";
+
+  case SimdPath::Avx2:
+    return "AVX2";
+  }
+
+  return "";
+}
+
+void BatchMath::transformPoints(const Transform2& t, const Vector2Array& in,
+                                Vector2Array& out)
+{
+  const std::size_t n = in.size();
+  out.resize(n);
+  const float* x = in.x.data();
+  const float* y = in.y.data();
+  float* ox = out.x.data();
+  float* oy = out.y.data();
+
+  switch (activePath)
+  {
+#if LAUNCHO_X86
+  case SimdPath::Avx2:
+    transformAvx2(t, x, y, ox, oy, n);
+    break;
+
+  case SimdPath::Sse2:
+    transformSse2(t, x, y, ox, oy, n);
+    break;
+#endif
+
+  default:
+    transformScalar(t, x, y, ox, oy, 0, n);
+    break;
+  }
+}
+
+std::size_t BatchMath::intersect(const AABB2& box, const AABB2Array& boxes,
+                                 std::vector<uint32_t>& outIndices)
+{
+  const std::size_t n = boxes.size();
+  // kernels write every index and only advance on hits, so they need room for
+  // all of the elements
+  outIndices.resize(n);
+  const BoxPtrs b = boxPtrs(boxes);
+  std::size_t count;
+
+  switch (activePath)
+  {
+#if LAUNCHO_X86
+  case SimdPath::Avx2:
+    count = intersectOneAvx2(box, b, n, outIndices.data());
+    break;
+
+  case SimdPath::Sse2:
+    count = intersectOneSse2(box, b, n, outIndices.data());
+    break;
+#endif
+
+  default:
+    count = intersectOneScalar(box, b, 0, n, outIndices.data());
+    break;
+  }
+
+  outIndices.resize(count);
+  return count;
+}
+
+void BatchMath::intersect(const AABB2Array& a, const AABB2Array& b,
+                          std::vector<uint8_t>& out)
+{
+  assert(a.size() == b.size());
+  const std::size_t n = a.size();
+  out.resize(n);
+  const BoxPtrs pa = boxPtrs(a);
+  const BoxPtrs pb = boxPtrs(b);
+
+  switch (activePath)
+  {
+#if LAUNCHO_X86
+  case SimdPath::Avx2:
+    intersectPairsAvx2(pa, pb, n, out.data());
+    break;
+
+  case SimdPath::Sse2:
+    intersectPairsSse2(pa, pb, n, out.data());
+    break;
+#endif
+
+  default:
+    intersectPairsScalar(pa, pb, 0, n, out.data());
+    break;
+  }
+}
+
+std::size_t BatchMath::contains(const AABB2& box, const Vector2Array& points,
+                                std::vector<uint32_t>& outIndices)
+{
+  const std::size_t n = points.size();
+  outIndices.resize(n);
+  const float* x = points.x.data();
+  const float* y = points.y.data();
+  std::size_t count;
+
+  switch (activePath)
+  {
+#if LAUNCHO_X86
+  case SimdPath::Avx2:
+    count = containsOneAvx2(box, x, y, n, outIndices.data());
+    break;
+
+  case SimdPath::Sse2:
+    count = containsOneSse2(box, x, y, n, outIndices.data());
+    break;
+#endif
+
+  default:
+    count = containsOneScalar(box, x, y, 0, n, outIndices.data());
+    break;
+  }
+
+  outIndices.resize(count);
+  return count;
+}
+
+void BatchMath::contains(const AABB2Array& boxes, const Vector2Array& points,
+                         std::vector<uint8_t>& out)
+{
+  assert(boxes.size() == points.size());
+  const std::size_t n = boxes.size();
+  out.resize(n);
+  const BoxPtrs b = boxPtrs(boxes);
+  const float* x = points.x.data();
+  const float* y = points.y.data();
+
+  switch (activePath)
+  {
+#if LAUNCHO_X86
+  case SimdPath::Avx2:
+    containsPairsAvx2(b, x, y, n, out.data());
+    break;
+
+  case SimdPath::Sse2:
+    containsPairsSse2(b, x, y, n, out.data());
+    break;
+#endif
+
+  default:
+    containsPairsScalar(b, x, y, 0, n, out.data());
+    break;
+  }
+}
+
+void BatchMath::distance(const Vector2& point, const Vector2Array& points,
+                         std::vector<float>& out)
+{
+  const std::size_t n = points.size();
+  out.resize(n);
+  const float* x = points.x.data();
+  const float* y = points.y.data();
+
+  switch (activePath)
+  {
+#if LAUNCHO_X86
+  case SimdPath::Avx2:
+    distanceOneAvx2(point, x, y, n, out.data());
+    break;
+
+  case SimdPath::Sse2:
+    distanceOneSse2(point, x, y, n, out.data());
+    break;
+#endif
+
+  default:
+    distanceOneScalar(point, x, y, 0, n, out.data());
+    break;
+  }
+}
+
+void BatchMath::distance(const Vector2Array& a, const Vector2Array& b,
+                         std::vector<float>& out)
+{
+  assert(a.size() == b.size());
+  const std::size_t n = a.size();
+  out.resize(n);
+
+  switch (activePath)
+  {
+#if LAUNCHO_X86
+  case SimdPath::Avx2:
+    distancePairsAvx2(a.x.data(), a.y.data(), b.x.data(), b.y.data(), n,
+                      out.data());
+    break;
+
+  case SimdPath::Sse2:
+    distancePairsSse2(a.x.data(), a.y.data(), b.x.data(), b.y.data(), n,
+                      out.data());
+    break;
+#endif
+
+  default:
+    distancePairsScalar(a.x.data(), a.y.data(), b.x.data(), b.y.data(), 0, n,
+                        out.data());
+    break;
+  }
+}
+
+void BatchMath::normalize(Vector2Array& vecs)
+{
+  const std::size_t n = vecs.size();
+
+  switch (activePath)
+  {
+#if LAUNCHO_X86
+  case SimdPath::Avx2:
+    normalizeAvx2(vecs.x.data(), vecs.y.data(), n);
+    break;
+
+  case SimdPath::Sse2:
+    normalizeSse2(vecs.x.data(), vecs.y.data(), n);
+    break;
+#endif
+
+  default:
+    normalizeScalar(vecs.x.data(), vecs.y.data(), 0, n);
+    break;
+  }
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "math/AABB2.h"
+#include "math/Transform2.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Instruction set used by the batch kernels
+enum class SimdPath
+{
+  Scalar,
+  Sse2,
+  Avx2
+};
+
+/**
+ * Structure of arrays storage for vectors. Keeping each component contiguous
+ * lets the batch kernels load several vectors with a single instruction.
+ */
+class Vector2Array
+{
+public:
+  std::vector<float> x;
+  std::vector<float> y;
+
+  std::size_t size() const;
+  void resize(const std::size_t count);
+  void clear();
+  void push_back(const Vector2& v);
+
+  Vector2 get(const std::size_t i) const;
+  void set(const std::size_t i, const Vector2& v);
+};
+
+/**
+ * Structure of arrays storage for bounding boxes.
+ */
+class AABB2Array
+{
+public:
+  std::vector<float> centerX;
+  std::vector<float> centerY;
+  std::vector<float> halfX;
+  std::vector<float> halfY;
+
+  std::size_t size() const;
+  void resize(const std::size_t count);
+  void clear();
+  void push_back(const AABB2& box);
+
+  AABB2 get(const std::size_t i) const;
+  void set(const std::size_t i, const AABB2& box);
+};
+
+/**
+ * Applies vector and bounding box math to whole arrays at once. The kernels
+ * are picked on first use based on the instruction sets the processor
+ * supports, with a scalar fallback. Results match the scalar Vector2/AABB2
+ * methods.
+ */
+class BatchMath final
+{
+public:
+  BatchMath() = delete;
+
+  // Returns the kernels currently in use.
+  static SimdPath getPath();
+
+  /**
+   * Forces a kernel implementation, mostly for benchmarks. Falls back to the
+   * best supported path if the processor can't run the requested one.
+   * @return The path that is now active.
+   */
+  static SimdPath setPath(const SimdPath path);
+
+  static const char* getPathName(const SimdPath path);
+
+  /**
+   * out[i] = t.transformPoint(in[i]). in and out may be the same array, out is
+   * resized to match in.
+   */
+  static void transformPoints(const Transform2& t, const Vector2Array& in,
+                              Vector2Array& out);
+
+  /**
+   * Finds every box in boxes that intersects box (1 vs N).
+   * @param outIndices[out] Receives the indices of the intersecting boxes.
+   * @return The number of intersecting boxes.
+   */
+  static std::size_t intersect(const AABB2& box, const AABB2Array& boxes,
+                               std::vector<uint32_t>& outIndices);
+
+  /**
+   * out[i] = a[i].intersect(b[i]) (N vs N). The arrays must be the same size.
+   */
+  static void intersect(const AABB2Array& a, const AABB2Array& b,
+                        std::vector<uint8_t>& out);
+
+  /**
+   * Finds every point in points that is inside box (1 vs N).
+   * @param outIndices[out] Receives the indices of the contained points.
+   * @return The number of contained points.
+   */
+  static std::size_t contains(const AABB2& box, const Vector2Array& points,
+                              std::vector<uint32_t>& outIndices);
+
+  /**
+   * out[i] = boxes[i].contains(points[i]) (N vs N). The arrays must be the
+   * same size.
+   */
+  static void contains(const AABB2Array& boxes, const Vector2Array& points,
+                       std::vector<uint8_t>& out);
+
+  /**
+   * out[i] = point.distance(points[i])
+   */
+  static void distance(const Vector2& point, const Vector2Array& points,
+                       std::vector<float>& out);
+
+  /**
+   * out[i] = a[i].distance(b[i]). The arrays must be the same size.
+   */
+  static void distance(const Vector2Array& a, const Vector2Array& b,
+                       std::vector<float>& out);
+
+  /**
+   * Normalizes every vector in place. Zero length vectors are left alone.
+   */
+  static void normalize(Vector2Array& vecs);
+};
@@ -0,0 +1,530 @@
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+/**
+ * Integer operations behind the fixed point types. Every operation is done
+ * with integer instructions only, so results are bit identical on any compiler
+ * and processor. Overflow wraps, multiplication rounds toward negative
+ * infinity, division rounds toward zero.
+ * Square roots start from a floating point estimate and are then corrected
+ * with integer math, so the result is always exactly floor(sqrt(x)) no matter
+ * how the estimate was rounded. Negative values return zero.
+ */
+template<typename Raw>
+struct FixedTraits;
+
+// Q16.16, 32 bit storage with 64 bit intermediates
+template<>
+struct FixedTraits<int32_t>
+{
+  typedef uint32_t Unsigned;
+  static const int FRACTION_BITS = 16;
+
+  static int32_t mul(const int32_t a, const int32_t b);
+  static int32_t div(const int32_t a, const int32_t b);
+  static int32_t sqrt(const int32_t a);
+};
+
+// Q32.32, 64 bit storage with 128 bit intermediates
+template<>
+struct FixedTraits<int64_t>
+{
+  typedef uint64_t Unsigned;
+  static const int FRACTION_BITS = 32;
+
+  static int64_t mul(const int64_t a, const int64_t b);
+  static int64_t div(const int64_t a, const int64_t b);
+  static int64_t sqrt(const int64_t a);
+
+private:
+  // full 128 bit product of two unsigned values
+  static void mulWide(const uint64_t a, const uint64_t b, uint64_t& high,
+                      uint64_t& low);
+};
+
+/**
+ * Signed fixed point number, half of the bits of Raw are used for the
+ * fraction. Use this instead of float for gameplay state that has to be
+ * simulated identically on every machine (lockstep, server verification).
+ * Conversion from float is only exact when the value is representable, so
+ * deterministic state should be built from integers or raw values.
+ */
+template<typename Raw>
+class Fixed
+{
+public:
+  typedef FixedTraits<Raw> Traits;
+  typedef typename Traits::Unsigned Unsigned;
+  static const int FRACTION_BITS = Traits::FRACTION_BITS;
+
+  // raw value of 1.0
+  static constexpr Raw ONE_RAW = static_cast<Raw>(1) << FRACTION_BITS;
+
+  // Conversions
+  static constexpr Fixed fromRaw(const Raw raw);
+  static constexpr Fixed fromInt(const int32_t i);
+  static Fixed fromFloat(const float f);
+  static Fixed fromDouble(const double d);
+  // numerator / denominator without going through floating point
+  static Fixed fromRatio(const int32_t numerator, const int32_t denominator);
+
+  // Convenience constants
+  static constexpr Fixed zero();
+  static constexpr Fixed one();
+  static constexpr Fixed half();
+  static constexpr Fixed maxValue();
+  static constexpr Fixed minValue();
+
+  // Constructs zero
+  constexpr Fixed();
+
+  constexpr Raw raw() const;
+  float toFloat() const;
+  double toDouble() const;
+  // rounds toward negative infinity
+  constexpr int32_t toInt() const;
+
+  /**
+   * Square root, negative values return zero.
+   */
+  Fixed sqrt() const;
+  Fixed abs() const;
+  // largest integer value <= this
+  Fixed floor() const;
+
+  // comparisons
+  constexpr bool operator==(const Fixed& rhs) const;
+  constexpr bool operator!=(const Fixed& rhs) const;
+  constexpr bool operator<(const Fixed& rhs) const;
+  constexpr bool operator<=(const Fixed& rhs) const;
+  constexpr bool operator>(const Fixed& rhs) const;
+  constexpr bool operator>=(const Fixed& rhs) const;
+
+  // arithmetic
+  Fixed operator+(const Fixed& rhs) const;
+  Fixed operator-(const Fixed& rhs) const;
+  Fixed operator*(const Fixed& rhs) const;
+  Fixed operator/(const Fixed& rhs) const;
+  Fixed operator-() const;
+  Fixed& operator+=(const Fixed& rhs);
+  Fixed& operator-=(const Fixed& rhs);
+  Fixed& operator*=(const Fixed& rhs);
+  Fixed& operator/=(const Fixed& rhs);
+
+  // multiplying or dividing by an integer is exact and avoids the wide math
+  Fixed operator*(const int32_t rhs) const;
+  Fixed operator/(const int32_t rhs) const;
+
+private:
+  Raw value;
+
+  explicit constexpr Fixed(const Raw raw);
+
+  // two's complement wrapping, signed overflow is undefined behavior
+  static constexpr Raw wrap(const Unsigned u);
+};
+
+// Q16.16, range about +/-32768 with a resolution of 1/65536
+typedef Fixed<int32_t> Fixed16;
+// Q32.32, range about +/-2 billion with a resolution of 1/4294967296
+typedef Fixed<int64_t> Fixed32;
+
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+
+inline int32_t FixedTraits<int32_t>::mul(const int32_t a, const int32_t b)
+{
+  // arithmetic shift, rounds toward negative infinity
+  return static_cast<int32_t>(
+    (static_cast<int64_t>(a) * static_cast<int64_t>(b)) >> FRACTION_BITS);
+}
+
+inline int32_t FixedTraits<int32_t>::div(const int32_t a, const int32_t b)
+{
+  assert(b != 0);
+  return static_cast<int32_t>(
+    (static_cast<int64_t>(a) * (INT64_C(1) << FRACTION_BITS)) /
+    static_cast<int64_t>(b));
+}
+
+inline int32_t FixedTraits<int32_t>::sqrt(const int32_t a)
+{
+  if (a <= 0)
+  {
+    return 0;
+  }
+  // sqrt(a * 2^16) is the raw result, the argument fits exactly in a double
+  const uint64_t n = static_cast<uint64_t>(a) << FRACTION_BITS;
+  uint64_t root = static_cast<uint64_t>(std::sqrt(static_cast<double>(n)));
+  while (root * root > n)
+  {
+    root--;
+  }
+  while ((root + 1) * (root + 1) <= n)
+  {
+    root++;
+  }
+  return static_cast<int32_t>(root);
+}
+
+inline void FixedTraits<int64_t>::mulWide(const uint64_t a, const uint64_t b,
+                                          uint64_t& high, uint64_t& low)
+{
+  const uint64_t aLow = a & 0xFFFFFFFFu;
+  const uint64_t aHigh = a >> 32;
+  const uint64_t bLow = b & 0xFFFFFFFFu;
+  const uint64_t bHigh = b >> 32;
+  const uint64_t ll = aLow * bLow;
+  const uint64_t lh = aLow * bHigh;
+  const uint64_t hl = aHigh * bLow;
+  const uint64_t hh = aHigh * bHigh;
+  const uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+  low = (mid << 32) | (ll & 0xFFFFFFFFu);
+  high = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+}
+
+inline int64_t FixedTraits<int64_t>::mul(const int64_t a, const int64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+  return static_cast<int64_t>(
+    (static_cast<__int128>(a) * static_cast<__int128>(b)) >> FRACTION_BITS);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  int64_t high;
+  const uint64_t low = static_cast<uint64_t>(_mul128(a, b, &high));
+  return static_cast<int64_t>(
+    (low >> FRACTION_BITS) | (static_cast<uint64_t>(high) << FRACTION_BITS));
+#else
+  // bits 32-95 of the 128 bit product, built from 32 bit partial products
+  const uint64_t ua = static_cast<uint64_t>(a);
+  const uint64_t ub = static_cast<uint64_t>(b);
+  const uint64_t aLow = ua & 0xFFFFFFFFu;
+  const uint64_t aHigh = ua >> 32;
+  const uint64_t bLow = ub & 0xFFFFFFFFu;
+  const uint64_t bHigh = ub >> 32;
+  uint64_t mid = ((aHigh * bHigh) << 32) + (aHigh * bLow) + (aLow * bHigh) +
+                 ((aLow * bLow) >> 32);
+  // the unsigned product treats negative values as value + 2^64, remove that
+  if (a < 0)
+  {
+    mid -= ub << 32;
+  }
+  if (b < 0)
+  {
+    mid -= ua << 32;
+  }
+  return static_cast<int64_t>(mid);
+#endif
+}
+
+inline int64_t FixedTraits<int64_t>::div(const int64_t a, const int64_t b)
+{
+  assert(b != 0);
+#if defined(__SIZEOF_INT128__)
+  return static_cast<int64_t>(
+    (static_cast<__int128>(a) * (static_cast<__int128>(1) << FRACTION_BITS)) /
+    static_cast<__int128>(b));
+#else
+  // long division of |a| * 2^32 by |b|, the integer part first and then the
+  // fraction one bit at a time
+  const bool negative = (a < 0) != (b < 0);
+  const uint64_t ua = a < 0 ? 0 - static_cast<uint64_t>(a)
+                            : static_cast<uint64_t>(a);
+  const uint64_t ub = b < 0 ? 0 - static_cast<uint64_t>(b)
+                            : static_cast<uint64_t>(b);
+  uint64_t quotient = ua / ub;
+  uint64_t remainder = ua % ub;
+  for (int i = 0; i < FRACTION_BITS; i++)
+  {
+    const bool carry = (remainder >> 63) != 0;
+    remainder <<= 1;
+    quotient <<= 1;
+    if (carry || remainder >= ub)
+    {
+      remainder -= ub;
+      quotient |= 1;
+    }
+  }
+  return static_cast<int64_t>(negative ? 0 - quotient : quotient);
+#endif
+}
+
+inline int64_t FixedTraits<int64_t>::sqrt(const int64_t a)
+{
+  if (a <= 0)
+  {
+    return 0;
+  }
+  // sqrt(a * 2^32) is the raw result, too wide for a double so the estimate
+  // is sqrt(a) * 2^16 and the checks compare 128 bit squares
+  const uint64_t nHigh = static_cast<uint64_t>(a) >> (64 - FRACTION_BITS);
+  const uint64_t nLow = static_cast<uint64_t>(a) << FRACTION_BITS;
+  auto squareAtMost = [nHigh, nLow](const uint64_t r) {
+    uint64_t high;
+    uint64_t low;
+    mulWide(r, r, high, low);
+    return high < nHigh || (high == nHigh && low <= nLow);
+  };
+
+  uint64_t root = static_cast<uint64_t>(
+    std::sqrt(static_cast<double>(a)) * static_cast<double>(1 << 16));
+  while (!squareAtMost(root))
+  {
+    root--;
+  }
+  while (squareAtMost(root + 1))
+  {
+    root++;
+  }
+  return static_cast<int64_t>(root);
+}
+
+template<typename Raw>
+const int Fixed<Raw>::FRACTION_BITS;
+
+template<typename Raw>
+constexpr Raw Fixed<Raw>::ONE_RAW;
+
+template<typename Raw>
+constexpr Fixed<Raw> Fixed<Raw>::fromRaw(const Raw raw)
+{
+  return Fixed(raw);
+}
+
+template<typename Raw>
+constexpr Fixed<Raw> Fixed<Raw>::fromInt(const int32_t i)
+{
+  return Fixed(static_cast<Raw>(static_cast<Unsigned>(i) << FRACTION_BITS));
+}
+
+template<typename Raw>
+Fixed<Raw> Fixed<Raw>::fromFloat(const float f)
+{
+  return fromDouble(static_cast<double>(f));
+}
+
+template<typename Raw>
+Fixed<Raw> Fixed<Raw>::fromDouble(const double d)
+{
+  // round to nearest, away from zero on ties
+  const double scaled = d * static_cast<double>(ONE_RAW);
+  return Fixed(static_cast<Raw>(scaled < 0.0 ? scaled - 0.5 : scaled + 0.5));
+}
+
+template<typename Raw>
+Fixed<Raw> Fixed<Raw>::fromRatio(const int32_t numerator,
+                                 const int32_t denominator)
+{
+  return fromInt(numerator) / denominator;
+}
+
+template<typename Raw>
+constexpr Fixed<Raw> Fixed<Raw>::zero()
+{
+  return Fixed(0);
+}
+
+template<typename Raw>
+constexpr Fixed<Raw> Fixed<Raw>::one()
+{
+  return Fixed(ONE_RAW);
+}
+
+template<typename Raw>
+constexpr Fixed<Raw> Fixed<Raw>::half()
+{
+  return Fixed(ONE_RAW / 2);
+}
+
+template<typename Raw>
+constexpr Fixed<Raw> Fixed<Raw>::maxValue()
+{
+  return Fixed(std::numeric_limits<Raw>::max());
+}
+
+template<typename Raw>
+constexpr Fixed<Raw> Fixed<Raw>::minValue()
+{
+  return Fixed(std::numeric_limits<Raw>::min());
+}
+
+template<typename Raw>
+constexpr Fixed<Raw>::Fixed()
+  : value(0)
+{}
+
+template<typename Raw>
+constexpr Fixed<Raw>::Fixed(const Raw raw)
+  : value(raw)
+{}
+
+template<typename Raw>
+constexpr Raw Fixed<Raw>::raw() const
+{
+  return value;
+}
+
+template<typename Raw>
+float Fixed<Raw>::toFloat() const
+{
+  return static_cast<float>(toDouble());
+}
+
+template<typename Raw>
+double Fixed<Raw>::toDouble() const
+{
+  return static_cast<double>(value) / static_cast<double>(ONE_RAW);
+}
+
+template<typename Raw>
+constexpr int32_t Fixed<Raw>::toInt() const
+{
+  return static_cast<int32_t>(value >> FRACTION_BITS);
+}
+
+template<typename Raw>
+Fixed<Raw> Fixed<Raw>::sqrt() const
+{
+  return Fixed(Traits::sqrt(value));
+}
+
+template<typename Raw>
+Fixed<Raw> Fixed<Raw>::abs() const
+{
+  return value < 0 ? -*this : *this;
+}
+
+template<typename Raw>
+Fixed<Raw> Fixed<Raw>::floor() const
+{
+  return Fixed(wrap(static_cast<Unsigned>(value) &
+                    ~static_cast<Unsigned>(ONE_RAW - 1)));
+}
+
+template<typename Raw>
+constexpr bool Fixed<Raw>::operator==(const Fixed& rhs) const
+{
+  return value == rhs.value;
+}
+
+template<typename Raw>
+constexpr bool Fixed<Raw>::operator!=(const Fixed& rhs) const
+{
+  return value != rhs.value;
+}
+
+template<typename Raw>
+constexpr bool Fixed<Raw>::operator<(const Fixed& rhs) const
+{
+  return value < rhs.value;
+}
+
+template<typename Raw>
+constexpr bool Fixed<Raw>::operator<=(const Fixed& rhs) const
+{
+  return value <= rhs.value;
+}
+
+template<typename Raw>
+constexpr bool Fixed<Raw>::operator>(const Fixed& rhs) const
+{
+  return value > rhs.value;
+}
+
+template<typename Raw>
+constexpr bool Fixed<Raw>::operator>=(const Fixed& rhs) const
+{
+  return value >= rhs.value;
+}
+
+template<typename Raw>
+Fixed<Raw> Fixed<Raw>::operator+(const Fixed& rhs) const
+{
+  return Fixed(wrap(static_cast<Unsigned>(value) +
+                    static_cast<Unsigned>(rhs.value)));
+}
+
+template<typename Raw>
+Fixed<Raw> Fixed<Raw>::operator-(const Fixed& rhs) const
+{
+  return Fixed(wrap(static_cast<Unsigned>(value) -
+                    static_cast<Unsigned>(rhs.value)));
+}
+
+template<typename Raw>
+Fixed<Raw> Fixed<Raw>::operator*(const Fixed& rhs) const
+{
+  return Fixed(Traits::mul(value, rhs.value));
+}
+
+template<typename Raw>
+Fixed<Raw> Fixed<Raw>::operator/(const Fixed& rhs) const
+{
+  return Fixed(Traits::div(value, rhs.value));
+}
+
+template<typename Raw>
+Fixed<Raw> Fixed<Raw>::operator-() const
+{
+  return Fixed(wrap(0 - static_cast<Unsigned>(value)));
+}
+
+template<typename Raw>
+Fixed<Raw>& Fixed<Raw>::operator+=(const Fixed& rhs)
+{
+  *this = *this + rhs;
+  return *this;
+}
+
+template<typename Raw>
+Fixed<Raw>& Fixed<Raw>::operator-=(const Fixed& rhs)
+{
+  *this = *this - rhs;
+  return *this;
+}
+
+template<typename Raw>
+Fixed<Raw>& Fixed<Raw>::operator*=(const Fixed& rhs)
+{
+  *this = *this * rhs;
+  return *this;
+}
+
+template<typename Raw>
+Fixed<Raw>& Fixed<Raw>::operator/=(const Fixed& rhs)
+{
+  *this = *this / rhs;
+  return *this;
+}
+
+template<typename Raw>
+Fixed<Raw> Fixed<Raw>::operator*(const int32_t rhs) const
+{
+  return Fixed(wrap(static_cast<Unsigned>(value) *
+                    static_cast<Unsigned>(static_cast<Raw>(rhs))));
+}
+
+template<typename Raw>
+Fixed<Raw> Fixed<Raw>::operator/(const int32_t rhs) const
+{
+  assert(rhs != 0);
+  // the smallest value divided by -1 overflows, negate so it wraps instead
+  if (rhs == -1)
+  {
+    return -*this;
+  }
+  return Fixed(static_cast<Raw>(value / static_cast<Raw>(rhs)));
+}
+
+template<typename Raw>
+constexpr Raw Fixed<Raw>::wrap(const Unsigned u)
+{
+  return static_cast<Raw>(u);
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "math/AABB2.h"
+#include "math/FixedVector2.h"
+
+/**
+ * Fixed point counterpart of AABB2 for deterministic collision checks.
+ */
+template<typename T>
+class FixedAABB2
+{
+public:
+  /**
+   * Converts a float box, rounding each component to the nearest value.
+   */
+  static FixedAABB2 fromAABB2(const AABB2& box);
+
+  // center of the box
+  FixedVector2<T> center;
+  // width is 2*x component, height is 2*y component
+  FixedVector2<T> halfSize;
+
+  // constructors
+  constexpr FixedAABB2();
+  constexpr FixedAABB2(const FixedVector2<T>& _center,
+                       const FixedVector2<T>& _halfSize);
+
+  AABB2 toAABB2() const;
+
+  /**
+   * Using vector as a point, checks if the point is in this box.
+   */
+  bool contains(const FixedVector2<T>& pt) const;
+
+  /**
+   * Checks if other is completely inside this box.
+   */
+  bool contains(const FixedAABB2& other) const;
+
+  /**
+   * Checks if these boxes have an intersection.
+   */
+  bool intersect(const FixedAABB2& other) const;
+
+  // box information
+  T width() const;
+  T height() const;
+  FixedVector2<T> lowerLeft() const;
+  FixedVector2<T> upperRight() const;
+};
+
+typedef FixedAABB2<Fixed16> FixedAABB2_16;
+typedef FixedAABB2<Fixed32> FixedAABB2_32;
+
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+
+template<typename T>
+FixedAABB2<T> FixedAABB2<T>::fromAABB2(const AABB2& box)
+{
+  return FixedAABB2(FixedVector2<T>::fromVector2(box.center),
+                    FixedVector2<T>::fromVector2(box.halfSize));
+}
+
+template<typename T>
+constexpr FixedAABB2<T>::FixedAABB2()
+  : center(), halfSize()
+{}
+
+template<typename T>
+constexpr FixedAABB2<T>::FixedAABB2(const FixedVector2<T>& _center,
+                                    const FixedVector2<T>& _halfSize)
+  : center(_center), halfSize(_halfSize)
+{}
+
+template<typename T>
+AABB2 FixedAABB2<T>::toAABB2() const
+{
+  return AABB2(center.toVector2(), halfSize.toVector2());
+}
+
+template<typename T>
+bool FixedAABB2<T>::contains(const FixedVector2<T>& pt) const
+{
+  return ((center.x - pt.x).abs() <= halfSize.x) &&
+         ((center.y - pt.y).abs() <= halfSize.y);
+}
+
+template<typename T>
+bool FixedAABB2<T>::contains(const FixedAABB2& other) const
+{
+  return ((center.x - other.center.x).abs() + other.halfSize.x <=
+          halfSize.x) &&
+         ((center.y - other.center.y).abs() + other.halfSize.y <= halfSize.y);
+}
+
+template<typename T>
+bool FixedAABB2<T>::intersect(const FixedAABB2& other) const
+{
+  return ((center.x - other.center.x).abs() <= halfSize.x + other.halfSize.x) &&
+         ((center.y - other.center.y).abs() <= halfSize.y + other.halfSize.y);
+}
+
+template<typename T>
+T FixedAABB2<T>::width() const
+{
+  return halfSize.x * 2;
+}
+
+template<typename T>
+T FixedAABB2<T>::height() const
+{
+  return halfSize.y * 2;
+}
+
+template<typename T>
+FixedVector2<T> FixedAABB2<T>::lowerLeft() const
+{
+  return center - halfSize;
+}
+
+template<typename T>
+FixedVector2<T> FixedAABB2<T>::upperRight() const
+{
+  return center + halfSize;
+}
\ No newline at end of file
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "math/Fixed.h"
+#include "math/Vector2.h"
+
+/**
+ * Fixed point counterpart of Vector2 for deterministic simulation. T is one of
+ * the Fixed types.
+ */
+template<typename T>
+class FixedVector2
+{
+public:
+  /**
+   * Converts a float vector, rounding each component to the nearest value.
+   */
+  static FixedVector2 fromVector2(const Vector2& vec);
+
+  /**
+   * Returns a normalized copy of the vector.
+   */
+  static FixedVector2 normalize(const FixedVector2& vec);
+
+  T x;
+  T y;
+
+  // Constructors
+  constexpr FixedVector2();
+  constexpr FixedVector2(const T _x, const T _y);
+
+  Vector2 toVector2() const;
+
+  /**
+   * Returns the length/magnitude of the vector.
+   */
+  T length() const;
+
+  /**
+   * Returns the squared length of the vector. Overflows for lengths above
+   * sqrt of the type's range, compare squared lengths only for small vectors.
+   */
+  T lengthSquared() const;
+
+  /**
+   * Returns the distance to another vector.
+   */
+  T distance(const FixedVector2& other) const;
+
+  /**
+   * Returns the dot product (scalar product) of this vector with another
+   * vector.
+   */
+  T dotProd(const FixedVector2& other) const;
+
+  /**
+   * Normalizes the vector into a unit vector. Zero vectors are left alone.
+   */
+  void normalize();
+
+  // comparisons, exact since there is no rounding error to allow for
+  constexpr bool operator==(const FixedVector2& rhs) const;
+  constexpr bool operator!=(const FixedVector2& rhs) const;
+
+  // add two vectors
+  FixedVector2 operator+(const FixedVector2& rhs) const;
+  // subtract two vectors
+  FixedVector2 operator-(const FixedVector2& rhs) const;
+  // vector scalar multiplication
+  FixedVector2 operator*(const T rhs) const;
+  // vector scalar division
+  FixedVector2 operator/(const T rhs) const;
+  // negation
+  FixedVector2 operator-() const;
+  FixedVector2& operator+=(const FixedVector2& rhs);
+  FixedVector2& operator-=(const FixedVector2& rhs);
+  FixedVector2& operator*=(const T rhs);
+  FixedVector2& operator/=(const T rhs);
+};
+
+typedef FixedVector2<Fixed16> FixedVector2_16;
+typedef FixedVector2<Fixed32> FixedVector2_32;
+
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+
+template<typename T>
+FixedVector2<T> FixedVector2<T>::fromVector2(const Vector2& vec)
+{
+  return FixedVector2(T::fromFloat(vec.x), T::fromFloat(vec.y));
+}
+
+template<typename T>
+FixedVector2<T> FixedVector2<T>::normalize(const FixedVector2& vec)
+{
+  FixedVector2 result = vec;
+  result.normalize();
+  return result;
+}
+
+template<typename T>
+constexpr FixedVector2<T>::FixedVector2()
+  : x(), y()
+{}
+
+template<typename T>
+constexpr FixedVector2<T>::FixedVector2(const T _x, const T _y)
+  : x(_x), y(_y)
+{}
+
+template<typename T>
+Vector2 FixedVector2<T>::toVector2() const
+{
+  return Vector2(x.toFloat(), y.toFloat());
+}
+
+template<typename T>
+T FixedVector2<T>::length() const
+{
+  return lengthSquared().sqrt();
+}
+
+template<typename T>
+T FixedVector2<T>::lengthSquared() const
+{
+  return (x * x) + (y * y);
+}
+
+template<typename T>
+T FixedVector2<T>::distance(const FixedVector2& other) const
+{
+  return (*this - other).length();
+}
+
+template<typename T>
+T FixedVector2<T>::dotProd(const FixedVector2& other) const
+{
+  return (x * other.x) + (y * other.y);
+}
+
+template<typename T>
+void FixedVector2<T>::normalize()
+{
+  const T len = length();
+  if (len != T::zero())
+  {
+    x /= len;
+    y /= len;
+  }
+}
+
+template<typename T>
+constexpr bool FixedVector2<T>::operator==(const FixedVector2& rhs) const
+{
+  return (x == rhs.x) && (y == rhs.y);
+}
+
+template<typename T>
+constexpr bool FixedVector2<T>::operator!=(const FixedVector2& rhs) const
+{
+  return !(*this == rhs);
+}
+
+template<typename T>
+FixedVector2<T> FixedVector2<T>::operator+(const FixedVector2& rhs) const
+{
+  return FixedVector2(x + rhs.x, y + rhs.y);
+}
+
+template<typename T>
+FixedVector2<T> FixedVector2<T>::operator-(const FixedVector2& rhs) const
+{
+  return FixedVector2(x - rhs.x, y - rhs.y);
+}
+
+template<typename T>
+FixedVector2<T> FixedVector2<T>::operator*(const T rhs) const
+{
+  return FixedVector2(x * rhs, y * rhs);
+}
+
+template<typename T>
+FixedVector2<T> FixedVector2<T>::operator/(const T rhs) const
+{
+  assert(rhs != T::zero());
+  return FixedVector2(x / rhs, y / rhs);
+}
+
+template<typename T>
+FixedVector2<T> FixedVector2<T>::operator-() const
+{
+  return FixedVector2(-x, -y);
+}
+
+template<typename T>
+FixedVector2<T>& FixedVector2<T>::operator+=(const FixedVector2& rhs)
+{
+  x += rhs.x;
+  y += rhs.y;
+  return *this;
+}
+
+template<typename T>
+FixedVector2<T>& FixedVector2<T>::operator-=(const FixedVector2& rhs)
+{
+  x -= rhs.x;
+  y -= rhs.y;
+  return *this;
+}
+
+template<typename T>
+FixedVector2<T>& FixedVector2<T>::operator*=(const T rhs)
+{
+  *this = *this * rhs;
+  return *this;
+}
+
+template<typename T>
+FixedVector2<T>& FixedVector2<T>::operator/=(const T rhs)
+{
+  *this = *this / rhs;
+  return *this;
+}
\ No newline at end of file
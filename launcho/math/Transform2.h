@@ -0,0 +1,145 @@
+#pragma once
+
+#include "math/Vector2.h"
+#include <cmath>
+
+/**
+ * Rigid body transform for two dimensions: a rotation followed by a
+ * translation. Stored as the top two rows of a row major 3x3 affine matrix,
+ * the implied bottom row is [0 0 1].
+ * Rotations follow the same convention as TransformComponent: degrees,
+ * clockwise, with 0 along the positive x axis.
+ */
+class Transform2
+{
+public:
+  static constexpr float DEG_TO_RAD = 3.14159265358979f / 180.0f;
+
+  float m00, m01, m02;
+  float m10, m11, m12;
+
+  /**
+   * Builds a transform that rotates by degrees and then moves to position.
+   */
+  static Transform2 make(const Vector2& position, const float degrees);
+
+  // Transform that only translates
+  static constexpr Transform2 translation(const Vector2& offset);
+
+  // Transform that only rotates around the origin
+  static Transform2 rotation(const float degrees);
+
+  // Constructs the identity transform
+  constexpr Transform2();
+  constexpr Transform2(float _m00, float _m01, float _m02,
+                       float _m10, float _m11, float _m12);
+
+  /**
+   * Applies the full transform to a point.
+   */
+  constexpr Vector2 transformPoint(const Vector2& pt) const;
+
+  /**
+   * Applies only the rotation part of the transform, for directions.
+   */
+  constexpr Vector2 transformVector(const Vector2& vec) const;
+
+  // the translation part of the transform
+  constexpr Vector2 getTranslation() const;
+
+  /**
+   * Returns the inverse transform. The matrix must not be singular.
+   */
+  Transform2 inverse() const;
+
+  /**
+   * Combines two transforms, the result applies rhs first and then this.
+   */
+  constexpr Transform2 operator*(const Transform2& rhs) const;
+  Transform2& operator*=(const Transform2& rhs);
+};
+
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+
+inline Transform2 Transform2::make(const Vector2& position, const float degrees)
+{
+  const float rad = degrees * DEG_TO_RAD;
+  const float c = std::cos(rad);
+  const float s = std::sin(rad);
+  // clockwise rotation in a y up coordinate system
+  return Transform2(c, s, position.x, -s, c, position.y);
+}
+
+constexpr Transform2 Transform2::translation(const Vector2& offset)
+{
+  return Transform2(1.0f, 0.0f, offset.x, 0.0f, 1.0f, offset.y);
+}
+
+inline Transform2 Transform2::rotation(const float degrees)
+{
+  return make(Vector2(), degrees);
+}
+
+constexpr Transform2::Transform2()
+  : m00(1.0f), m01(0.0f), m02(0.0f),
+    m10(0.0f), m11(1.0f), m12(0.0f)
+{}
+
+constexpr Transform2::Transform2(float _m00, float _m01, float _m02,
+                                 float _m10, float _m11, float _m12)
+  : m00(_m00), m01(_m01), m02(_m02),
+    m10(_m10), m11(_m11), m12(_m12)
+{}
+
+constexpr Vector2 Transform2::transformPoint(const Vector2& pt) const
+{
+  return Vector2(
+    (m00 * pt.x) + (m01 * pt.y) + m02,
+    (m10 * pt.x) + (m11 * pt.y) + m12
+    );
+}
+
+constexpr Vector2 Transform2::transformVector(const Vector2& vec) const
+{
+  return Vector2((m00 * vec.x) + (m01 * vec.y), (m10 * vec.x) + (m11 * vec.y));
+}
+
+constexpr Vector2 Transform2::getTranslation() const
+{
+  return Vector2(m02, m12);
+}
+
+inline Transform2 Transform2::inverse() const
+{
+  const float det = (m00 * m11) - (m01 * m10);
+  assert(!fp_compare(det, 0.0f));
+  const float inv = 1.0f / det;
+  const float i00 = m11 * inv;
+  const float i01 = -m01 * inv;
+  const float i10 = -m10 * inv;
+  const float i11 = m00 * inv;
+  return Transform2(
+    i00, i01, -((i00 * m02) + (i01 * m12)),
+    i10, i11, -((i10 * m02) + (i11 * m12))
+    );
+}
+
+constexpr Transform2 Transform2::operator*(const Transform2& rhs) const
+{
+  return Transform2(
+    (m00 * rhs.m00) + (m01 * rhs.m10),
+    (m00 * rhs.m01) + (m01 * rhs.m11),
+    (m00 * rhs.m02) + (m01 * rhs.m12) + m02,
+    (m10 * rhs.m00) + (m11 * rhs.m10),
+    (m10 * rhs.m01) + (m11 * rhs.m11),
+    (m10 * rhs.m02) + (m11 * rhs.m12) + m12
+    );
+}
+
+inline Transform2& Transform2::operator*=(const Transform2& rhs)
+{
+  *this = *this * rhs;
+  return *this;
+}
@@ -1,7 +1,12 @@
 #pragma once
 
+#include "math/fp_compare.h"
+#include <cmath>
+#include <cassert>
+
 /**
- * Vector class for two dimensional use.
+ * Vector class for two dimensional use. Trivially copyable and header only so
+ * that math in hot loops can be fully inlined.
  */
 class Vector2
 {
@@ -22,26 +27,30 @@ public:
   float y;
 
   // Constructors
-  Vector2();
-  Vector2(float _x, float _y);
-  Vector2(const Vector2& copy);
-  Vector2& operator=(const Vector2& rhs);
+  constexpr Vector2();
+  constexpr Vector2(float _x, float _y);
 
   /**
    * Returns the length/magnitude of the vector.
    */
   float length() const;
 
+  /**
+   * Returns the squared length of the vector, avoids the square root when only
+   * comparing magnitudes.
+   */
+  constexpr float lengthSquared() const;
+
   /**
    * Returns the distance to another vector.
    */
   float distance(const Vector2& other) const;
 
   /**
-   * Returns the dot product (scalar product) of this vector with another 
+   * Returns the dot product (scalar product) of this vector with another
    * vector.
    */
-  float dotProd(const Vector2& other) const;
+  constexpr float dotProd(const Vector2& other) const;
 
   /**
    * Normalizes the vector into a unit vector.
@@ -51,21 +60,21 @@ public:
   // comparisons
   bool operator==(const Vector2& rhs) const;
   bool operator!=(const Vector2& rhs) const;
-  bool operator<(const Vector2& rhs) const;
-  bool operator<=(const Vector2& rhs) const;
-  bool operator>(const Vector2& rhs) const;
-  bool operator>=(const Vector2& rhs) const;
+  constexpr bool operator<(const Vector2& rhs) const;
+  constexpr bool operator<=(const Vector2& rhs) const;
+  constexpr bool operator>(const Vector2& rhs) const;
+  constexpr bool operator>=(const Vector2& rhs) const;
 
   // add two vectors
-  Vector2 operator+(const Vector2& rhs) const;
+  constexpr Vector2 operator+(const Vector2& rhs) const;
   // subtract two vectors
-  Vector2 operator-(const Vector2& rhs) const;
+  constexpr Vector2 operator-(const Vector2& rhs) const;
   // vector scalar multiplication
-  Vector2 operator*(const float rhs) const;
+  constexpr Vector2 operator*(const float rhs) const;
   // vector scalar division
   Vector2 operator/(const float rhs) const;
   // negation
-  Vector2 operator-() const;
+  constexpr Vector2 operator-() const;
   // add two vectors
   Vector2& operator+=(const Vector2& rhs);
   // subtract two vectors
@@ -74,4 +83,136 @@ public:
   Vector2& operator*=(const float rhs);
   // vector scalar divison
   Vector2& operator/=(const float rhs);
-};
\ No newline at end of file
+};
+
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+
+inline Vector2 Vector2::normalize(const Vector2& vec)
+{
+  Vector2 result = vec;
+  result.normalize();
+  return result;
+}
+
+constexpr Vector2::Vector2()
+  : x(0.0f), y(0.0f)
+{}
+
+constexpr Vector2::Vector2(float _x, float _y)
+  : x(_x), y(_y)
+{}
+
+inline float Vector2::length() const
+{
+  return std::sqrt(lengthSquared());
+}
+
+constexpr float Vector2::lengthSquared() const
+{
+  return (x * x) + (y * y);
+}
+
+inline float Vector2::distance(const Vector2& other) const
+{
+  return (*this - other).length();
+}
+
+constexpr float Vector2::dotProd(const Vector2& other) const
+{
+  return (x * other.x) + (y * other.y);
+}
+
+inline void Vector2::normalize()
+{
+  float len = length();
+  if (!fp_compare(len, 0.0f))
+  {
+    x /= len;
+    y /= len;
+  }
+}
+
+inline bool Vector2::operator==(const Vector2& rhs) const
+{
+  return fp_compare(x, rhs.x) && fp_compare(y, rhs.y);
+}
+
+inline bool Vector2::operator!=(const Vector2& rhs) const
+{
+  return !(*this == rhs);
+}
+
+constexpr bool Vector2::operator<(const Vector2& rhs) const
+{
+  return (x < rhs.x) && (y < rhs.y);
+}
+
+constexpr bool Vector2::operator<=(const Vector2& rhs) const
+{
+  return (x <= rhs.x) && (y <= rhs.y);
+}
+
+constexpr bool Vector2::operator>(const Vector2& rhs) const
+{
+  return !(*this <= rhs);
+}
+
+constexpr bool Vector2::operator>=(const Vector2& rhs) const
+{
+  return !(*this < rhs);
+}
+
+constexpr Vector2 Vector2::operator+(const Vector2& rhs) const
+{
+  return Vector2(x + rhs.x, y + rhs.y);
+}
+
+constexpr Vector2 Vector2::operator-(const Vector2& rhs) const
+{
+  return Vector2(x - rhs.x, y - rhs.y);
+}
+
+constexpr Vector2 Vector2::operator*(const float rhs) const
+{
+  return Vector2(x * rhs, y * rhs);
+}
+
+inline Vector2 Vector2::operator/(const float rhs) const
+{
+  assert(!fp_compare(rhs, 0.0f));
+  return Vector2(x / rhs, y / rhs);
+}
+
+constexpr Vector2 Vector2::operator-() const
+{
+  return Vector2(-x, -y);
+}
+
+inline Vector2& Vector2::operator+=(const Vector2& rhs)
+{
+  x += rhs.x;
+  y += rhs.y;
+  return *this;
+}
+
+inline Vector2& Vector2::operator-=(const Vector2& rhs)
+{
+  x -= rhs.x;
+  y -= rhs.y;
+  return *this;
+}
+
+inline Vector2& Vector2::operator*=(const float rhs)
+{
+  x *= rhs;
+  y *= rhs;
+  return *this;
+}
+
+inline Vector2& Vector2::operator/=(const float rhs)
+{
+  *this = *this / rhs;
+  return *this;
+}
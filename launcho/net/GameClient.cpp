@@ -0,0 +1,404 @@
+#include "GameClient.h"
+#include "Game.h"
+#include "GameOptions.h"
+#include "options.h"
+#include "utility/AllocationTracker.h"
+#include "utility/ByteStream.h"
+#include "utility/Log.h"
+#include "utility/Lz.h"
+#include <algorithm>
+#include <cassert>
+
+const std::string GameClient::TAG = "GameClient";
+
+// longest the network thread waits for a datagram before it sends the input
+// the main thread queued
+static const int POLL_MS = 5;
+// time between hellos until the server answers
+static const float HELLO_MS = 500.0f;
+
+GameClient::GameClient()
+: serverAddress(),
+  serverPort(0),
+  timeoutMs(0.0f),
+  players(),
+  snapshotPlayers(),
+  snapshot(),
+  world(),
+  welcomedID(0),
+  mutex(),
+  recentInput(),
+  inputSequence(0),
+  received(),
+  receivedFresh(false),
+  stopping(false),
+  network(),
+  playerID(0),
+  serverTickRate(0),
+  connectionLost(false),
+  socket(),
+  lastHeard(),
+  lastHello(),
+  lastSent(),
+  sentSequence(0),
+  newestTick(0),
+  inputPacket(),
+  decompressed(),
+  badPackets(0),
+  failedSends(0),
+  rejoins(0)
+{
+}
+
+GameClient::~GameClient()
+{
+  disconnect();
+}
+
+bool GameClient::connect(const std::string& address,
+                         const unsigned short port,
+                         const float timeoutSeconds)
+{
+  assert(!isConnected());
+  serverAddress = sf::IpAddress(address);
+  if (serverAddress == sf::IpAddress::None)
+  {
+    Log::error(TAG, "Could not resolve %s", address.c_str());
+    return false;
+  }
+  socket.setBlocking(false);
+  if (socket.bind(sf::Socket::AnyPort) != sf::Socket::Done)
+  {
+    Log::error(TAG, "Could not bind a port");
+    return false;
+  }
+
+  serverPort = port;
+  timeoutMs = timeoutSeconds * 1000.0f;
+  welcomedID = 0;
+  inputSequence = 0;
+  receivedFresh = false;
+  playerID = 0;
+  serverTickRate = 0;
+  connectionLost = false;
+  sentSequence = 0;
+  newestTick = 0;
+  badPackets = 0;
+  failedSends = 0;
+  rejoins = 0;
+  stopping = false;
+  network = std::thread(&GameClient::networkLoop, this);
+
+  Log::info(
+    TAG,
+    "Connecting to %s:%u from port %u",
+    serverAddress.toString().c_str(),
+    serverPort,
+    socket.getLocalPort()
+    );
+  return true;
+}
+
+void GameClient::disconnect()
+{
+  if (!isConnected())
+  {
+    return;
+  }
+
+  stopping = true;
+  network.join();
+
+  // the network thread is gone, the socket is the main thread's now
+  if (!connectionLost)
+  {
+    sf::Packet bye;
+    netBegin(bye, NetMessage::Bye);
+    socket.send(bye, serverAddress, serverPort);
+  }
+  socket.unbind();
+  players.clear();
+
+  Log::info(TAG, "Disconnected from %s", serverAddress.toString().c_str());
+  if (badPackets > 0 || failedSends > 0)
+  {
+    Log::warning(
+      TAG,
+      "Ignored %u bad packets, %u sends failed",
+      badPackets.load(),
+      failedSends.load()
+      );
+  }
+  if (rejoins > 0)
+  {
+    Log::warning(TAG, "Dropped by the server %u times", rejoins.load());
+  }
+}
+
+bool GameClient::isConnected() const
+{
+  return network.joinable();
+}
+
+bool GameClient::isConnectionLost() const
+{
+  return connectionLost;
+}
+
+void GameClient::update(const InputState& input)
+{
+  AllocationScope allocations(AllocationTag::Network);
+  // a player that was dropped joins again as a new entity
+  const EntityID id = playerID;
+  if (id != 0 && id != welcomedID)
+  {
+    welcomedID = id;
+    Log::info(TAG, "Joined as entity %u", id);
+    const int tickRate = GameOptions::getInstance().getInt(LOGIC_TICK_RATE);
+    if (static_cast<int>(serverTickRate) != tickRate)
+    {
+      Log::warning(
+        TAG,
+        "The server ticks %u times a second, this client %d",
+        serverTickRate.load(),
+        tickRate
+        );
+    }
+  }
+
+  bool fresh = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::copy_backward(
+      recentInput.begin(),
+      recentInput.end() - 1,
+      recentInput.end()
+      );
+    recentInput[0] = input;
+    inputSequence++;
+    if (receivedFresh)
+    {
+      snapshot.swap(received);
+      receivedFresh = false;
+      fresh = true;
+    }
+  }
+
+  if (fresh && !applySnapshot())
+  {
+    Log::error(TAG, "Snapshot doesn't match the world");
+  }
+}
+
+EntityID GameClient::getPlayerID() const
+{
+  return playerID;
+}
+
+bool GameClient::applySnapshot()
+{
+  ByteReader in(snapshot.data(), snapshot.size());
+  uint32_t count;
+  if (!in.readVarint(count))
+  {
+    return false;
+  }
+  snapshotPlayers.clear();
+  for (uint32_t i = 0; i < count; i++)
+  {
+    EntityID id;
+    if (!in.readVarint(id))
+    {
+      return false;
+    }
+    snapshotPlayers.push_back(id);
+  }
+
+  // the entities have to match the server's before its state can be loaded
+  ILogicSystem* logic = Game::getInstance().getLogicSystem();
+  auto itr = players.begin();
+  while (itr != players.end())
+  {
+    if (std::find(snapshotPlayers.begin(), snapshotPlayers.end(), *itr) ==
+        snapshotPlayers.end())
+    {
+      logic->removeEntity(*itr);
+      itr = players.erase(itr);
+    }
+    else
+    {
+      ++itr;
+    }
+  }
+  for (EntityID id : snapshotPlayers)
+  {
+    if (players.insert(id).second)
+    {
+      // placed by the state below
+      Game::getInstance().createPlayer(
+        id,
+        Vector2::ZERO,
+        id == playerID ? sf::Color::Yellow : sf::Color::Red
+        );
+    }
+  }
+
+  const std::size_t size = in.getRemaining();
+  const uint8_t* bytes;
+  in.readBytes(bytes, size);
+  world.assign(bytes, bytes + size);
+  return Game::getInstance().loadWorldState(world);
+}
+
+void GameClient::networkLoop()
+{
+  AllocationScope allocations(AllocationTag::Network);
+  sf::SocketSelector selector;
+  selector.add(socket);
+  sf::Packet packet;
+  sf::IpAddress address;
+  unsigned short port;
+  sf::Packet hello;
+  netBegin(hello, NetMessage::Hello);
+  send(hello);
+  lastHello.start();
+  lastHeard.start();
+
+  while (!stopping)
+  {
+    if (playerID == 0 && lastHello.elapsedMilliF() > HELLO_MS)
+    {
+      send(hello);
+      lastHello.start();
+    }
+
+    if (selector.wait(sf::milliseconds(POLL_MS)))
+    {
+      // the socket doesn't block, so this reads everything that arrived
+      while (socket.receive(packet, address, port) == sf::Socket::Done)
+      {
+        if (address == serverAddress && port == serverPort)
+        {
+          receive(packet);
+        }
+      }
+    }
+    if (lastHeard.elapsedMilliF() > timeoutMs)
+    {
+      connectionLost = true;
+    }
+    if (connectionLost)
+    {
+      return;
+    }
+    sendInput();
+  }
+}
+
+void GameClient::receive(sf::Packet& packet)
+{
+  NetMessage message;
+  if (!netRead(packet, message))
+  {
+    badPackets++;
+    return;
+  }
+  lastHeard.start();
+
+  if (message == NetMessage::Welcome)
+  {
+    sf::Uint32 entity;
+    sf::Uint32 tickRate;
+    if (!(packet >> entity >> tickRate))
+    {
+      badPackets++;
+      return;
+    }
+    serverTickRate = tickRate;
+    playerID = entity;
+  }
+  else if (message == NetMessage::Snapshot)
+  {
+    sf::Uint32 tick;
+    sf::Uint32 rawSize;
+    if (!(packet >> tick >> rawSize) ||
+        packet.getDataSize() < NET_SNAPSHOT_HEADER_SIZE)
+    {
+      badPackets++;
+      return;
+    }
+    if (tick < newestTick)
+    {
+      // arrived out of order
+      return;
+    }
+    const uint8_t* data =
+      static_cast<const uint8_t*>(packet.getData()) + NET_SNAPSHOT_HEADER_SIZE;
+    if (!lzDecompress(data, packet.getDataSize() - NET_SNAPSHOT_HEADER_SIZE,
+                      decompressed) ||
+        decompressed.size() != rawSize)
+    {
+      badPackets++;
+      return;
+    }
+    newestTick = tick;
+    std::lock_guard<std::mutex> lock(mutex);
+    received.swap(decompressed);
+    receivedFresh = true;
+  }
+  else if (message == NetMessage::Bye)
+  {
+    // dropped, or the server is stopping. Hello is sent again right away,
+    // and the connection is only lost if nothing answers before the timeout
+    if (playerID != 0)
+    {
+      playerID = 0;
+      rejoins++;
+    }
+  }
+  else
+  {
+    badPackets++;
+  }
+}
+
+void GameClient::sendInput()
+{
+  // the server ignores input until it has answered
+  if (playerID == 0)
+  {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    // the same input is sent again now and then while the main thread is
+    // stalled and queues none, so the server doesn't drop the player
+    if (inputSequence == sentSequence &&
+        lastSent.elapsedMilliF() < timeoutMs / 4.0f)
+    {
+      return;
+    }
+    sentSequence = inputSequence;
+    const sf::Uint8 count = static_cast<sf::Uint8>(
+      std::min<uint32_t>(inputSequence, NET_INPUT_REDUNDANCY)
+      );
+    netBegin(inputPacket, NetMessage::Input);
+    inputPacket << static_cast<sf::Uint32>(inputSequence) << count;
+    for (sf::Uint8 i = 0; i < count; i++)
+    {
+      inputPacket << recentInput[i].held << recentInput[i].pressed
+        << recentInput[i].released;
+    }
+  }
+  send(inputPacket);
+}
+
+void GameClient::send(sf::Packet& packet)
+{
+  if (socket.send(packet, serverAddress, serverPort) != sf::Socket::Done)
+  {
+    failedSends++;
+  }
+  lastSent.start();
+}
\ No newline at end of file
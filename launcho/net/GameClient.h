@@ -0,0 +1,114 @@
+#pragma once
+
+#include "input/InputState.h"
+#include "net/NetProtocol.h"
+#include "types.h"
+#include "utility/Timer.h"
+#include <SFML/Network.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Plays on a GameServer. The local player's input is sent to the server
+ * every logic tick instead of being applied, and the world is replaced with
+ * the newest snapshot the server sent, so the client only ever shows what
+ * the server simulated. A network thread owns the socket: it says hello
+ * until the server answers, sends the input queued by the main thread, and
+ * decompresses snapshots as they arrive, so update() only copies them. It
+ * keeps sending while the main thread is stalled so the server doesn't drop
+ * the player, and says hello again if it is dropped anyway.
+ * See NetProtocol.h for the messages.
+ */
+class GameClient
+{
+private:
+  static const std::string TAG;
+
+  sf::IpAddress serverAddress;
+  unsigned short serverPort;
+  float timeoutMs;
+  // only touched by the main thread
+  std::set<EntityID> players;
+  std::vector<EntityID> snapshotPlayers;
+  std::vector<uint8_t> snapshot;
+  std::vector<uint8_t> world;
+  // the player the last welcome was logged for
+  EntityID welcomedID;
+
+  std::mutex mutex;
+  // the local player's input for the last few ticks, newest first
+  std::array<InputState, NET_INPUT_REDUNDANCY> recentInput;
+  // number of ticks of input queued, the sequence of the newest one
+  uint32_t inputSequence;
+  // the newest snapshot, and whether update() has taken it yet
+  std::vector<uint8_t> received;
+  bool receivedFresh;
+  std::atomic<bool> stopping;
+  std::thread network;
+
+  // set by the network thread once the server answers
+  std::atomic<EntityID> playerID;
+  std::atomic<uint32_t> serverTickRate;
+  std::atomic<bool> connectionLost;
+
+  // only touched by the network thread until it is joined
+  sf::UdpSocket socket;
+  Timer lastHeard;
+  Timer lastHello;
+  Timer lastSent;
+  uint32_t sentSequence;
+  // server tick of the newest snapshot
+  uint32_t newestTick;
+  sf::Packet inputPacket;
+  std::vector<uint8_t> decompressed;
+  // the log isn't thread safe, these are reported when the client stops
+  std::atomic<unsigned> badPackets;
+  std::atomic<unsigned> failedSends;
+  std::atomic<unsigned> rejoins;
+
+public:
+  GameClient();
+  ~GameClient();
+  GameClient(const GameClient&) = delete;
+  GameClient& operator=(const GameClient&) = delete;
+
+  /**
+   * Binds a socket and starts saying hello to the server.
+   * @param timeoutSeconds The connection is lost if the server is quiet this
+   *                       long.
+   * @return false if no socket could be bound.
+   */
+  bool connect(const std::string& address, const unsigned short port,
+               const float timeoutSeconds);
+
+  /**
+   * Tells the server it is leaving and stops the network thread.
+   */
+  void disconnect();
+
+  bool isConnected() const;
+  // the server left or stopped answering
+  bool isConnectionLost() const;
+
+  /**
+   * Sends the input of a tick and applies the newest snapshot.
+   */
+  void update(const InputState& input);
+
+  // the entity the server gave the local player, 0 until it answers
+  EntityID getPlayerID() const;
+
+private:
+  bool applySnapshot();
+
+  void networkLoop();
+  void receive(sf::Packet& packet);
+  void sendInput();
+  void send(sf::Packet& packet);
+};
\ No newline at end of file
@@ -0,0 +1,454 @@
+#include "GameServer.h"
+#include "net/NetProtocol.h"
+#include "Game.h"
+#include "GameOptions.h"
+#include "options.h"
+#include "utility/AllocationTracker.h"
+#include "utility/ByteStream.h"
+#include "utility/Log.h"
+#include "utility/Lz.h"
+#include <algorithm>
+#include <cassert>
+
+const std::string GameServer::TAG = "GameServer";
+
+// longest the network thread waits for a datagram before it sends what the
+// main thread queued
+static const int POLL_MS = 5;
+// remote players are numbered from here, clear of the level's entities
+static const EntityID FIRST_PLAYER_ID = 1000;
+// players are spread along the floor in this many columns
+static const std::size_t SPAWN_COLUMNS = 7;
+
+GameServer::GameServer()
+: snapshotInterval(1),
+  timeoutMs(0.0f),
+  tickCount(0),
+  players(),
+  nextPlayerID(FIRST_PLAYER_ID),
+  world(),
+  raw(),
+  compressed(),
+  changes(),
+  mutex(),
+  events(),
+  inputs(),
+  outgoing(),
+  stopping(false),
+  network(),
+  socket(),
+  connections(),
+  sending(),
+  badPackets(0),
+  failedSends(0)
+{
+}
+
+GameServer::~GameServer()
+{
+  stop();
+}
+
+bool GameServer::start(const unsigned short port,
+                       const uint32_t _snapshotInterval,
+                       const float timeoutSeconds)
+{
+  assert(!isRunning());
+  socket.setBlocking(false);
+  if (socket.bind(port) != sf::Socket::Done)
+  {
+    Log::error(TAG, "Could not bind port %u", port);
+    return false;
+  }
+
+  snapshotInterval = std::max(1u, _snapshotInterval);
+  timeoutMs = timeoutSeconds * 1000.0f;
+  tickCount = 0;
+  badPackets = 0;
+  failedSends = 0;
+  stopping = false;
+  network = std::thread(&GameServer::networkLoop, this);
+
+  Log::info(
+    TAG,
+    "Listening on port %u, a snapshot every %u ticks",
+    socket.getLocalPort(),
+    snapshotInterval
+    );
+  return true;
+}
+
+void GameServer::stop()
+{
+  if (!isRunning())
+  {
+    return;
+  }
+
+  stopping = true;
+  network.join();
+
+  // the network thread is gone, the socket is the main thread's now
+  sf::Packet bye;
+  netBegin(bye, NetMessage::Bye);
+  for (auto& player : players)
+  {
+    socket.send(bye, getAddress(player.first), getPort(player.first));
+  }
+  socket.unbind();
+  connections.clear();
+  outgoing.clear();
+  events.clear();
+  inputs.clear();
+  players.clear();
+
+  Log::info(TAG, "Stopped after %u ticks", tickCount);
+  if (badPackets > 0 || failedSends > 0)
+  {
+    Log::warning(
+      TAG,
+      "Ignored %u bad packets, %u sends failed",
+      badPackets.load(),
+      failedSends.load()
+      );
+  }
+}
+
+bool GameServer::isRunning() const
+{
+  return network.joinable();
+}
+
+void GameServer::update()
+{
+  AllocationScope allocations(AllocationTag::Network);
+  // the world as this tick starts is the world as the last one ended
+  if (tickCount % snapshotInterval == 0 && !players.empty())
+  {
+    sendSnapshot();
+  }
+  tickCount++;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    changes.swap(events);
+    for (auto& player : players)
+    {
+      // edges are only seen by one tick, held keys stay held until the
+      // client says otherwise
+      InputState& input = player.second.input;
+      input.pressed = 0;
+      input.released = 0;
+      auto itr = inputs.find(player.first);
+      if (itr != inputs.end())
+      {
+        input = itr->second;
+        itr->second.pressed = 0;
+        itr->second.released = 0;
+      }
+    }
+  }
+
+  for (auto& change : changes)
+  {
+    if (change.joined)
+    {
+      join(change.client);
+    }
+    else
+    {
+      leave(change.client);
+    }
+  }
+  changes.clear();
+
+  ILogicSystem* logic = Game::getInstance().getLogicSystem();
+  for (auto& player : players)
+  {
+    logic->applyInput(player.second.entity, player.second.input);
+  }
+}
+
+std::size_t GameServer::getPlayerCount() const
+{
+  return players.size();
+}
+
+GameServer::ClientKey GameServer::makeKey(const sf::IpAddress& address,
+                                          const unsigned short port)
+{
+  return (static_cast<ClientKey>(address.toInteger()) << 16) | port;
+}
+
+sf::IpAddress GameServer::getAddress(const ClientKey client)
+{
+  return sf::IpAddress(static_cast<sf::Uint32>(client >> 16));
+}
+
+unsigned short GameServer::getPort(const ClientKey client)
+{
+  return static_cast<unsigned short>(client & 0xffff);
+}
+
+void GameServer::join(const ClientKey client)
+{
+  auto itr = players.find(client);
+  if (itr == players.end())
+  {
+    const EntityID entity = nextPlayerID++;
+    const float column = static_cast<float>(players.size() % SPAWN_COLUMNS);
+    Game::getInstance().createPlayer(
+      entity,
+      Vector2(100.0f + column * 100.0f, 300.0f),
+      sf::Color::Red
+      );
+    itr = players.emplace(client, RemotePlayer{entity, InputState()}).first;
+    Log::info(
+      TAG,
+      "%s:%u joined as entity %u, %u players",
+      getAddress(client).toString().c_str(),
+      getPort(client),
+      entity,
+      static_cast<unsigned>(players.size())
+      );
+  }
+
+  // every Hello is answered, in case the last Welcome was lost
+  std::shared_ptr<sf::Packet> welcome(new sf::Packet);
+  netBegin(*welcome, NetMessage::Welcome);
+  *welcome << static_cast<sf::Uint32>(itr->second.entity)
+    << static_cast<sf::Uint32>(
+         GameOptions::getInstance().getInt(LOGIC_TICK_RATE)
+         );
+  queue(client, welcome);
+}
+
+void GameServer::leave(const ClientKey client)
+{
+  auto itr = players.find(client);
+  if (itr == players.end())
+  {
+    return;
+  }
+
+  Game::getInstance().getLogicSystem()->removeEntity(itr->second.entity);
+  players.erase(itr);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    inputs.erase(client);
+  }
+  Log::info(
+    TAG,
+    "%s:%u left, %u players",
+    getAddress(client).toString().c_str(),
+    getPort(client),
+    static_cast<unsigned>(players.size())
+    );
+}
+
+void GameServer::sendSnapshot()
+{
+  raw.clear();
+  ByteWriter out(raw);
+  out.writeVarint(static_cast<uint32_t>(players.size()));
+  for (auto& player : players)
+  {
+    out.writeVarint(player.second.entity);
+  }
+  Game::getInstance().saveWorldState(world);
+  out.writeBytes(world.data(), world.size());
+  lzCompress(raw.data(), raw.size(), compressed);
+
+  if (NET_SNAPSHOT_HEADER_SIZE + compressed.size() >
+      sf::UdpSocket::MaxDatagramSize)
+  {
+    Log::error(
+      TAG,
+      "Snapshot of %u bytes doesn't fit in a datagram",
+      static_cast<unsigned>(compressed.size())
+      );
+    return;
+  }
+
+  std::shared_ptr<sf::Packet> snapshot(new sf::Packet);
+  netBegin(*snapshot, NetMessage::Snapshot);
+  *snapshot << static_cast<sf::Uint32>(tickCount)
+    << static_cast<sf::Uint32>(raw.size());
+  snapshot->append(compressed.data(), compressed.size());
+
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto& player : players)
+  {
+    outgoing.push_back(Outgoing{player.first, snapshot});
+  }
+}
+
+void GameServer::queue(const ClientKey client,
+                       std::shared_ptr<const sf::Packet> packet)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  outgoing.push_back(Outgoing{client, packet});
+}
+
+void GameServer::networkLoop()
+{
+  AllocationScope allocations(AllocationTag::Network);
+  sf::SocketSelector selector;
+  selector.add(socket);
+  sf::Packet packet;
+  sf::IpAddress address;
+  unsigned short port;
+  while (!stopping)
+  {
+    if (selector.wait(sf::milliseconds(POLL_MS)))
+    {
+      // the socket doesn't block, so this reads everything that arrived
+      while (socket.receive(packet, address, port) == sf::Socket::Done)
+      {
+        receive(packet, makeKey(address, port));
+      }
+    }
+    dropQuietClients();
+    sendQueued();
+  }
+}
+
+void GameServer::receive(sf::Packet& packet, const ClientKey client)
+{
+  NetMessage message;
+  if (!netRead(packet, message))
+  {
+    badPackets++;
+    return;
+  }
+
+  auto itr = connections.find(client);
+  if (message == NetMessage::Hello)
+  {
+    if (itr == connections.end())
+    {
+      connections.emplace(client, Connection{Timer(true), 0});
+    }
+    else
+    {
+      itr->second.lastHeard.start();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    events.push_back(ConnectionEvent{client, true});
+    return;
+  }
+  if (itr == connections.end())
+  {
+    // dropped, or never said hello. A client still sending input doesn't
+    // know, and would never hear from the server again.
+    if (message == NetMessage::Input)
+    {
+      sendBye(client);
+    }
+    return;
+  }
+  itr->second.lastHeard.start();
+
+  if (message == NetMessage::Bye)
+  {
+    connections.erase(itr);
+    std::lock_guard<std::mutex> lock(mutex);
+    events.push_back(ConnectionEvent{client, false});
+    return;
+  }
+  if (message != NetMessage::Input)
+  {
+    badPackets++;
+    return;
+  }
+
+  sf::Uint32 sequence;
+  sf::Uint8 count;
+  InputState ticks[NET_INPUT_REDUNDANCY];
+  if (!(packet >> sequence >> count) || count > NET_INPUT_REDUNDANCY)
+  {
+    badPackets++;
+    return;
+  }
+  for (sf::Uint8 i = 0; i < count; i++)
+  {
+    if (!(packet >> ticks[i].held >> ticks[i].pressed >> ticks[i].released))
+    {
+      badPackets++;
+      return;
+    }
+  }
+  if (sequence <= itr->second.sequence)
+  {
+    // arrived out of order, a newer message already had these ticks
+    return;
+  }
+
+  // the ticks after the last message, oldest first
+  const uint32_t fresh = std::min<uint32_t>(
+    count,
+    sequence - itr->second.sequence
+    );
+  itr->second.sequence = sequence;
+  std::lock_guard<std::mutex> lock(mutex);
+  InputState& input = inputs[client];
+  for (uint32_t i = fresh; i-- > 0;)
+  {
+    input.held = ticks[i].held;
+    input.pressed |= ticks[i].pressed;
+    input.released |= ticks[i].released;
+  }
+}
+
+void GameServer::dropQuietClients()
+{
+  auto itr = connections.begin();
+  while (itr != connections.end())
+  {
+    if (itr->second.lastHeard.elapsedMilliF() > timeoutMs)
+    {
+      // in case it is only the client's messages that are being lost
+      sendBye(itr->first);
+      std::lock_guard<std::mutex> lock(mutex);
+      events.push_back(ConnectionEvent{itr->first, false});
+      itr = connections.erase(itr);
+    }
+    else
+    {
+      ++itr;
+    }
+  }
+}
+
+void GameServer::sendQueued()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    sending.swap(outgoing);
+  }
+  for (auto& out : sending)
+  {
+    const sf::Socket::Status status = socket.send(
+      out.packet->getData(),
+      out.packet->getDataSize(),
+      getAddress(out.client),
+      getPort(out.client)
+      );
+    if (status != sf::Socket::Done)
+    {
+      failedSends++;
+    }
+  }
+  sending.clear();
+}
+
+void GameServer::sendBye(const ClientKey client)
+{
+  sf::Packet bye;
+  netBegin(bye, NetMessage::Bye);
+  if (socket.send(bye, getAddress(client), getPort(client)) !=
+      sf::Socket::Done)
+  {
+    failedSends++;
+  }
+}
\ No newline at end of file
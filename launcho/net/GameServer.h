@@ -0,0 +1,140 @@
+#pragma once
+
+#include "input/InputState.h"
+#include "types.h"
+#include "utility/Timer.h"
+#include <SFML/Network.hpp>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Runs the authoritative simulation for remote players. A network thread owns
+ * the socket: it accepts clients, merges the input they send, drops the ones
+ * that go quiet, and sends whatever the main thread queued. A client that
+ * was dropped but is still sending is told so, and can join again. Once per
+ * logic tick update() runs on the main thread to spawn and remove players,
+ * apply their input, and queue a snapshot of the world when one is due, so
+ * the tick never waits on the network and the network never touches the
+ * world.
+ * See NetProtocol.h for the messages.
+ */
+class GameServer
+{
+private:
+  static const std::string TAG;
+
+  // address and port of a client
+  using ClientKey = uint64_t;
+
+  struct Connection
+  {
+    // since the last message from the client
+    Timer lastHeard;
+    // newest input tick received
+    uint32_t sequence;
+  };
+
+  struct ConnectionEvent
+  {
+    ClientKey client;
+    bool joined;
+  };
+
+  struct Outgoing
+  {
+    ClientKey client;
+    std::shared_ptr<const sf::Packet> packet;
+  };
+
+  struct RemotePlayer
+  {
+    EntityID entity;
+    InputState input;
+  };
+
+  uint32_t snapshotInterval;
+  float timeoutMs;
+  // ticks run since the server started
+  uint32_t tickCount;
+  // only touched by the main thread
+  std::map<ClientKey, RemotePlayer> players;
+  EntityID nextPlayerID;
+  std::vector<uint8_t> world;
+  std::vector<uint8_t> raw;
+  std::vector<uint8_t> compressed;
+  // joins and leaves being handled
+  std::deque<ConnectionEvent> changes;
+
+  std::mutex mutex;
+  std::deque<ConnectionEvent> events;
+  // input received since the last tick, by client
+  std::unordered_map<ClientKey, InputState> inputs;
+  std::deque<Outgoing> outgoing;
+  std::atomic<bool> stopping;
+  std::thread network;
+
+  // only touched by the network thread until it is joined
+  sf::UdpSocket socket;
+  std::unordered_map<ClientKey, Connection> connections;
+  // messages being sent
+  std::deque<Outgoing> sending;
+  // the log isn't thread safe, these are reported when the server stops
+  std::atomic<unsigned> badPackets;
+  std::atomic<unsigned> failedSends;
+
+public:
+  GameServer();
+  ~GameServer();
+  GameServer(const GameServer&) = delete;
+  GameServer& operator=(const GameServer&) = delete;
+
+  /**
+   * Binds the socket and starts the network thread.
+   * @param _snapshotInterval Ticks between snapshots.
+   * @param timeoutSeconds Clients that are quiet this long are dropped.
+   * @return false if the port couldn't be bound.
+   */
+  bool start(const unsigned short port, const uint32_t _snapshotInterval,
+             const float timeoutSeconds);
+
+  /**
+   * Tells the clients it is leaving and stops the network thread.
+   */
+  void stop();
+
+  bool isRunning() const;
+
+  /**
+   * Brings the remote players up to date for the next tick.
+   */
+  void update();
+
+  std::size_t getPlayerCount() const;
+
+private:
+  static ClientKey makeKey(const sf::IpAddress& address,
+                           const unsigned short port);
+  static sf::IpAddress getAddress(const ClientKey client);
+  static unsigned short getPort(const ClientKey client);
+
+  void join(const ClientKey client);
+  void leave(const ClientKey client);
+  void sendSnapshot();
+  // hands a message to the network thread
+  void queue(const ClientKey client, std::shared_ptr<const sf::Packet> packet);
+
+  void networkLoop();
+  void receive(sf::Packet& packet, const ClientKey client);
+  void dropQuietClients();
+  void sendQueued();
+  // tells a client it isn't connected, so it says hello again
+  void sendBye(const ClientKey client);
+};
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <SFML/Network.hpp>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Messages between a GameServer and its GameClients. Each one is a single
+ * datagram starting with NET_MAGIC, NET_VERSION and a NetMessage byte,
+ * written with sf::Packet so integers are in network byte order.
+ *
+ * Hello     client -> server, sent until a Welcome arrives
+ * Welcome   server -> client, u32 player entity, u32 logic tick rate
+ * Input     client -> server, u32 sequence of the newest tick, u8 count, then
+ *           count ticks of u32 held, pressed, released, newest first. Older
+ *           ticks are repeated so a lost datagram doesn't lose a key press.
+ *           Resent every quarter of the timeout while there is no new
+ *           input, so a client whose game has stalled isn't dropped
+ * Snapshot  server -> client, u32 tick, u32 raw size, then the lzCompress()ed
+ *           state: varint remote player count, their entity ids, and the
+ *           world state from Game::saveWorldState()
+ * Bye       either way, the sender is leaving. The server also sends it to
+ *           clients it dropped or doesn't know, which say Hello again
+ */
+
+// "LNET"
+static const uint32_t NET_MAGIC = 0x4c4e4554;
+static const uint8_t NET_VERSION = 1;
+
+enum class NetMessage : uint8_t
+{
+  Hello,
+  Welcome,
+  Input,
+  Snapshot,
+  Bye
+};
+
+// magic, version, message, tick and raw size, the state follows
+static const std::size_t NET_SNAPSHOT_HEADER_SIZE = 14;
+// ticks of input in each Input message
+static const uint8_t NET_INPUT_REDUNDANCY = 4;
+
+/**
+ * Starts a message.
+ */
+inline void netBegin(sf::Packet& packet, const NetMessage message)
+{
+  packet.clear();
+  packet << static_cast<sf::Uint32>(NET_MAGIC) << NET_VERSION
+    << static_cast<sf::Uint8>(message);
+}
+
+/**
+ * Reads the start of a message.
+ * @return false if it isn't one, or is from another version.
+ */
+inline bool netRead(sf::Packet& packet, NetMessage& message)
+{
+  sf::Uint32 magic;
+  sf::Uint8 version;
+  sf::Uint8 type;
+  if (!(packet >> magic >> version >> type) || magic != NET_MAGIC ||
+      version != NET_VERSION || type > static_cast<uint8_t>(NetMessage::Bye))
+  {
+    return false;
+  }
+  message = static_cast<NetMessage>(type);
+  return true;
+}
\ No newline at end of file
@@ -4,4 +4,85 @@
 
 static const std::string SCREEN_WIDTH = "screen_width";
 static const std::string SCREEN_HEIGHT = "screen_height";
-static const std::string WINDOW_TITLE = "window_title";
\ No newline at end of file
+static const std::string WINDOW_TITLE = "window_title";
+// "sfml", "software" to rasterize on the CPU without a window, or "null"
+static const std::string RENDER_SYSTEM = "render_system";
+// stop after this many frames, 0 to run until the window is closed
+static const std::string MAX_FRAMES = "max_frames";
+// logic updates per second
+static const std::string LOGIC_TICK_RATE = "logic_tick_rate";
+// most time spent dispatching events each logic update, in ms
+static const std::string EVENT_BUDGET = "event_budget";
+// physics steps per second
+static const std::string PHYSICS_STEP_RATE = "physics_step_rate";
+// Box2D solver iterations per step
+static const std::string PHYSICS_VELOCITY_ITERATIONS =
+  "physics_velocity_iterations";
+static const std::string PHYSICS_POSITION_ITERATIONS =
+  "physics_position_iterations";
+// 1 to reload the config file whenever it is saved
+static const std::string OPTIONS_WATCH = "options_watch";
+// keys bound to each input action, comma separated sf::Keyboard names
+static const std::string INPUT_MOVE_UP = "input_move_up";
+static const std::string INPUT_MOVE_DOWN = "input_move_down";
+static const std::string INPUT_MOVE_LEFT = "input_move_left";
+static const std::string INPUT_MOVE_RIGHT = "input_move_right";
+static const std::string INPUT_FIRE = "input_fire";
+// replay file to record each logic tick's input to, empty to not record
+static const std::string INPUT_RECORD = "input_record";
+// ticks between the world keyframes a recording can be seeked to
+static const std::string INPUT_KEYFRAME_INTERVAL = "input_keyframe_interval";
+// replay to play back instead of reading the keyboard, the game exits when it
+// ends
+static const std::string INPUT_REPLAY = "input_replay";
+// seconds into the replay to start from, changing it while the replay plays
+// jumps there
+static const std::string REPLAY_SEEK = "replay_seek";
+// seed for everything random in a run, 0 to pick one
+static const std::string RANDOM_SEED = "random_seed";
+// "server" to run the world for remote players, "client" to play on a
+// server, or empty to play alone
+static const std::string NET_MODE = "net_mode";
+// server a client connects to
+static const std::string NET_ADDRESS = "net_address";
+// udp port the server listens on
+static const std::string NET_PORT = "net_port";
+// world snapshots the server sends each client per second
+static const std::string NET_SNAPSHOT_RATE = "net_snapshot_rate";
+// seconds without hearing from the other side before giving up on it
+static const std::string NET_TIMEOUT = "net_timeout";
+// threads started in addition to the main thread, -1 for one less than the
+// number of cores
+static const std::string WORKER_THREADS = "worker_threads";
+// "quadtree" or "grid"
+static const std::string SPATIAL_INDEX = "spatial_index";
+// 1 to show the performance overlay
+static const std::string STATS_OVERLAY = "stats_overlay";
+// 1 to draw renderables in batches, 0 to draw them one at a time
+static const std::string RENDER_BATCHING = "render_batching";
+// 1 to skip renderables outside of the view, 0 to draw everything
+static const std::string RENDER_CULLING = "render_culling";
+// 1 to draw the static layers (scenery and background) from cached textures
+static const std::string RENDER_LAYER_CACHE = "render_layer_cache";
+// render time budget in ms, the sfml renderer lowers its resolution to stay
+// under it, 0 to always render at full resolution
+static const std::string DYNAMIC_RESOLUTION_BUDGET =
+  "dynamic_resolution_budget";
+// lowest resolution to render at, as a percentage of the window size
+static const std::string DYNAMIC_RESOLUTION_MIN = "dynamic_resolution_min";
+// software renderer frame dumps, an empty prefix disables them
+static const std::string RENDER_DUMP_PREFIX = "render_dump_prefix";
+// dump every nth frame
+static const std::string RENDER_DUMP_INTERVAL = "render_dump_interval";
+// "ppm" or "png"
+static const std::string RENDER_DUMP_FORMAT = "render_dump_format";
+// frame capture for recording sessions, an empty prefix disables it
+static const std::string CAPTURE_PREFIX = "capture_prefix";
+// capture every nth frame
+static const std::string CAPTURE_INTERVAL = "capture_interval";
+// "lz" for a single compressed stream, or "png" for a file per frame
+static const std::string CAPTURE_FORMAT = "capture_format";
+// frames that can wait to be encoded before new ones are dropped
+static const std::string CAPTURE_BUFFERS = "capture_buffers";
+// set to a capture stream to write its frames out as PNGs instead of playing
+static const std::string CAPTURE_EXTRACT = "capture_extract";
\ No newline at end of file
@@ -0,0 +1,393 @@
+#include "spatial/HashGrid.h"
+#include "utility/FrameArena.h"
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <utility>
+
+static const uint32_t INITIAL_BUCKETS = 1024;
+
+HashGrid::HashGrid(const float cellSize)
+: cellSize(cellSize),
+  invCellSize(1.0f / cellSize),
+  buckets(INITIAL_BUCKETS),
+  bucketMask(INITIAL_BUCKETS - 1),
+  oversized(),
+  entries(),
+  lookup(),
+  queryStamp(0)
+{
+  assert(cellSize > 0.0f);
+  resetOccupied();
+}
+
+const char* HashGrid::getNameC() const
+{
+  return "HashGrid";
+}
+
+void HashGrid::insert(const EntityID id, const AABB2& bounds)
+{
+  assert(lookup.find(id) == lookup.end());
+  if (entries.size() >= buckets.size() * 2)
+  {
+    grow();
+  }
+
+  const uint32_t index = static_cast<uint32_t>(entries.size());
+  Entry entry;
+  entry.id = id;
+  entry.bounds = bounds;
+  entry.cells = cellsFor(bounds);
+  entry.oversized = false;
+  entry.stamp = 0;
+  entries.push_back(entry);
+  lookup[id] = index;
+  link(index);
+}
+
+void HashGrid::update(const EntityID id, const AABB2& bounds)
+{
+  auto itr = lookup.find(id);
+  assert(itr != lookup.end());
+  Entry& entry = entries[itr->second];
+  entry.bounds = bounds;
+
+  // most moves are small and stay in the same cells
+  const CellRange cells = cellsFor(bounds);
+  if (cells.minX != entry.cells.minX || cells.minY != entry.cells.minY ||
+      cells.maxX != entry.cells.maxX || cells.maxY != entry.cells.maxY)
+  {
+    unlink(itr->second);
+    entry.cells = cells;
+    link(itr->second);
+  }
+}
+
+void HashGrid::remove(const EntityID id)
+{
+  auto itr = lookup.find(id);
+  if (itr == lookup.end())
+  {
+    return;
+  }
+
+  const uint32_t index = itr->second;
+  lookup.erase(itr);
+  unlink(index);
+
+  // swap the last entry into the hole
+  const uint32_t last = static_cast<uint32_t>(entries.size() - 1);
+  if (index != last)
+  {
+    relink(last, index);
+    entries[index] = entries[last];
+    lookup[entries[index].id] = index;
+  }
+  entries.pop_back();
+  if (entries.empty())
+  {
+    resetOccupied();
+  }
+}
+
+void HashGrid::clear()
+{
+  for (auto& bucket : buckets)
+  {
+    bucket.clear();
+  }
+  oversized.clear();
+  entries.clear();
+  lookup.clear();
+  resetOccupied();
+}
+
+std::size_t HashGrid::size() const
+{
+  return entries.size();
+}
+
+void HashGrid::query(const AABB2& area, std::vector<EntityID>& results) const
+{
+  const uint32_t stamp = nextStamp();
+  const CellRange cells = cellsFor(area);
+  const int64_t cellCount =
+    (int64_t(cells.maxX) - cells.minX + 1) *
+    (int64_t(cells.maxY) - cells.minY + 1);
+
+  if (cellCount > static_cast<int64_t>(buckets.size()))
+  {
+    // the area covers more cells than there are buckets, it's cheaper to
+    // look at everything
+    for (const Entry& entry : entries)
+    {
+      if (entry.bounds.intersect(area))
+      {
+        results.push_back(entry.id);
+      }
+    }
+    return;
+  }
+
+  for (int32_t y = cells.minY; y <= cells.maxY; y++)
+  {
+    for (int32_t x = cells.minX; x <= cells.maxX; x++)
+    {
+      for (uint32_t item : buckets[bucketFor(x, y)])
+      {
+        const Entry& entry = entries[item];
+        if (entry.stamp != stamp)
+        {
+          entry.stamp = stamp;
+          if (entry.bounds.intersect(area))
+          {
+            results.push_back(entry.id);
+          }
+        }
+      }
+    }
+  }
+
+  for (uint32_t item : oversized)
+  {
+    if (entries[item].bounds.intersect(area))
+    {
+      results.push_back(entries[item].id);
+    }
+  }
+}
+
+void HashGrid::queryNearest(const Vector2& point, const std::size_t k,
+                            std::vector<EntityID>& results) const
+{
+  if (k == 0 || entries.empty())
+  {
+    return;
+  }
+
+  const uint32_t stamp = nextStamp();
+  ArenaScope scratch(FrameArena::local());
+  ArenaVector<std::pair<float, uint32_t>> candidates;
+  for (uint32_t item : oversized)
+  {
+    candidates.push_back(
+      std::make_pair(entries[item].bounds.distanceSquared(point), item)
+      );
+  }
+
+  auto visit = [&](const int32_t x, const int32_t y) {
+    if (x < occupied.minX || x > occupied.maxX ||
+        y < occupied.minY || y > occupied.maxY)
+    {
+      return;
+    }
+    for (uint32_t item : buckets[bucketFor(x, y)])
+    {
+      const Entry& entry = entries[item];
+      if (entry.stamp != stamp)
+      {
+        entry.stamp = stamp;
+        candidates.push_back(
+          std::make_pair(entry.bounds.distanceSquared(point), item)
+          );
+      }
+    }
+  };
+
+  // search rings of cells outwards from the point. After ring r everything
+  // within r cells has been seen, so once the kth candidate is closer than
+  // that the search can stop. It also stops once every entry has been seen,
+  // since the occupied range never shrinks while entries move.
+  const int32_t px = cellFor(point.x);
+  const int32_t py = cellFor(point.y);
+  const int64_t maxRing = std::max(
+    std::max(int64_t(px) - occupied.minX, int64_t(occupied.maxX) - px),
+    std::max(int64_t(py) - occupied.minY, int64_t(occupied.maxY) - py)
+    );
+
+  for (int64_t r = 0; r <= maxRing; r++)
+  {
+    const int32_t ring = static_cast<int32_t>(r);
+    if (ring == 0)
+    {
+      visit(px, py);
+    }
+    else
+    {
+      for (int32_t i = -ring; i <= ring; i++)
+      {
+        visit(px + i, py - ring);
+        visit(px + i, py + ring);
+      }
+      for (int32_t i = -ring + 1; i < ring; i++)
+      {
+        visit(px - ring, py + i);
+        visit(px + ring, py + i);
+      }
+    }
+
+    if (candidates.size() == entries.size())
+    {
+      break;
+    }
+    if (candidates.size() >= k)
+    {
+      std::nth_element(candidates.begin(), candidates.begin() + (k - 1),
+                       candidates.end());
+      const float covered = static_cast<float>(r) * cellSize;
+      if (candidates[k - 1].first <= covered * covered)
+      {
+        break;
+      }
+    }
+  }
+
+  const std::size_t count = std::min(k, candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + count,
+                    candidates.end());
+  for (std::size_t i = 0; i < count; i++)
+  {
+    results.push_back(entries[candidates[i].second].id);
+  }
+}
+
+HashGrid::CellRange HashGrid::cellsFor(const AABB2& bounds) const
+{
+  const Vector2 lower = bounds.lowerLeft();
+  const Vector2 upper = bounds.upperRight();
+  CellRange range;
+  range.minX = cellFor(lower.x);
+  range.minY = cellFor(lower.y);
+  range.maxX = cellFor(upper.x);
+  range.maxY = cellFor(upper.y);
+  return range;
+}
+
+int32_t HashGrid::cellFor(const float coord) const
+{
+  // clamp so that far away coordinates don't overflow
+  const float cell = std::floor(coord * invCellSize);
+  return static_cast<int32_t>(
+    std::max(std::min(cell, 1.0e9f), -1.0e9f)
+    );
+}
+
+uint32_t HashGrid::bucketFor(const int32_t x, const int32_t y) const
+{
+  const uint32_t h = (static_cast<uint32_t>(x) * 73856093u) ^
+                     (static_cast<uint32_t>(y) * 19349663u);
+  return h & bucketMask;
+}
+
+void HashGrid::link(const uint32_t entry)
+{
+  Entry& e = entries[entry];
+  const CellRange& c = e.cells;
+  const int64_t cellCount =
+    (int64_t(c.maxX) - c.minX + 1) * (int64_t(c.maxY) - c.minY + 1);
+
+  e.oversized = cellCount > MAX_CELLS_PER_ENTRY;
+  if (e.oversized)
+  {
+    oversized.push_back(entry);
+    return;
+  }
+
+  for (int32_t y = c.minY; y <= c.maxY; y++)
+  {
+    for (int32_t x = c.minX; x <= c.maxX; x++)
+    {
+      buckets[bucketFor(x, y)].push_back(entry);
+    }
+  }
+
+  occupied.minX = std::min(occupied.minX, c.minX);
+  occupied.minY = std::min(occupied.minY, c.minY);
+  occupied.maxX = std::max(occupied.maxX, c.maxX);
+  occupied.maxY = std::max(occupied.maxY, c.maxY);
+}
+
+void HashGrid::unlink(const uint32_t entry)
+{
+  const Entry& e = entries[entry];
+  if (e.oversized)
+  {
+    auto itr = std::find(oversized.begin(), oversized.end(), entry);
+    assert(itr != oversized.end());
+    *itr = oversized.back();
+    oversized.pop_back();
+    return;
+  }
+
+  const CellRange& c = e.cells;
+  for (int32_t y = c.minY; y <= c.maxY; y++)
+  {
+    for (int32_t x = c.minX; x <= c.maxX; x++)
+    {
+      std::vector<uint32_t>& bucket = buckets[bucketFor(x, y)];
+      auto itr = std::find(bucket.begin(), bucket.end(), entry);
+      assert(itr != bucket.end());
+      *itr = bucket.back();
+      bucket.pop_back();
+    }
+  }
+}
+
+void HashGrid::relink(const uint32_t from, const uint32_t to)
+{
+  const Entry& e = entries[from];
+  if (e.oversized)
+  {
+    *std::find(oversized.begin(), oversized.end(), from) = to;
+    return;
+  }
+
+  const CellRange& c = e.cells;
+  for (int32_t y = c.minY; y <= c.maxY; y++)
+  {
+    for (int32_t x = c.minX; x <= c.maxX; x++)
+    {
+      std::vector<uint32_t>& bucket = buckets[bucketFor(x, y)];
+      *std::find(bucket.begin(), bucket.end(), from) = to;
+    }
+  }
+}
+
+void HashGrid::grow()
+{
+  const std::size_t count = buckets.size() * 2;
+  buckets.clear();
+  buckets.resize(count);
+  bucketMask = static_cast<uint32_t>(count - 1);
+  oversized.clear();
+
+  for (uint32_t i = 0; i < entries.size(); i++)
+  {
+    link(i);
+  }
+}
+
+uint32_t HashGrid::nextStamp() const
+{
+  queryStamp++;
+  if (queryStamp == 0)
+  {
+    // wrapped around, old stamps could match again
+    for (const Entry& entry : entries)
+    {
+      entry.stamp = 0;
+    }
+    queryStamp = 1;
+  }
+  return queryStamp;
+}
+
+void HashGrid::resetOccupied()
+{
+  occupied.minX = INT_MAX;
+  occupied.minY = INT_MAX;
+  occupied.maxX = INT_MIN;
+  occupied.maxY = INT_MIN;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "spatial/ISpatialIndex.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Uniform grid spatial index over an unbounded world. Cells are hashed into a
+ * fixed number of buckets that grows with the entity count, so memory only
+ * depends on how many entities there are. Entities are stored in every cell
+ * they overlap, entities that would cover too many cells are kept in a
+ * separate list that every query checks.
+ */
+class HashGrid final
+  : public ISpatialIndex
+{
+private:
+  // entities covering more cells than this go in the oversized list
+  static const int MAX_CELLS_PER_ENTRY = 16;
+
+  // range of cells covered by some bounds, inclusive
+  struct CellRange
+  {
+    int32_t minX;
+    int32_t minY;
+    int32_t maxX;
+    int32_t maxY;
+  };
+
+  struct Entry
+  {
+    EntityID id;
+    AABB2 bounds;
+    CellRange cells;
+    bool oversized;
+    // last query that visited this entry, filters duplicates
+    mutable uint32_t stamp;
+  };
+
+  float cellSize;
+  float invCellSize;
+  std::vector<std::vector<uint32_t>> buckets;
+  uint32_t bucketMask;
+  std::vector<uint32_t> oversized;
+  std::vector<Entry> entries;
+  std::unordered_map<EntityID, uint32_t> lookup;
+  // every cell that has held an entity since the grid was last emptied,
+  // bounds the nearest search
+  CellRange occupied;
+  mutable uint32_t queryStamp;
+
+public:
+  /**
+   * @param cellSize Width of a grid cell, ideally a bit bigger than a typical
+   * entity.
+   */
+  explicit HashGrid(const float cellSize = 64.0f);
+
+  const char* getNameC() const override;
+  void insert(const EntityID id, const AABB2& bounds) override;
+  void update(const EntityID id, const AABB2& bounds) override;
+  void remove(const EntityID id) override;
+  void clear() override;
+  std::size_t size() const override;
+  void query(const AABB2& area, std::vector<EntityID>& results) const override;
+  void queryNearest(const Vector2& point, const std::size_t k,
+                    std::vector<EntityID>& results) const override;
+
+private:
+  CellRange cellsFor(const AABB2& bounds) const;
+  int32_t cellFor(const float coord) const;
+  uint32_t bucketFor(const int32_t x, const int32_t y) const;
+  void link(const uint32_t entry);
+  void unlink(const uint32_t entry);
+  // replaces one reference to an entry with another in all of its cells
+  void relink(const uint32_t from, const uint32_t to);
+  // doubles the bucket count and re-adds every entry
+  void grow();
+  // empties the occupied range
+  void resetOccupied();
+  // starts a new query, returns the stamp to mark visited entries with
+  uint32_t nextStamp() const;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "types.h"
+#include "math/AABB2.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * Finds entities by their location in the world. Entities are tracked by id
+ * with a bounding box, and are updated in place as they move.
+ */
+class ISpatialIndex
+{
+public:
+  virtual ~ISpatialIndex() = default;
+
+  // Name of the implementation, for logs and benchmarks.
+  virtual const char* getNameC() const = 0;
+
+  /**
+   * Adds an entity to the index.
+   * @param id The entity, must not already be in the index.
+   * @param bounds The area the entity covers.
+   */
+  virtual void insert(const EntityID id, const AABB2& bounds) = 0;
+
+  /**
+   * Changes the bounds of an entity that is already in the index.
+   */
+  virtual void update(const EntityID id, const AABB2& bounds) = 0;
+
+  // Removes an entity from the index, does nothing if it isn't there.
+  virtual void remove(const EntityID id) = 0;
+
+  // Removes everything from the index.
+  virtual void clear() = 0;
+
+  // Number of entities in the index.
+  virtual std::size_t size() const = 0;
+
+  /**
+   * Finds the entities whose bounds intersect an area.
+   * @param area The area to search.
+   * @param results[out] The ids found are appended to this list, in no
+   * particular order.
+   */
+  virtual void query(const AABB2& area,
+                     std::vector<EntityID>& results) const = 0;
+
+  /**
+   * Finds the entities whose bounds are closest to a point.
+   * @param point The point to search from.
+   * @param k Maximum number of entities to find.
+   * @param results[out] The ids found are appended to this list, nearest first.
+   */
+  virtual void queryNearest(const Vector2& point, const std::size_t k,
+                            std::vector<EntityID>& results) const = 0;
+};
@@ -0,0 +1,295 @@
+#include "spatial/LooseQuadtree.h"
+#include "utility/FrameArena.h"
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <queue>
+
+const int32_t LooseQuadtree::NO_NODE;
+const int LooseQuadtree::MAX_DEPTH;
+
+LooseQuadtree::LooseQuadtree(const Vector2& center, const float halfSize,
+                             const int maxDepth)
+: maxDepth(std::min(maxDepth, MAX_DEPTH)),
+  nodes(),
+  entries(),
+  lookup()
+{
+  assert(halfSize > 0.0f);
+  Node root;
+  root.center = center;
+  root.halfSize = halfSize;
+  root.parent = NO_NODE;
+  std::fill(std::begin(root.children), std::end(root.children), NO_NODE);
+  root.count = 0;
+  nodes.push_back(root);
+}
+
+const char* LooseQuadtree::getNameC() const
+{
+  return "LooseQuadtree";
+}
+
+void LooseQuadtree::insert(const EntityID id, const AABB2& bounds)
+{
+  assert(lookup.find(id) == lookup.end());
+  const uint32_t index = static_cast<uint32_t>(entries.size());
+  Entry entry;
+  entry.id = id;
+  entry.bounds = bounds;
+  entry.node = NO_NODE;
+  entry.slot = 0;
+  entries.push_back(entry);
+  lookup[id] = index;
+  attach(index, findNode(bounds));
+}
+
+void LooseQuadtree::update(const EntityID id, const AABB2& bounds)
+{
+  auto itr = lookup.find(id);
+  assert(itr != lookup.end());
+  const uint32_t index = itr->second;
+  entries[index].bounds = bounds;
+
+  // most moves are small and stay in the same node
+  const int32_t node = findNode(bounds);
+  if (node != entries[index].node)
+  {
+    detach(index);
+    attach(index, node);
+  }
+}
+
+void LooseQuadtree::remove(const EntityID id)
+{
+  auto itr = lookup.find(id);
+  if (itr == lookup.end())
+  {
+    return;
+  }
+
+  const uint32_t index = itr->second;
+  lookup.erase(itr);
+  detach(index);
+
+  // swap the last entry into the hole
+  const uint32_t last = static_cast<uint32_t>(entries.size() - 1);
+  if (index != last)
+  {
+    Entry& moved = entries[index];
+    moved = entries[last];
+    nodes[moved.node].items[moved.slot] = index;
+    lookup[moved.id] = index;
+  }
+  entries.pop_back();
+}
+
+void LooseQuadtree::clear()
+{
+  nodes.resize(1);
+  nodes[0].items.clear();
+  std::fill(std::begin(nodes[0].children), std::end(nodes[0].children),
+            NO_NODE);
+  nodes[0].count = 0;
+  entries.clear();
+  lookup.clear();
+}
+
+std::size_t LooseQuadtree::size() const
+{
+  return entries.size();
+}
+
+void LooseQuadtree::query(const AABB2& area,
+                          std::vector<EntityID>& results) const
+{
+  // depth first, each level pushes at most 4 nodes
+  int32_t stack[4 * MAX_DEPTH + 1];
+  int top = 0;
+  stack[top++] = 0;
+
+  while (top > 0)
+  {
+    const Node& node = nodes[stack[--top]];
+    // the root is always visited since it holds entities outside the world
+    const AABB2 loose = looseBounds(node);
+    if (node.parent != NO_NODE && !area.intersect(loose))
+    {
+      continue;
+    }
+
+    // the root's items can be outside the world, so they are always tested
+    if (node.parent != NO_NODE && area.contains(loose))
+    {
+      // everything in a node fits in its loose bounds
+      for (uint32_t item : node.items)
+      {
+        results.push_back(entries[item].id);
+      }
+    }
+    else
+    {
+      for (uint32_t item : node.items)
+      {
+        if (entries[item].bounds.intersect(area))
+        {
+          results.push_back(entries[item].id);
+        }
+      }
+    }
+
+    for (int32_t child : node.children)
+    {
+      if (child != NO_NODE && nodes[child].count > 0)
+      {
+        stack[top++] = child;
+      }
+    }
+  }
+}
+
+void LooseQuadtree::queryNearest(const Vector2& point, const std::size_t k,
+                                 std::vector<EntityID>& results) const
+{
+  // best first search, nodes are ordered by the distance to their loose
+  // bounds which can never be more than the distance to anything inside
+  struct Candidate
+  {
+    float distance;
+    int32_t node;
+    uint32_t entry;
+
+    bool operator>(const Candidate& rhs) const
+    {
+      return distance > rhs.distance;
+    }
+  };
+
+  ArenaScope scratch(FrameArena::local());
+  std::priority_queue<Candidate, ArenaVector<Candidate>,
+                      std::greater<Candidate>> open;
+  Candidate root = { 0.0f, 0, 0 };
+  open.push(root);
+
+  std::size_t found = 0;
+  while (!open.empty() && found < k)
+  {
+    const Candidate next = open.top();
+    open.pop();
+
+    if (next.node == NO_NODE)
+    {
+      results.push_back(entries[next.entry].id);
+      found++;
+      continue;
+    }
+
+    const Node& node = nodes[next.node];
+    for (uint32_t item : node.items)
+    {
+      Candidate c = { entries[item].bounds.distanceSquared(point), NO_NODE,
+                      item };
+      open.push(c);
+    }
+    for (int32_t child : node.children)
+    {
+      if (child != NO_NODE && nodes[child].count > 0)
+      {
+        Candidate c = {
+          looseBounds(nodes[child]).distanceSquared(point), child, 0
+        };
+        open.push(c);
+      }
+    }
+  }
+}
+
+int32_t LooseQuadtree::findNode(const AABB2& bounds)
+{
+  const float extent = std::max(bounds.halfSize.x, bounds.halfSize.y);
+  const Vector2& pt = bounds.center;
+
+  int32_t node = 0;
+  if (!AABB2(nodes[0].center, Vector2(nodes[0].halfSize, nodes[0].halfSize))
+         .contains(pt))
+  {
+    return node;
+  }
+
+  for (int depth = 0; depth < maxDepth; depth++)
+  {
+    // an entity fits in a child's loose bounds as long as it is no bigger
+    // than the child's tight bounds
+    if (extent > nodes[node].halfSize * 0.5f)
+    {
+      break;
+    }
+
+    const Vector2& c = nodes[node].center;
+    const int quadrant = (pt.x >= c.x ? 1 : 0) | (pt.y >= c.y ? 2 : 0);
+    node = getChild(node, quadrant);
+  }
+
+  return node;
+}
+
+int32_t LooseQuadtree::getChild(const int32_t node, const int quadrant)
+{
+  if (nodes[node].children[quadrant] != NO_NODE)
+  {
+    return nodes[node].children[quadrant];
+  }
+
+  const float half = nodes[node].halfSize * 0.5f;
+  Node child;
+  child.center = nodes[node].center + Vector2(
+    (quadrant & 1) ? half : -half,
+    (quadrant & 2) ? half : -half
+    );
+  child.halfSize = half;
+  child.parent = node;
+  std::fill(std::begin(child.children), std::end(child.children), NO_NODE);
+  child.count = 0;
+
+  // careful, this invalidates references into nodes
+  const int32_t index = static_cast<int32_t>(nodes.size());
+  nodes.push_back(child);
+  nodes[node].children[quadrant] = index;
+  return index;
+}
+
+void LooseQuadtree::attach(const uint32_t entry, const int32_t node)
+{
+  Entry& e = entries[entry];
+  e.node = node;
+  e.slot = static_cast<uint32_t>(nodes[node].items.size());
+  nodes[node].items.push_back(entry);
+
+  for (int32_t n = node; n != NO_NODE; n = nodes[n].parent)
+  {
+    nodes[n].count++;
+  }
+}
+
+void LooseQuadtree::detach(const uint32_t entry)
+{
+  const Entry& e = entries[entry];
+  std::vector<uint32_t>& items = nodes[e.node].items;
+
+  // swap remove from the node's item list
+  const uint32_t moved = items.back();
+  items[e.slot] = moved;
+  entries[moved].slot = e.slot;
+  items.pop_back();
+
+  for (int32_t n = e.node; n != NO_NODE; n = nodes[n].parent)
+  {
+    nodes[n].count--;
+  }
+}
+
+AABB2 LooseQuadtree::looseBounds(const Node& node) const
+{
+  const float loose = node.halfSize * 2.0f;
+  return AABB2(node.center, Vector2(loose, loose));
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "spatial/ISpatialIndex.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Loose quadtree spatial index. Each node's bounds are stretched to twice its
+ * size, which lets an entity be placed by its center and size alone: it goes
+ * in the deepest node whose loose bounds still contain it, and never has to
+ * be split across children. Entities outside the world bounds are kept in
+ * the root.
+ */
+class LooseQuadtree final
+  : public ISpatialIndex
+{
+private:
+  static const int32_t NO_NODE = -1;
+  // keeps the traversal stack a fixed size
+  static const int MAX_DEPTH = 16;
+
+  struct Node
+  {
+    // tight region covered by the node, the loose bounds are twice this size
+    Vector2 center;
+    float halfSize;
+    int32_t parent;
+    int32_t children[4];
+    // entries stored directly in this node
+    std::vector<uint32_t> items;
+    // entries in this node and all of its descendants
+    uint32_t count;
+  };
+
+  struct Entry
+  {
+    EntityID id;
+    AABB2 bounds;
+    int32_t node;
+    // position in the node's item list
+    uint32_t slot;
+  };
+
+  int maxDepth;
+  std::vector<Node> nodes;
+  std::vector<Entry> entries;
+  std::unordered_map<EntityID, uint32_t> lookup;
+
+public:
+  /**
+   * @param center Center of the world.
+   * @param halfSize Half the width of the (square) world.
+   * @param maxDepth Maximum levels below the root, at most 16.
+   */
+  LooseQuadtree(const Vector2& center, const float halfSize,
+                const int maxDepth = 10);
+
+  const char* getNameC() const override;
+  void insert(const EntityID id, const AABB2& bounds) override;
+  void update(const EntityID id, const AABB2& bounds) override;
+  void remove(const EntityID id) override;
+  void clear() override;
+  std::size_t size() const override;
+  void query(const AABB2& area, std::vector<EntityID>& results) const override;
+  void queryNearest(const Vector2& point, const std::size_t k,
+                    std::vector<EntityID>& results) const override;
+
+private:
+  // finds the node an entity with the bounds belongs in, creating it if needed
+  int32_t findNode(const AABB2& bounds);
+  int32_t getChild(const int32_t node, const int quadrant);
+  void attach(const uint32_t entry, const int32_t node);
+  void detach(const uint32_t entry);
+  AABB2 looseBounds(const Node& node) const;
+};
@@ -0,0 +1,333 @@
+#include "TileMap.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+TileMap::TileMap(const int _width, const int _height, const float _tileSize)
+: width(_width),
+  height(_height),
+  tileSize(_tileSize),
+  chunksX((_width + CHUNK_SIZE - 1) / CHUNK_SIZE),
+  chunksY((_height + CHUNK_SIZE - 1) / CHUNK_SIZE),
+  chunks(),
+  types()
+{
+  assert(width > 0 && height > 0 && tileSize > 0.0f);
+  chunks.resize(chunksX * chunksY);
+
+  TileType empty;
+  empty.texture = nullptr;
+  empty.color = sf::Color::Transparent;
+  empty.solid = false;
+  types.push_back(empty);
+}
+
+TileID TileMap::addTileType(const TileType& type)
+{
+  assert(types.size() <= UINT16_MAX);
+  types.push_back(type);
+  return static_cast<TileID>(types.size() - 1);
+}
+
+const TileType& TileMap::getTileType(const TileID id) const
+{
+  assert(id < types.size());
+  return types[id];
+}
+
+TileID TileMap::getTile(const int x, const int y) const
+{
+  if (x < 0 || y < 0 || x >= width || y >= height)
+  {
+    return 0;
+  }
+
+  const Chunk* chunk = getChunk(x / CHUNK_SIZE, y / CHUNK_SIZE);
+  if (chunk == nullptr)
+  {
+    return 0;
+  }
+  return chunk->tiles[((y % CHUNK_SIZE) * CHUNK_SIZE) + (x % CHUNK_SIZE)];
+}
+
+void TileMap::setTile(const int x, const int y, const TileID id)
+{
+  assert(x >= 0 && y >= 0 && x < width && y < height);
+  assert(id < types.size());
+
+  std::unique_ptr<Chunk>& chunk =
+    chunks[((y / CHUNK_SIZE) * chunksX) + (x / CHUNK_SIZE)];
+  if (chunk == nullptr)
+  {
+    if (id == 0)
+    {
+      return;
+    }
+    chunk.reset(new Chunk());
+    std::memset(chunk->tiles, 0, sizeof(chunk->tiles));
+    chunk->meshValid = false;
+    chunk->collisionDirty = false;
+    chunk->lastUsed = 0;
+  }
+
+  TileID& tile =
+    chunk->tiles[((y % CHUNK_SIZE) * CHUNK_SIZE) + (x % CHUNK_SIZE)];
+  if (tile != id)
+  {
+    if (types[tile].solid || types[id].solid)
+    {
+      chunk->collisionDirty = true;
+    }
+    tile = id;
+    chunk->meshValid = false;
+  }
+}
+
+void TileMap::fill(const int x, const int y, const int w, const int h,
+                   const TileID id)
+{
+  const int x0 = std::max(x, 0);
+  const int y0 = std::max(y, 0);
+  const int x1 = std::min(x + w, width);
+  const int y1 = std::min(y + h, height);
+  for (int ty = y0; ty < y1; ty++)
+  {
+    for (int tx = x0; tx < x1; tx++)
+    {
+      setTile(tx, ty, id);
+    }
+  }
+}
+
+int TileMap::getWidth() const
+{
+  return width;
+}
+
+int TileMap::getHeight() const
+{
+  return height;
+}
+
+float TileMap::getTileSize() const
+{
+  return tileSize;
+}
+
+int TileMap::getChunksX() const
+{
+  return chunksX;
+}
+
+int TileMap::getChunksY() const
+{
+  return chunksY;
+}
+
+bool TileMap::getChunkRange(const AABB2& area, int& minX, int& minY,
+                            int& maxX, int& maxY) const
+{
+  const float chunkSize = tileSize * CHUNK_SIZE;
+  const Vector2 lower = area.lowerLeft();
+  const Vector2 upper = area.upperRight();
+  minX = std::max(0, static_cast<int>(std::floor(lower.x / chunkSize)));
+  minY = std::max(0, static_cast<int>(std::floor(lower.y / chunkSize)));
+  maxX = std::min(chunksX - 1,
+                  static_cast<int>(std::floor(upper.x / chunkSize)));
+  maxY = std::min(chunksY - 1,
+                  static_cast<int>(std::floor(upper.y / chunkSize)));
+  return minX <= maxX && minY <= maxY;
+}
+
+const std::vector<TileMap::MeshBatch>* TileMap::getChunkMesh(
+  const int cx, const int cy, const uint32_t frame)
+{
+  Chunk* chunk = getChunk(cx, cy);
+  if (chunk == nullptr)
+  {
+    return nullptr;
+  }
+
+  if (!chunk->meshValid)
+  {
+    buildMesh(*chunk, cx, cy);
+  }
+  chunk->lastUsed = frame;
+  return &chunk->mesh;
+}
+
+void TileMap::releaseStaleMeshes(const uint32_t frame, const uint32_t maxAge)
+{
+  for (auto& chunk : chunks)
+  {
+    if (chunk != nullptr && chunk->meshValid &&
+        frame - chunk->lastUsed > maxAge)
+    {
+      // swap with an empty vector so the memory is actually returned
+      std::vector<MeshBatch>().swap(chunk->mesh);
+      chunk->meshValid = false;
+    }
+  }
+}
+
+void TileMap::takeCollisionChanges(std::vector<int>& out)
+{
+  out.clear();
+  for (std::size_t i = 0; i < chunks.size(); i++)
+  {
+    if (chunks[i] != nullptr && chunks[i]->collisionDirty)
+    {
+      chunks[i]->collisionDirty = false;
+      out.push_back(static_cast<int>(i));
+    }
+  }
+}
+
+void TileMap::buildCollision(const int cx, const int cy,
+                             std::vector<TileRect>& out) const
+{
+  out.clear();
+  const Chunk* chunk = getChunk(cx, cy);
+  if (chunk == nullptr)
+  {
+    return;
+  }
+
+  bool solid[CHUNK_SIZE * CHUNK_SIZE];
+  for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; i++)
+  {
+    solid[i] = types[chunk->tiles[i]].solid;
+  }
+
+  for (int y = 0; y < CHUNK_SIZE; y++)
+  {
+    for (int x = 0; x < CHUNK_SIZE; x++)
+    {
+      if (!solid[(y * CHUNK_SIZE) + x])
+      {
+        continue;
+      }
+
+      // widest run in this row, then as many rows above as match it
+      int w = 1;
+      while (x + w < CHUNK_SIZE && solid[(y * CHUNK_SIZE) + x + w])
+      {
+        w++;
+      }
+      int h = 1;
+      while (y + h < CHUNK_SIZE)
+      {
+        const bool* row = solid + ((y + h) * CHUNK_SIZE) + x;
+        if (std::find(row, row + w, false) != row + w)
+        {
+          break;
+        }
+        h++;
+      }
+
+      // tiles in the box are used up
+      for (int ty = y; ty < y + h; ty++)
+      {
+        std::fill_n(solid + (ty * CHUNK_SIZE) + x, w, false);
+      }
+
+      TileRect rect = {
+        (cx * CHUNK_SIZE) + x,
+        (cy * CHUNK_SIZE) + y,
+        w,
+        h
+      };
+      out.push_back(rect);
+    }
+  }
+}
+
+std::size_t TileMap::getChunkCount() const
+{
+  return std::count_if(
+    chunks.begin(),
+    chunks.end(),
+    [](const std::unique_ptr<Chunk>& chunk) { return chunk != nullptr; }
+    );
+}
+
+std::size_t TileMap::getMeshCount() const
+{
+  return std::count_if(
+    chunks.begin(),
+    chunks.end(),
+    [](const std::unique_ptr<Chunk>& chunk) {
+      return chunk != nullptr && chunk->meshValid;
+    });
+}
+
+TileMap::Chunk* TileMap::getChunk(const int cx, const int cy) const
+{
+  assert(cx >= 0 && cy >= 0 && cx < chunksX && cy < chunksY);
+  return chunks[(cy * chunksX) + cx].get();
+}
+
+void TileMap::buildMesh(Chunk& chunk, const int cx, const int cy) const
+{
+  for (auto& batch : chunk.mesh)
+  {
+    batch.vertices.clear();
+  }
+
+  for (int y = 0; y < CHUNK_SIZE; y++)
+  {
+    for (int x = 0; x < CHUNK_SIZE; x++)
+    {
+      const TileID id = chunk.tiles[(y * CHUNK_SIZE) + x];
+      if (id == 0)
+      {
+        continue;
+      }
+      const TileType& type = types[id];
+
+      // chunks only use a handful of textures, a linear search is fine
+      auto batch = std::find_if(
+        chunk.mesh.begin(),
+        chunk.mesh.end(),
+        [&](const MeshBatch& b) { return b.texture == type.texture; }
+        );
+      if (batch == chunk.mesh.end())
+      {
+        MeshBatch newBatch;
+        newBatch.texture = type.texture;
+        chunk.mesh.push_back(newBatch);
+        batch = chunk.mesh.end() - 1;
+      }
+
+      const float left = ((cx * CHUNK_SIZE) + x) * tileSize;
+      const float bottom = ((cy * CHUNK_SIZE) + y) * tileSize;
+      const float right = left + tileSize;
+      const float top = bottom + tileSize;
+      const float u0 = static_cast<float>(type.texRect.left);
+      const float v0 = static_cast<float>(type.texRect.top);
+      const float u1 = u0 + type.texRect.width;
+      const float v1 = v0 + type.texRect.height;
+      std::vector<sf::Vertex>& v = batch->vertices;
+      v.push_back(sf::Vertex(sf::Vector2f(left, top), type.color,
+                             sf::Vector2f(u0, v0)));
+      v.push_back(sf::Vertex(sf::Vector2f(right, top), type.color,
+                             sf::Vector2f(u1, v0)));
+      v.push_back(sf::Vertex(sf::Vector2f(right, bottom), type.color,
+                             sf::Vector2f(u1, v1)));
+      v.push_back(sf::Vertex(sf::Vector2f(left, bottom), type.color,
+                             sf::Vector2f(u0, v1)));
+    }
+  }
+
+  // batches whose tiles were all removed
+  chunk.mesh.erase(
+    std::remove_if(
+      chunk.mesh.begin(),
+      chunk.mesh.end(),
+      [](const MeshBatch& b) { return b.vertices.empty(); }
+      ),
+    chunk.mesh.end()
+    );
+  chunk.meshValid = true;
+}
\ No newline at end of file
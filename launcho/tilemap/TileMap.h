@@ -0,0 +1,150 @@
+#pragma once
+
+#include "math/AABB2.h"
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// identifies a kind of tile, 0 is an empty tile
+using TileID = uint16_t;
+
+/**
+ * What a kind of tile looks like and whether it collides.
+ */
+struct TileType
+{
+  // nullptr for a solid colored tile
+  const sf::Texture* texture;
+  // pixel rectangle in the texture
+  sf::IntRect texRect;
+  sf::Color color;
+  bool solid;
+};
+
+/**
+ * A grid of tiles stored in fixed size chunks. Chunks are only allocated once
+ * a tile in them is set, and each one keeps a prebuilt mesh that is rebuilt
+ * only after its tiles change, so drawing costs a few calls per visible chunk
+ * no matter how many tiles it has.
+ * Coordinates are in tiles from the lower left corner of the map, with y up
+ * like the rest of the world. Meshes are in world units relative to the same
+ * corner.
+ */
+class TileMap
+{
+public:
+  // width and height of a chunk in tiles
+  static const int CHUNK_SIZE = 32;
+
+  // vertices of a chunk that share a texture
+  struct MeshBatch
+  {
+    const sf::Texture* texture;
+    std::vector<sf::Vertex> vertices;
+  };
+
+  // a box of solid tiles, in tiles
+  struct TileRect
+  {
+    int x;
+    int y;
+    int width;
+    int height;
+  };
+
+private:
+  struct Chunk
+  {
+    TileID tiles[CHUNK_SIZE * CHUNK_SIZE];
+    std::vector<MeshBatch> mesh;
+    bool meshValid;
+    bool collisionDirty;
+    // value of the frame counter the mesh was last used on
+    uint32_t lastUsed;
+  };
+
+  int width;
+  int height;
+  float tileSize;
+  int chunksX;
+  int chunksY;
+  std::vector<std::unique_ptr<Chunk>> chunks;
+  // index 0 is the empty tile
+  std::vector<TileType> types;
+
+public:
+  /**
+   * @param _width Width of the map in tiles.
+   * @param _height Height of the map in tiles.
+   * @param _tileSize Width and height of a tile in world units.
+   */
+  TileMap(const int _width, const int _height, const float _tileSize);
+  TileMap(const TileMap&) = delete;
+  TileMap& operator=(const TileMap&) = delete;
+
+  /**
+   * Adds a kind of tile.
+   * @return The id to place it with.
+   */
+  TileID addTileType(const TileType& type);
+  const TileType& getTileType(const TileID id) const;
+
+  // 0 outside of the map
+  TileID getTile(const int x, const int y) const;
+  void setTile(const int x, const int y, const TileID id);
+  // sets every tile in a rectangle, clipped to the map
+  void fill(const int x, const int y, const int w, const int h,
+            const TileID id);
+
+  int getWidth() const;
+  int getHeight() const;
+  float getTileSize() const;
+  int getChunksX() const;
+  int getChunksY() const;
+
+  /**
+   * Finds the range of chunks that intersect an area.
+   * @param area In world units relative to the lower left of the map.
+   * @return false if the area misses the map.
+   */
+  bool getChunkRange(const AABB2& area, int& minX, int& minY, int& maxX,
+                     int& maxY) const;
+
+  /**
+   * Returns the mesh of a chunk, rebuilding it if its tiles changed.
+   * @param frame Marks the mesh as used, see releaseStaleMeshes().
+   * @return nullptr if the chunk has no tiles.
+   */
+  const std::vector<MeshBatch>* getChunkMesh(const int cx, const int cy,
+                                             const uint32_t frame);
+
+  /**
+   * Frees the meshes of chunks that haven't been used for a while, so memory
+   * follows the visible chunks rather than the size of the map.
+   * @param maxAge Frames a mesh can go unused before it is freed.
+   */
+  void releaseStaleMeshes(const uint32_t frame, const uint32_t maxAge);
+
+  /**
+   * Finds the chunks whose collision changed since the last call.
+   * @param out[out] Cleared and filled with chunk indices, cx + cy * chunksX.
+   */
+  void takeCollisionChanges(std::vector<int>& out);
+
+  /**
+   * Merges the solid tiles of a chunk into as few boxes as it can, growing
+   * each box across and then up.
+   * @param out[out] Cleared and filled with boxes in map tile coordinates.
+   */
+  void buildCollision(const int cx, const int cy,
+                      std::vector<TileRect>& out) const;
+
+  // chunks that have tiles / chunks with a mesh in memory
+  std::size_t getChunkCount() const;
+  std::size_t getMeshCount() const;
+
+private:
+  Chunk* getChunk(const int cx, const int cy) const;
+  void buildMesh(Chunk& chunk, const int cx, const int cy) const;
+};
\ No newline at end of file
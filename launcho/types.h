@@ -1,5 +1,6 @@
 #pragma once
 
+#include "utility/Delegate.h"
 #include <cstdint>
 #include <memory>
 #include <functional>
@@ -41,5 +42,5 @@ class Event;
 using StrongEventPtr = std::shared_ptr<Event>;
 using WeakEventPtr = std::weak_ptr<Event>;
 
-// event callback functions
-using EventCallback = std::function<void(StrongEventPtr evt)>;
\ No newline at end of file
+// event callback functions, the event is only valid during the call
+using EventCallback = Delegate<void(const Event& evt)>;
\ No newline at end of file
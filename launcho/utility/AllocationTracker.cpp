@@ -0,0 +1,376 @@
+#include "AllocationTracker.h"
+
+#ifdef LAUNCHO_TRACK_ALLOCATIONS
+
+#include "utility/Log.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+const std::string AllocationTracker::TAG = "AllocationTracker";
+
+static const std::size_t TAG_COUNT =
+  static_cast<std::size_t>(AllocationTag::Count);
+static const char* const TAG_NAMES[TAG_COUNT] = {
+  "Other",
+  "Spatial",
+  "Particles",
+  "Render",
+  "Physics",
+  "Logic",
+  "Events",
+  "Logging",
+  "Network"
+};
+// slots for distinct sampled call stacks, later stacks are dropped once full
+static const std::size_t SAMPLE_SLOTS = 1024;
+// sampled stacks listed in the report
+static const std::size_t REPORTED_SAMPLES = 10;
+
+// everything here is zero initialized before any constructor runs, so it is
+// safe to use from allocations made during static initialization
+
+// counts for the frame in progress, added to from any thread
+static std::atomic<uint32_t> frameCounts[TAG_COUNT];
+static std::atomic<uint64_t> frameBytes[TAG_COUNT];
+static std::atomic<uint32_t> frameFrees;
+
+// only touched by the main thread in endFrame() and report()
+static uint32_t lastCounts[TAG_COUNT];
+static uint64_t lastBytes[TAG_COUNT];
+static uint64_t totalCounts[TAG_COUNT];
+static uint64_t totalBytes[TAG_COUNT];
+static uint64_t totalFrees;
+static uint32_t startupCount;
+static uint32_t frames;
+static uint32_t zeroFrames;
+static uint32_t maxFrameCount;
+static bool started;
+
+static thread_local AllocationTag currentTag;
+static thread_local uint32_t untilSample;
+
+struct Sample
+{
+  // hash of the stack, 0 while the slot is free
+  std::atomic<uint64_t> key;
+  std::atomic<uint32_t> hits;
+  std::atomic<uint8_t> tag;
+  std::atomic<uintptr_t> stack[AllocationTracker::STACK_DEPTH];
+};
+static Sample samples[SAMPLE_SLOTS];
+
+// return addresses of the caller's caller and up, 0 past the end
+static void captureStack(uintptr_t* stack)
+{
+  std::fill(stack, stack + AllocationTracker::STACK_DEPTH, 0);
+#ifdef _WIN32
+  void* frames[AllocationTracker::STACK_DEPTH];
+  const USHORT count = CaptureStackBackTrace(
+    2,
+    static_cast<DWORD>(AllocationTracker::STACK_DEPTH),
+    frames,
+    nullptr
+    );
+  for (USHORT i = 0; i < count; i++)
+  {
+    stack[i] = reinterpret_cast<uintptr_t>(frames[i]);
+  }
+#endif
+  // the game only ships on windows, other platforms only count
+}
+
+static void addSample(const AllocationTag tag)
+{
+  uintptr_t stack[AllocationTracker::STACK_DEPTH];
+  captureStack(stack);
+
+  // FNV-1a over the addresses and tag, never 0 so 0 can mark free slots
+  uint64_t key = 14695981039346656037ull ^ static_cast<uint64_t>(tag);
+  for (uintptr_t address : stack)
+  {
+    key = (key ^ address) * 1099511628211ull;
+  }
+  key |= 1;
+
+  for (std::size_t probe = 0; probe < SAMPLE_SLOTS; probe++)
+  {
+    Sample& sample = samples[(key + probe) % SAMPLE_SLOTS];
+    uint64_t expected = 0;
+    if (sample.key.compare_exchange_strong(expected, key))
+    {
+      sample.tag.store(static_cast<uint8_t>(tag));
+      for (std::size_t i = 0; i < AllocationTracker::STACK_DEPTH; i++)
+      {
+        sample.stack[i].store(stack[i]);
+      }
+    }
+    else if (expected != key)
+    {
+      continue;
+    }
+    sample.hits.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+}
+
+void AllocationTracker::record(const std::size_t size)
+{
+  const std::size_t tag = static_cast<std::size_t>(currentTag);
+  frameCounts[tag].fetch_add(1, std::memory_order_relaxed);
+  frameBytes[tag].fetch_add(size, std::memory_order_relaxed);
+
+  if (untilSample == 0)
+  {
+    untilSample = SAMPLE_RATE;
+    addSample(currentTag);
+  }
+  untilSample--;
+}
+
+void AllocationTracker::recordFree()
+{
+  frameFrees.fetch_add(1, std::memory_order_relaxed);
+}
+
+AllocationTag AllocationTracker::getCurrentTag()
+{
+  return currentTag;
+}
+
+void AllocationTracker::setCurrentTag(const AllocationTag tag)
+{
+  currentTag = tag;
+}
+
+void AllocationTracker::endFrame()
+{
+  uint32_t count = 0;
+  for (std::size_t i = 0; i < TAG_COUNT; i++)
+  {
+    lastCounts[i] = frameCounts[i].exchange(0, std::memory_order_relaxed);
+    lastBytes[i] = frameBytes[i].exchange(0, std::memory_order_relaxed);
+    count += lastCounts[i];
+  }
+  const uint32_t frees = frameFrees.exchange(0, std::memory_order_relaxed);
+
+  // everything before the first frame is loading
+  if (!started)
+  {
+    started = true;
+    startupCount = count;
+    std::fill(lastCounts, lastCounts + TAG_COUNT, 0);
+    std::fill(lastBytes, lastBytes + TAG_COUNT, 0);
+    return;
+  }
+
+  for (std::size_t i = 0; i < TAG_COUNT; i++)
+  {
+    totalCounts[i] += lastCounts[i];
+    totalBytes[i] += lastBytes[i];
+  }
+  totalFrees += frees;
+  frames++;
+  if (count == 0)
+  {
+    zeroFrames++;
+  }
+  maxFrameCount = std::max(maxFrameCount, count);
+}
+
+uint32_t AllocationTracker::getFrameAllocations()
+{
+  uint32_t count = 0;
+  for (std::size_t i = 0; i < TAG_COUNT; i++)
+  {
+    count += lastCounts[i];
+  }
+  return count;
+}
+
+uint64_t AllocationTracker::getFrameBytes()
+{
+  uint64_t bytes = 0;
+  for (std::size_t i = 0; i < TAG_COUNT; i++)
+  {
+    bytes += lastBytes[i];
+  }
+  return bytes;
+}
+
+uint32_t AllocationTracker::getFrameAllocations(const AllocationTag tag)
+{
+  return lastCounts[static_cast<std::size_t>(tag)];
+}
+
+void AllocationTracker::report()
+{
+  // logging allocates, nothing it does here should show up in the counts
+  AllocationScope scope(AllocationTag::Logging);
+
+  Log::info(
+    TAG,
+    "%u allocations during startup, %u frames tracked, %u with none",
+    startupCount,
+    frames,
+    zeroFrames
+    );
+  if (frames == 0)
+  {
+    return;
+  }
+
+  uint64_t count = 0;
+  for (std::size_t i = 0; i < TAG_COUNT; i++)
+  {
+    count += totalCounts[i];
+  }
+  Log::info(
+    TAG,
+    "%.1f allocations and %.1f frees per frame, at most %u",
+    static_cast<double>(count) / frames,
+    static_cast<double>(totalFrees) / frames,
+    maxFrameCount
+    );
+  for (std::size_t i = 0; i < TAG_COUNT; i++)
+  {
+    if (totalCounts[i] == 0)
+    {
+      continue;
+    }
+    Log::info(
+      TAG,
+      "  %-9s %8.1f per frame %10.1f bytes per frame",
+      TAG_NAMES[i],
+      static_cast<double>(totalCounts[i]) / frames,
+      static_cast<double>(totalBytes[i]) / frames
+      );
+  }
+
+  std::vector<const Sample*> sorted;
+  for (auto& sample : samples)
+  {
+    if (sample.key.load() != 0)
+    {
+      sorted.push_back(&sample);
+    }
+  }
+  const std::size_t shown = std::min(REPORTED_SAMPLES, sorted.size());
+  std::partial_sort(
+    sorted.begin(),
+    sorted.begin() + shown,
+    sorted.end(),
+    [](const Sample* a, const Sample* b) {
+      return a->hits.load() > b->hits.load();
+    });
+
+#ifdef _WIN32
+  Log::info(
+    TAG,
+    "Most sampled call stacks, image base 0x%llx",
+    static_cast<unsigned long long>(
+      reinterpret_cast<uintptr_t>(GetModuleHandle(nullptr))
+      )
+    );
+#else
+  Log::info(TAG, "Most sampled call stacks");
+#endif
+  for (std::size_t i = 0; i < shown; i++)
+  {
+    // each sample stands for SAMPLE_RATE allocations
+    char line[160];
+    int length = snprintf(
+      line,
+      sizeof(line),
+      "  ~%u %s:",
+      sorted[i]->hits.load() * SAMPLE_RATE,
+      TAG_NAMES[sorted[i]->tag.load()]
+      );
+    for (std::size_t j = 0; j < STACK_DEPTH && length > 0 &&
+         length < static_cast<int>(sizeof(line)); j++)
+    {
+      const uintptr_t address = sorted[i]->stack[j].load();
+      if (address == 0)
+      {
+        break;
+      }
+      length += snprintf(
+        line + length,
+        sizeof(line) - length,
+        " 0x%llx",
+        static_cast<unsigned long long>(address)
+        );
+    }
+    Log::info(TAG, "%s", line);
+  }
+}
+
+// every allocation in the program goes through these
+
+void* operator new(std::size_t size)
+{
+  AllocationTracker::record(size);
+  void* ptr = std::malloc(size > 0 ? size : 1);
+  if (ptr == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  AllocationTracker::record(size);
+  return std::malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+  return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  if (ptr != nullptr)
+  {
+    AllocationTracker::recordFree();
+    std::free(ptr);
+  }
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  operator delete(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+  operator delete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+  operator delete(ptr);
+}
+
+#endif
\ No newline at end of file
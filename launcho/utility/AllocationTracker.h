@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// what a heap allocation is charged to, see AllocationScope
+enum class AllocationTag : uint8_t
+{
+  Other,
+  Spatial,
+  Particles,
+  Render,
+  Physics,
+  Logic,
+  Events,
+  Logging,
+  Network,
+  Count
+};
+
+#ifdef LAUNCHO_TRACK_ALLOCATIONS
+
+/**
+ * Counts heap allocations to find the ones made every frame. When the game is
+ * built with LAUNCHO_TRACK_ALLOCATIONS defined, the global operator new and
+ * delete are replaced to count every allocation and its size against the
+ * AllocationScope active on the calling thread, and to record the call
+ * stack of every SAMPLE_RATEth allocation. Without it nothing is replaced
+ * and AllocationScope compiles away.
+ * Counting never allocates or locks, so it works on any thread. Scopes only
+ * apply to the thread that opens them: the main thread and the network
+ * threads set them, and the workers' allocations count as Other.
+ */
+class AllocationTracker final
+{
+public:
+  // one in this many allocations has its call stack recorded
+  static const uint32_t SAMPLE_RATE = 64;
+  // return addresses recorded per sample
+  static const std::size_t STACK_DEPTH = 6;
+
+private:
+  static const std::string TAG;
+
+public:
+  AllocationTracker() = delete;
+
+  /**
+   * Finishes a frame, making its counts the ones reported. Call from the
+   * main thread once per frame.
+   */
+  static void endFrame();
+
+  // allocations made in the last complete frame
+  static uint32_t getFrameAllocations();
+  static uint64_t getFrameBytes();
+  static uint32_t getFrameAllocations(const AllocationTag tag);
+
+  /**
+   * Logs the averages of every tag and the most often sampled call stacks.
+   */
+  static void report();
+
+  // called by operator new
+  static void record(const std::size_t size);
+  // called by operator delete
+  static void recordFree();
+
+  static AllocationTag getCurrentTag();
+  static void setCurrentTag(const AllocationTag tag);
+};
+
+/**
+ * Charges allocations on the calling thread to a tag while it is alive.
+ */
+class AllocationScope final
+{
+private:
+  AllocationTag previous;
+
+public:
+  explicit AllocationScope(const AllocationTag tag);
+  ~AllocationScope();
+  AllocationScope(const AllocationScope&) = delete;
+  AllocationScope& operator=(const AllocationScope&) = delete;
+};
+
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+
+inline AllocationScope::AllocationScope(const AllocationTag tag)
+  : previous(AllocationTracker::getCurrentTag())
+{
+  AllocationTracker::setCurrentTag(tag);
+}
+
+inline AllocationScope::~AllocationScope()
+{
+  AllocationTracker::setCurrentTag(previous);
+}
+
+#else
+
+class AllocationScope final
+{
+public:
+  explicit AllocationScope(const AllocationTag) {}
+};
+
+#endif
\ No newline at end of file
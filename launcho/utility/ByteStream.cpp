@@ -0,0 +1,133 @@
+#include "ByteStream.h"
+#include <cassert>
+#include <cstring>
+
+ByteWriter::ByteWriter(std::vector<uint8_t>& _out)
+: out(_out)
+{
+}
+
+void ByteWriter::writeU8(const uint8_t value)
+{
+  out.push_back(value);
+}
+
+void ByteWriter::writeU32(const uint32_t value)
+{
+  out.push_back(static_cast<uint8_t>(value));
+  out.push_back(static_cast<uint8_t>(value >> 8));
+  out.push_back(static_cast<uint8_t>(value >> 16));
+  out.push_back(static_cast<uint8_t>(value >> 24));
+}
+
+void ByteWriter::writeVarint(uint32_t value)
+{
+  // low bits first, the high bit is set on all but the last byte
+  while (value >= 0x80)
+  {
+    out.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+void ByteWriter::writeFloat(const float value)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  writeU32(bits);
+}
+
+void ByteWriter::writeBytes(const uint8_t* data, const std::size_t size)
+{
+  out.insert(out.end(), data, data + size);
+}
+
+std::size_t ByteWriter::getSize() const
+{
+  return out.size();
+}
+
+void ByteWriter::patchU32(const std::size_t offset, const uint32_t value)
+{
+  assert(offset + 4 <= out.size());
+  out[offset] = static_cast<uint8_t>(value);
+  out[offset + 1] = static_cast<uint8_t>(value >> 8);
+  out[offset + 2] = static_cast<uint8_t>(value >> 16);
+  out[offset + 3] = static_cast<uint8_t>(value >> 24);
+}
+
+ByteReader::ByteReader(const uint8_t* _data, const std::size_t _size)
+: data(_data),
+  size(_size),
+  pos(0)
+{
+}
+
+bool ByteReader::readU8(uint8_t& value)
+{
+  if (pos >= size)
+  {
+    return false;
+  }
+  value = data[pos++];
+  return true;
+}
+
+bool ByteReader::readU32(uint32_t& value)
+{
+  if (size - pos < 4)
+  {
+    return false;
+  }
+  value = data[pos] | (data[pos + 1] << 8) | (data[pos + 2] << 16) |
+          (static_cast<uint32_t>(data[pos + 3]) << 24);
+  pos += 4;
+  return true;
+}
+
+bool ByteReader::readVarint(uint32_t& value)
+{
+  value = 0;
+  for (unsigned shift = 0; shift < 32; shift += 7)
+  {
+    uint8_t byte;
+    if (!readU8(byte))
+    {
+      return false;
+    }
+    value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ByteReader::readFloat(float& value)
+{
+  uint32_t bits;
+  if (!readU32(bits))
+  {
+    return false;
+  }
+  std::memcpy(&value, &bits, sizeof(value));
+  return true;
+}
+
+bool ByteReader::readBytes(const uint8_t*& bytes, const std::size_t count)
+{
+  if (size - pos < count)
+  {
+    return false;
+  }
+  bytes = data + pos;
+  pos += count;
+  return true;
+}
+
+std::size_t ByteReader::getRemaining() const
+{
+  return size - pos;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Appends values to a byte buffer in a fixed little endian layout, for files
+ * and saved state that have to read back the same on any machine.
+ * Varints take 7 bits per byte, so small values take a single byte.
+ */
+class ByteWriter
+{
+private:
+  std::vector<uint8_t>& out;
+
+public:
+  explicit ByteWriter(std::vector<uint8_t>& _out);
+
+  void writeU8(const uint8_t value);
+  void writeU32(const uint32_t value);
+  void writeVarint(uint32_t value);
+  void writeFloat(const float value);
+  void writeBytes(const uint8_t* data, const std::size_t size);
+
+  // bytes in the buffer so far
+  std::size_t getSize() const;
+  // overwrites a value written earlier, for sizes that are only known later
+  void patchU32(const std::size_t offset, const uint32_t value);
+};
+
+/**
+ * Reads back what a ByteWriter wrote. Every read fails rather than going past
+ * the end, so corrupt data is caught instead of read.
+ */
+class ByteReader
+{
+private:
+  const uint8_t* data;
+  std::size_t size;
+  std::size_t pos;
+
+public:
+  ByteReader(const uint8_t* _data, const std::size_t _size);
+
+  bool readU8(uint8_t& value);
+  bool readU32(uint32_t& value);
+  bool readVarint(uint32_t& value);
+  bool readFloat(float& value);
+  // points at the bytes instead of copying them
+  bool readBytes(const uint8_t*& bytes, const std::size_t count);
+
+  std::size_t getRemaining() const;
+};
\ No newline at end of file
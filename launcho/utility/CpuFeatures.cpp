@@ -0,0 +1,75 @@
+#include "utility/CpuFeatures.h"
+#include <cstdint>
+
+#if LAUNCHO_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if LAUNCHO_X86
+static void cpuid(int leaf, int sub, uint32_t regs[4])
+{
+#if defined(_MSC_VER)
+  int out[4];
+  __cpuidex(out, leaf, sub);
+  for (int i = 0; i < 4; i++)
+  {
+    regs[i] = static_cast<uint32_t>(out[i]);
+  }
+#else
+  __cpuid_count(leaf, sub, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// reads the OS enabled register state, needed to know if AVX is usable
+static uint64_t xgetbv()
+{
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  uint32_t lo, hi;
+  __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+  return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+}
+#endif
+
+const CpuFeatures& CpuFeatures::get()
+{
+  static const CpuFeatures features;
+  return features;
+}
+
+CpuFeatures::CpuFeatures()
+: sse2(false),
+  sse41(false),
+  avx(false),
+  avx2(false)
+{
+#if LAUNCHO_X86
+  uint32_t regs[4];
+  cpuid(0, 0, regs);
+  const uint32_t maxLeaf = regs[0];
+  if (maxLeaf < 1)
+  {
+    return;
+  }
+
+  cpuid(1, 0, regs);
+  sse2 = (regs[3] & (1u << 26)) != 0;
+  sse41 = (regs[2] & (1u << 19)) != 0;
+  const bool osxsave = (regs[2] & (1u << 27)) != 0;
+  const bool cpuAvx = (regs[2] & (1u << 28)) != 0;
+  // the OS must save the ymm registers on context switch
+  avx = cpuAvx && osxsave && ((xgetbv() & 0x6) == 0x6);
+
+  if (avx && maxLeaf >= 7)
+  {
+    cpuid(7, 0, regs);
+    avx2 = (regs[1] & (1u << 5)) != 0;
+  }
+#endif
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// true when compiling for a processor that has the SSE/AVX instruction sets
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || \
+    defined(__x86_64__)
+#define LAUNCHO_X86 1
+#else
+#define LAUNCHO_X86 0
+#endif
+
+// Allows a function to use AVX2 instructions without enabling them for the
+// whole project. MSVC always allows intrinsics, gcc/clang need to be told.
+// FMA is left off so the compiler can't fuse a multiply and add, and the
+// AVX2 paths give the same bits as the scalar ones.
+#if defined(__GNUC__)
+#define LAUNCHO_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define LAUNCHO_TARGET_AVX2
+#endif
+
+/**
+ * Instruction sets supported by the processor the game is running on,
+ * detected once at startup with cpuid.
+ */
+class CpuFeatures final
+{
+public:
+  bool sse2;
+  bool sse41;
+  bool avx;
+  bool avx2;
+
+  /**
+   * Returns the features of the current processor.
+   */
+  static const CpuFeatures& get();
+
+private:
+  CpuFeatures();
+};
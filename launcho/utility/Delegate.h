@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template<typename Signature>
+class Delegate;
+
+/**
+ * A callable that is stored inline and never allocates, for callbacks that
+ * are called often. It holds either a member function bound to an object,
+ * or a lambda or function object of up to STORAGE_SIZE bytes that can be
+ * copied byte for byte, which covers lambdas capturing a few pointers.
+ * Anything bigger fails to compile rather than falling back to the heap.
+ * Calling one is a single indirect call.
+ */
+template<typename R, typename... Args>
+class Delegate<R(Args...)> final
+{
+public:
+  static const std::size_t STORAGE_SIZE = 2 * sizeof(void*);
+
+private:
+  using Invoker = R (*)(const void* storage, Args... args);
+
+  typename std::aligned_storage<STORAGE_SIZE, alignof(void*)>::type storage;
+  // nullptr when empty
+  Invoker invoker;
+
+public:
+  Delegate();
+
+  /**
+   * Stores a lambda or function object.
+   */
+  template<typename Fn,
+           typename = typename std::enable_if<
+             !std::is_same<typename std::decay<Fn>::type, Delegate>::value
+             >::type>
+  Delegate(Fn fn);
+
+  /**
+   * Binds a member function to an object, which must outlive the delegate.
+   */
+  template<typename T, R (T::*Method)(Args...)>
+  static Delegate bind(T* object);
+
+  R operator()(Args... args) const;
+
+  explicit operator bool() const;
+
+private:
+  template<typename Fn>
+  static R invokeFunction(const void* storage, Args... args);
+  template<typename T, R (T::*Method)(Args...)>
+  static R invokeMethod(const void* storage, Args... args);
+};
+
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+
+template<typename R, typename... Args>
+Delegate<R(Args...)>::Delegate()
+  : storage(), invoker(nullptr)
+{}
+
+template<typename R, typename... Args>
+template<typename Fn, typename>
+Delegate<R(Args...)>::Delegate(Fn fn)
+  : storage(), invoker(&invokeFunction<Fn>)
+{
+  static_assert(sizeof(Fn) <= STORAGE_SIZE,
+                "Callable is too big for a Delegate, capture less");
+  static_assert(alignof(Fn) <= alignof(void*),
+                "Callable is over aligned for a Delegate");
+  static_assert(std::is_trivially_copyable<Fn>::value &&
+                std::is_trivially_destructible<Fn>::value,
+                "Delegates only hold callables that can be copied as bytes");
+  new (&storage) Fn(fn);
+}
+
+template<typename R, typename... Args>
+template<typename T, R (T::*Method)(Args...)>
+Delegate<R(Args...)> Delegate<R(Args...)>::bind(T* object)
+{
+  Delegate delegate;
+  new (&delegate.storage) T*(object);
+  delegate.invoker = &invokeMethod<T, Method>;
+  return delegate;
+}
+
+template<typename R, typename... Args>
+R Delegate<R(Args...)>::operator()(Args... args) const
+{
+  assert(invoker != nullptr);
+  return invoker(&storage, std::forward<Args>(args)...);
+}
+
+template<typename R, typename... Args>
+Delegate<R(Args...)>::operator bool() const
+{
+  return invoker != nullptr;
+}
+
+template<typename R, typename... Args>
+template<typename Fn>
+R Delegate<R(Args...)>::invokeFunction(const void* storage, Args... args)
+{
+  // stored callables are copied as bytes, so calling a non const one on
+  // its own copy is safe
+  Fn& fn = *static_cast<Fn*>(const_cast<void*>(storage));
+  return fn(std::forward<Args>(args)...);
+}
+
+template<typename R, typename... Args>
+template<typename T, R (T::*Method)(Args...)>
+R Delegate<R(Args...)>::invokeMethod(const void* storage, Args... args)
+{
+  T* object = *static_cast<T* const*>(storage);
+  return (object->*Method)(std::forward<Args>(args)...);
+}
\ No newline at end of file
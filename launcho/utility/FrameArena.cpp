@@ -0,0 +1,170 @@
+#include "FrameArena.h"
+#include "utility/Log.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+const std::string FrameArena::TAG = "FrameArena";
+
+// the arena local() returns, set by bindToThread()
+static thread_local FrameArena* threadArena = nullptr;
+// for threads that never bound one
+static thread_local std::unique_ptr<FrameArena> unboundArena;
+
+FrameArena::FrameArena(const std::string& _name,
+                       const std::size_t initialSize)
+: name(_name),
+  blocks(),
+  current(0),
+  used(0),
+  blockBase(0),
+  highWater(0),
+  frames(0)
+{
+  addBlock(initialSize);
+}
+
+void* FrameArena::allocate(const std::size_t size, const std::size_t align)
+{
+  assert(align > 0 && (align & (align - 1)) == 0);
+  while (true)
+  {
+    Block& block = blocks[current];
+    const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+    const uintptr_t start = (base + used + align - 1) & ~(align - 1);
+    const std::size_t end = static_cast<std::size_t>(start - base) + size;
+    if (end <= block.size)
+    {
+      used = end;
+      return reinterpret_cast<void*>(start);
+    }
+
+    highWater = std::max(highWater, getUsed());
+    blockBase += block.size;
+    // blocks left over from a rewind are reused before adding another
+    if (current + 1 == blocks.size())
+    {
+      addBlock(size + align);
+    }
+    current++;
+    used = 0;
+  }
+}
+
+void FrameArena::reset()
+{
+  highWater = std::max(highWater, getUsed());
+  frames++;
+
+  if (blocks.size() > 1)
+  {
+    // one block that fits the whole frame, so the next one doesn't spill
+    std::size_t total = 0;
+    for (auto& block : blocks)
+    {
+      total += block.size;
+    }
+    blocks.clear();
+    addBlock(total);
+  }
+#ifdef _DEBUG
+  else
+  {
+    std::memset(blocks[0].data.get(), 0xcd, used);
+  }
+#endif
+
+  current = 0;
+  used = 0;
+  blockBase = 0;
+}
+
+FrameArena::Marker FrameArena::mark() const
+{
+  Marker marker = { current, used };
+  return marker;
+}
+
+void FrameArena::rewind(const Marker& marker)
+{
+  assert(marker.block < current ||
+         (marker.block == current && marker.used <= used));
+  highWater = std::max(highWater, getUsed());
+  for (std::size_t i = marker.block; i < current; i++)
+  {
+    blockBase -= blocks[i].size;
+  }
+  current = marker.block;
+  used = marker.used;
+}
+
+std::size_t FrameArena::getUsed() const
+{
+  return blockBase + used;
+}
+
+std::size_t FrameArena::getHighWater() const
+{
+  return std::max(highWater, getUsed());
+}
+
+std::size_t FrameArena::getCapacity() const
+{
+  std::size_t total = 0;
+  for (auto& block : blocks)
+  {
+    total += block.size;
+  }
+  return total;
+}
+
+void FrameArena::report() const
+{
+  Log::info(
+    TAG,
+    "%s: high water %.1fKB over %u frames, capacity %.1fKB",
+    name.c_str(),
+    getHighWater() / 1024.0f,
+    frames,
+    getCapacity() / 1024.0f
+    );
+}
+
+void FrameArena::bindToThread()
+{
+  threadArena = this;
+}
+
+FrameArena& FrameArena::local()
+{
+  if (threadArena == nullptr)
+  {
+    unboundArena.reset(new FrameArena("unbound"));
+    threadArena = unboundArena.get();
+  }
+  return *threadArena;
+}
+
+void FrameArena::addBlock(const std::size_t minSize)
+{
+  // grows geometrically so a big frame only adds a few blocks
+  const std::size_t size = std::max(
+    minSize,
+    blocks.empty() ? minSize : blocks.back().size * 2
+    );
+  Block block;
+  block.data.reset(new uint8_t[size]);
+  block.size = size;
+  blocks.push_back(std::move(block));
+}
+
+ArenaScope::ArenaScope(FrameArena& _arena)
+: arena(_arena),
+  marker(_arena.mark())
+{
+}
+
+ArenaScope::~ArenaScope()
+{
+  arena.rewind(marker);
+}
\ No newline at end of file
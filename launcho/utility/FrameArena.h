@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Bump allocator for scratch memory that only lives for a frame. Allocating
+ * moves a pointer forward and nothing is freed individually, reset() drops
+ * everything at once at the top of the next frame.
+ * Memory comes from blocks that are kept between frames. When a frame
+ * needs more than the current block another one is added, and the next
+ * reset() replaces them with a single block big enough for the whole frame,
+ * so after the first few frames allocating never touches the heap.
+ * Each thread has its own arena, see local(), so nothing is locked.
+ */
+class FrameArena final
+{
+public:
+  // a position to rewind to, see ArenaScope
+  struct Marker
+  {
+    std::size_t block;
+    std::size_t used;
+  };
+
+private:
+  static const std::string TAG;
+
+  struct Block
+  {
+    std::unique_ptr<uint8_t[]> data;
+    std::size_t size;
+  };
+
+  std::string name;
+  std::vector<Block> blocks;
+  // the block being allocated from, and how much of it is in use
+  std::size_t current;
+  std::size_t used;
+  // size of the blocks before the current one
+  std::size_t blockBase;
+  std::size_t highWater;
+  uint32_t frames;
+
+public:
+  /**
+   * @param _name Shown in the report.
+   * @param initialSize Size of the first block.
+   */
+  explicit FrameArena(const std::string& _name,
+                      const std::size_t initialSize = 64 * 1024);
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  /**
+   * Returns memory that stays valid until the next reset().
+   * @param align Must be a power of two.
+   */
+  void* allocate(const std::size_t size,
+                 const std::size_t align = alignof(std::max_align_t));
+
+  /**
+   * Frees everything allocated since the last reset. Debug builds fill the
+   * memory so anything still using it shows up quickly.
+   */
+  void reset();
+
+  Marker mark() const;
+  // frees everything allocated since the marker was taken
+  void rewind(const Marker& marker);
+
+  // bytes in use since the last reset, counting the unused ends of blocks
+  // that were filled
+  std::size_t getUsed() const;
+  // most bytes used by a single frame
+  std::size_t getHighWater() const;
+  std::size_t getCapacity() const;
+
+  // logs the high water mark
+  void report() const;
+
+  /**
+   * Makes this the arena returned by local() on the calling thread.
+   */
+  void bindToThread();
+
+  /**
+   * The arena of the calling thread. Threads that never bound one get their
+   * own that is only ever freed through ArenaScope.
+   */
+  static FrameArena& local();
+
+private:
+  void addBlock(const std::size_t minSize);
+};
+
+/**
+ * Frees what was allocated from an arena while it was alive, for scratch
+ * memory in code that may run outside of the frame loop.
+ */
+class ArenaScope final
+{
+private:
+  FrameArena& arena;
+  FrameArena::Marker marker;
+
+public:
+  explicit ArenaScope(FrameArena& _arena);
+  ~ArenaScope();
+  ArenaScope(const ArenaScope&) = delete;
+  ArenaScope& operator=(const ArenaScope&) = delete;
+};
+
+/**
+ * Lets standard containers allocate from a FrameArena. Deallocating does
+ * nothing, a growing vector leaves its old buffers in the arena until it is
+ * reset, so reserve up front where the size is known.
+ * The allocator moves with the container, so a container kept between frames
+ * is refilled by assigning it a new one after the reset rather than clearing
+ * it, which would keep writing to the memory that was dropped.
+ */
+template<typename T>
+class ArenaAllocator
+{
+private:
+  template<typename U> friend class ArenaAllocator;
+
+  FrameArena* arena;
+
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template<typename U>
+  struct rebind
+  {
+    using other = ArenaAllocator<U>;
+  };
+
+  // the calling thread's arena
+  ArenaAllocator();
+  explicit ArenaAllocator(FrameArena& _arena);
+  template<typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other);
+
+  T* allocate(const std::size_t count);
+  void deallocate(T*, const std::size_t);
+
+  template<typename U>
+  bool operator==(const ArenaAllocator<U>& rhs) const;
+  template<typename U>
+  bool operator!=(const ArenaAllocator<U>& rhs) const;
+};
+
+// scratch vector allocated from the calling thread's arena
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+
+template<typename T>
+ArenaAllocator<T>::ArenaAllocator()
+  : arena(&FrameArena::local())
+{}
+
+template<typename T>
+ArenaAllocator<T>::ArenaAllocator(FrameArena& _arena)
+  : arena(&_arena)
+{}
+
+template<typename T>
+template<typename U>
+ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<U>& other)
+  : arena(other.arena)
+{}
+
+template<typename T>
+T* ArenaAllocator<T>::allocate(const std::size_t count)
+{
+  return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+}
+
+template<typename T>
+void ArenaAllocator<T>::deallocate(T*, const std::size_t)
+{
+}
+
+template<typename T>
+template<typename U>
+bool ArenaAllocator<T>::operator==(const ArenaAllocator<U>& rhs) const
+{
+  return arena == rhs.arena;
+}
+
+template<typename T>
+template<typename U>
+bool ArenaAllocator<T>::operator!=(const ArenaAllocator<U>& rhs) const
+{
+  return arena != rhs.arena;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+
+FrameStats::FrameStats()
+: history(),
+  historyNext(0),
+  historyCount(0),
+  sorted(),
+  sortedValid(false),
+  current(),
+  last()
+{
+}
+
+void FrameStats::addSectionTime(const FrameSection section, const float ms)
+{
+  assert(section != FrameSection::Count);
+  current[static_cast<std::size_t>(section)] += ms;
+}
+
+void FrameStats::endFrame(const float frameMs)
+{
+  history[historyNext] = frameMs;
+  historyNext = (historyNext + 1) % HISTORY_SIZE;
+  if (historyCount < HISTORY_SIZE)
+  {
+    historyCount++;
+  }
+  sortedValid = false;
+
+  last = current;
+  current.fill(0.0f);
+}
+
+float FrameStats::getSectionTime(const FrameSection section) const
+{
+  assert(section != FrameSection::Count);
+  return last[static_cast<std::size_t>(section)];
+}
+
+float FrameStats::getPercentile(const float p) const
+{
+  if (historyCount == 0)
+  {
+    return 0.0f;
+  }
+
+  // one sort serves every percentile asked for in the same frame
+  if (!sortedValid)
+  {
+    std::copy(history.begin(), history.begin() + historyCount, sorted.begin());
+    std::sort(sorted.begin(), sorted.begin() + historyCount);
+    sortedValid = true;
+  }
+
+  // nearest rank
+  const float rank = std::ceil((p / 100.0f) * historyCount);
+  const std::size_t index = static_cast<std::size_t>(
+    std::max(1.0f, std::min(rank, static_cast<float>(historyCount)))
+    );
+  return sorted[index - 1];
+}
+
+float FrameStats::getAverage() const
+{
+  if (historyCount == 0)
+  {
+    return 0.0f;
+  }
+  return std::accumulate(history.begin(), history.begin() + historyCount,
+                         0.0f) / historyCount;
+}
+
+std::size_t FrameStats::getFrameCount() const
+{
+  return historyCount;
+}
\ No newline at end of file
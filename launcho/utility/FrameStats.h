@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+// parts of the frame that are timed separately
+enum class FrameSection
+{
+  Spatial,
+  Particles,
+  Render,
+  Physics,
+  Logic,
+  Events,
+  Count
+};
+
+/**
+ * Collects frame timings for the performance overlay: a history of recent
+ * frame times for percentiles, and how long each system took in the last
+ * complete frame.
+ */
+class FrameStats final
+{
+public:
+  // number of frames kept for percentiles
+  static const std::size_t HISTORY_SIZE = 240;
+
+private:
+  static const std::size_t SECTION_COUNT =
+    static_cast<std::size_t>(FrameSection::Count);
+
+  std::array<float, HISTORY_SIZE> history;
+  std::size_t historyNext;
+  std::size_t historyCount;
+  // the history in order, rebuilt the first time a percentile is asked for
+  // after a frame ends
+  mutable std::array<float, HISTORY_SIZE> sorted;
+  mutable bool sortedValid;
+
+  std::array<float, SECTION_COUNT> current;
+  std::array<float, SECTION_COUNT> last;
+
+public:
+  FrameStats();
+
+  /**
+   * Adds time spent in a section of the frame in progress. Sections that run
+   * several times a frame add up.
+   */
+  void addSectionTime(const FrameSection section, const float ms);
+
+  /**
+   * Finishes a frame, making its section times the ones reported.
+   * @param frameMs Total time the frame took.
+   */
+  void endFrame(const float frameMs);
+
+  // section time in the last complete frame, in ms
+  float getSectionTime(const FrameSection section) const;
+
+  /**
+   * Returns the frame time that p percent of the recent frames were at or
+   * under, e.g. 99 for the 99th percentile.
+   */
+  float getPercentile(const float p) const;
+
+  // average frame time over the history, in ms
+  float getAverage() const;
+
+  std::size_t getFrameCount() const;
+};
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "utility/Log.h"
+#include "utility/AllocationTracker.h"
 #include <cassert>
 #include <iostream>
 #include <sstream>
@@ -104,6 +105,7 @@ void Log::vprintf(const LogLevel level, const std::string& tag, const char* fmt,
     return;
   }
 
+  AllocationScope allocations(AllocationTag::Logging);
   char buffer[BUFFER_SIZE];
   if (vsnprintf(buffer, BUFFER_SIZE, fmt, args) > 0)
   {
@@ -117,6 +119,7 @@ void Log::vprintf(const LogLevel level, const std::string& tag, const char* fmt,
 
 void Log::print(const std::string& tag, const std::string& msg)
 {
+  AllocationScope allocations(AllocationTag::Logging);
   auto elapsed =
     std::chrono::duration_cast<std::chrono::milliseconds>(
       std::chrono::steady_clock::now() - startTime
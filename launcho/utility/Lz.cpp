@@ -0,0 +1,184 @@
+#include "Lz.h"
+#include <algorithm>
+#include <cstring>
+
+static const int HASH_BITS = 14;
+static const std::size_t MIN_MATCH = 4;
+static const std::size_t MAX_OFFSET = 65535;
+// the end of the block is always stored as literals, which also keeps the
+// 4 byte reads in bounds
+static const std::size_t END_LITERALS = 8;
+
+static uint32_t read32(const uint8_t* p)
+{
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static uint32_t hash(const uint32_t sequence)
+{
+  return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// lengths past what fits in the token are stored as 255s and a remainder
+static void writeLength(std::vector<uint8_t>& out, std::size_t length)
+{
+  while (length >= 255)
+  {
+    out.push_back(255);
+    length -= 255;
+  }
+  out.push_back(static_cast<uint8_t>(length));
+}
+
+static bool readLength(const uint8_t* src, const std::size_t size,
+                       std::size_t& pos, std::size_t& length)
+{
+  uint8_t byte;
+  do
+  {
+    if (pos >= size)
+    {
+      return false;
+    }
+    byte = src[pos++];
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+static void writeSequence(std::vector<uint8_t>& out, const uint8_t* literals,
+                          const std::size_t literalCount,
+                          const std::size_t offset,
+                          const std::size_t matchLength)
+{
+  const std::size_t matchCode = matchLength - MIN_MATCH;
+  out.push_back(static_cast<uint8_t>(
+    (std::min<std::size_t>(literalCount, 15) << 4) |
+    std::min<std::size_t>(matchCode, 15)
+    ));
+  if (literalCount >= 15)
+  {
+    writeLength(out, literalCount - 15);
+  }
+  out.insert(out.end(), literals, literals + literalCount);
+  out.push_back(static_cast<uint8_t>(offset & 0xff));
+  out.push_back(static_cast<uint8_t>(offset >> 8));
+  if (matchCode >= 15)
+  {
+    writeLength(out, matchCode - 15);
+  }
+}
+
+std::size_t lzCompress(const uint8_t* src, const std::size_t size,
+                       std::vector<uint8_t>& out)
+{
+  out.clear();
+  out.reserve(size + (size / 255) + 16);
+
+  // positions + 1 of the last place each hashed sequence was seen
+  static thread_local uint32_t table[1 << HASH_BITS];
+  std::memset(table, 0, sizeof(table));
+
+  std::size_t anchor = 0;
+  std::size_t pos = 0;
+  const std::size_t limit = size > END_LITERALS ? size - END_LITERALS : 0;
+  // data that won't compress is skipped over faster and faster
+  unsigned misses = 0;
+
+  while (pos < limit)
+  {
+    const uint32_t sequence = read32(src + pos);
+    uint32_t& entry = table[hash(sequence)];
+    const std::size_t candidate = entry;
+    entry = static_cast<uint32_t>(pos + 1);
+
+    if (candidate == 0 || pos - (candidate - 1) > MAX_OFFSET ||
+        read32(src + candidate - 1) != sequence)
+    {
+      pos += 1 + (misses++ >> 6);
+      continue;
+    }
+    misses = 0;
+
+    const std::size_t match = candidate - 1;
+    std::size_t length = MIN_MATCH;
+    while (pos + length < limit && src[match + length] == src[pos + length])
+    {
+      length++;
+    }
+
+    writeSequence(out, src + anchor, pos - anchor, pos - match, length);
+    pos += length;
+    anchor = pos;
+  }
+
+  // the rest as literals
+  const std::size_t literalCount = size - anchor;
+  out.push_back(static_cast<uint8_t>(
+    std::min<std::size_t>(literalCount, 15) << 4
+    ));
+  if (literalCount >= 15)
+  {
+    writeLength(out, literalCount - 15);
+  }
+  out.insert(out.end(), src + anchor, src + size);
+  return out.size();
+}
+
+bool lzDecompress(const uint8_t* src, const std::size_t size,
+                  std::vector<uint8_t>& out)
+{
+  out.clear();
+  std::size_t pos = 0;
+
+  while (pos < size)
+  {
+    const uint8_t token = src[pos++];
+
+    std::size_t literalCount = token >> 4;
+    if (literalCount == 15 && !readLength(src, size, pos, literalCount))
+    {
+      return false;
+    }
+    if (literalCount > size - pos)
+    {
+      return false;
+    }
+    out.insert(out.end(), src + pos, src + pos + literalCount);
+    pos += literalCount;
+
+    // the last sequence has no match
+    if (pos == size)
+    {
+      break;
+    }
+
+    if (size - pos < 2)
+    {
+      return false;
+    }
+    const std::size_t offset = src[pos] | (src[pos + 1] << 8);
+    pos += 2;
+    std::size_t length = token & 15;
+    if (length == 15 && !readLength(src, size, pos, length))
+    {
+      return false;
+    }
+    length += MIN_MATCH;
+    if (offset == 0 || offset > out.size())
+    {
+      return false;
+    }
+
+    // byte by byte, the match can overlap what it is copying
+    std::size_t from = out.size() - offset;
+    for (std::size_t i = 0; i < length; i++)
+    {
+      const uint8_t byte = out[from++];
+      out.push_back(byte);
+    }
+  }
+  return true;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Small LZ77 byte compressor in the style of LZ4, built for speed over ratio.
+ * It does well on frames that are mostly flat color or on the difference
+ * between two frames, which is mostly zeros.
+ * The output is a series of sequences, each a token byte holding the literal
+ * count and match length, the literals, then a 16 bit match offset. The last
+ * sequence has literals only.
+ */
+
+/**
+ * Compresses a block of bytes.
+ * @param out[out] Cleared and filled with the compressed bytes.
+ * @return Size of the compressed data.
+ */
+std::size_t lzCompress(const uint8_t* src, const std::size_t size,
+                       std::vector<uint8_t>& out);
+
+/**
+ * Decompresses a block made by lzCompress().
+ * @param out[out] Cleared and filled with the original bytes.
+ * @return false if the data is corrupt.
+ */
+bool lzDecompress(const uint8_t* src, const std::size_t size,
+                  std::vector<uint8_t>& out);
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "RadixSort.h"
+#include <cstddef>
+#include <utility>
+
+static const int DIGITS = 8;
+static const int RADIX = 256;
+
+void radixSort(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch)
+{
+  const std::size_t count = keys.size();
+  if (count < 2)
+  {
+    return;
+  }
+  scratch.resize(count);
+
+  // histogram every digit in a single pass over the keys
+  std::size_t histograms[DIGITS][RADIX] = {};
+  for (uint64_t key : keys)
+  {
+    for (int d = 0; d < DIGITS; d++)
+    {
+      histograms[d][(key >> (d * 8)) & 0xFF]++;
+    }
+  }
+
+  for (int d = 0; d < DIGITS; d++)
+  {
+    std::size_t* histogram = histograms[d];
+    const int shift = d * 8;
+    if (histogram[(keys[0] >> shift) & 0xFF] == count)
+    {
+      // every key has the same digit, the order wouldn't change
+      continue;
+    }
+
+    std::size_t offset = 0;
+    for (int i = 0; i < RADIX; i++)
+    {
+      const std::size_t digitCount = histogram[i];
+      histogram[i] = offset;
+      offset += digitCount;
+    }
+
+    for (uint64_t key : keys)
+    {
+      scratch[histogram[(key >> shift) & 0xFF]++] = key;
+    }
+    std::swap(keys, scratch);
+  }
+}
\ No newline at end of file
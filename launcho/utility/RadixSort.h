@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Sorts 64 bit keys in ascending order with a least significant digit radix
+ * sort, one byte per pass. Passes where every key has the same digit are
+ * skipped, so keys that only use a few of their bytes only cost a few passes.
+ * @param keys The keys to sort.
+ * @param scratch Working space, the caller keeps it so that sorting every
+ * frame doesn't allocate. Its contents are overwritten.
+ */
+void radixSort(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch);
\ No newline at end of file
@@ -8,6 +8,7 @@
 template<typename T>
 class Singleton
 {
+protected:
   Singleton() = default;
 
 public:
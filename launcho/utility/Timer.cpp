@@ -1,7 +1,5 @@
 #include "utility/Timer.h"
 
-LARGE_INTEGER Timer::frequency;
-
 Timer::Timer(bool active)
   : startTime(), endTime(), running(false)
 {
@@ -26,7 +24,7 @@ Timer& Timer::operator=(const Timer& rhs)
 void Timer::start()
 {
   reset();
-  QueryPerformanceCounter(&startTime);
+  startTime = Clock::now();
   running = true;
 }
 
@@ -50,15 +48,12 @@ uint64_t Timer::elapsedMicro()
   {
     updateTime();
   }
-  if (frequency.QuadPart == 0)
-  {
-    QueryPerformanceFrequency(&frequency);
-  }
 
-  auto elapsed = endTime.QuadPart - startTime.QuadPart;
-  // convert to us now so precision isn't lost in division
-  elapsed *= 1000000;
-  return elapsed / frequency.QuadPart;
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::microseconds>(
+      endTime - startTime
+      ).count()
+    );
 }
 
 uint32_t Timer::elapsedMilli()
@@ -78,5 +73,5 @@ float Timer::elapsedSec()
 
 void Timer::updateTime()
 {
-  QueryPerformanceCounter(&endTime);
+  endTime = Clock::now();
 }
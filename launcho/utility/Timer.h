@@ -1,18 +1,20 @@
 #pragma once
 
-#include <windows.h>
+#include <chrono>
 #include <cstdint>
 
 /**
- * Timer that uses the windows high performance clock.
+ * Timer that uses the steady high resolution clock. On Windows this is the
+ * same performance counter the timer used to query directly, and it also
+ * works on the headless Linux builds.
  */
 class Timer final
 {
 private:
-  static LARGE_INTEGER frequency;
+  using Clock = std::chrono::steady_clock;
 
-  LARGE_INTEGER startTime;
-  LARGE_INTEGER endTime;
+  Clock::time_point startTime;
+  Clock::time_point endTime;
   bool running;
 
 public:
@@ -0,0 +1,155 @@
+#include "WorkerPool.h"
+#include "utility/FrameArena.h"
+#include "utility/Log.h"
+#include <algorithm>
+#include <cassert>
+
+const std::string WorkerPool::TAG = "WorkerPool";
+
+WorkerPool::WorkerPool()
+: threads(),
+  arenas(),
+  mutex(),
+  wake(),
+  done(),
+  job(nullptr),
+  jobCount(0),
+  jobChunkSize(0),
+  jobChunks(0),
+  generation(0),
+  nextChunk(0),
+  busyWorkers(0),
+  stopping(false)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+  destroy();
+}
+
+void WorkerPool::initialize(const unsigned threadCount)
+{
+  assert(threads.empty());
+  stopping = false;
+  for (unsigned i = 0; i < threadCount; i++)
+  {
+    arenas.emplace_back(new FrameArena("worker " + std::to_string(i)));
+    threads.emplace_back(&WorkerPool::workerLoop, this, arenas.back().get());
+  }
+  Log::debug(TAG, "Started %u worker threads", threadCount);
+}
+
+void WorkerPool::destroy()
+{
+  if (threads.empty())
+  {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  threads.clear();
+  arenas.clear();
+  Log::debug(TAG, "Worker threads stopped");
+}
+
+unsigned WorkerPool::getThreadCount() const
+{
+  return static_cast<unsigned>(threads.size());
+}
+
+void WorkerPool::resetArenas()
+{
+  // the workers are waiting for a job, so nothing is using them
+  for (auto& arena : arenas)
+  {
+    arena->reset();
+  }
+}
+
+void WorkerPool::reportArenas() const
+{
+  for (auto& arena : arenas)
+  {
+    arena->report();
+  }
+}
+
+void WorkerPool::run(const std::size_t count, const std::size_t chunkSize,
+                     const ChunkFn& fn)
+{
+  assert(chunkSize > 0);
+  if (count == 0)
+  {
+    return;
+  }
+
+  const std::size_t chunks = (count + chunkSize - 1) / chunkSize;
+  if (threads.empty() || chunks == 1)
+  {
+    fn(0, count);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job = &fn;
+    jobCount = count;
+    jobChunkSize = chunkSize;
+    jobChunks = chunks;
+    nextChunk = 0;
+    busyWorkers = static_cast<unsigned>(threads.size());
+    generation++;
+  }
+  wake.notify_all();
+
+  runChunks();
+
+  // fn lives on the caller's stack, wait until nobody can still be using it
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [this] { return busyWorkers == 0; });
+  job = nullptr;
+}
+
+void WorkerPool::runChunks()
+{
+  std::size_t chunk;
+  while ((chunk = nextChunk++) < jobChunks)
+  {
+    const std::size_t begin = chunk * jobChunkSize;
+    (*job)(begin, std::min(begin + jobChunkSize, jobCount));
+  }
+}
+
+void WorkerPool::workerLoop(FrameArena* arena)
+{
+  arena->bindToThread();
+  uint64_t seen = 0;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    wake.wait(lock, [&] { return stopping || generation != seen; });
+    if (stopping)
+    {
+      return;
+    }
+    seen = generation;
+
+    lock.unlock();
+    runChunks();
+    lock.lock();
+
+    if (--busyWorkers == 0)
+    {
+      done.notify_one();
+    }
+  }
+}
\ No newline at end of file
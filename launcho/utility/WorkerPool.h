@@ -0,0 +1,109 @@
+#pragma once
+
+#include "utility/Delegate.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class FrameArena;
+
+/**
+ * A fixed set of threads for splitting CPU heavy loops into chunks. The
+ * calling thread works on chunks too, so a pool with no threads simply runs
+ * everything inline.
+ * Only one parallelFor() can run at a time, call it from the main thread.
+ */
+class WorkerPool final
+{
+private:
+  static const std::string TAG;
+
+  using ChunkFn = Delegate<void(std::size_t begin, std::size_t end)>;
+
+  std::vector<std::thread> threads;
+  // scratch memory of each thread, reset with the main thread's every frame
+  std::vector<std::unique_ptr<FrameArena>> arenas;
+  std::mutex mutex;
+  // signals the workers that a job was posted or the pool is stopping
+  std::condition_variable wake;
+  // signals the caller that every worker is done with the job
+  std::condition_variable done;
+
+  // the current job, only changed while no worker is running it
+  const ChunkFn* job;
+  std::size_t jobCount;
+  std::size_t jobChunkSize;
+  std::size_t jobChunks;
+  // bumped for each job so workers can tell a new one was posted
+  uint64_t generation;
+  std::atomic<std::size_t> nextChunk;
+  unsigned busyWorkers;
+  bool stopping;
+
+public:
+  WorkerPool();
+  ~WorkerPool();
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * Starts the worker threads.
+   * @param threadCount Threads to start in addition to the caller.
+   */
+  void initialize(const unsigned threadCount);
+
+  /**
+   * Stops and joins the worker threads.
+   */
+  void destroy();
+
+  unsigned getThreadCount() const;
+
+  /**
+   * Frees the workers' frame scratch memory, call between jobs.
+   */
+  void resetArenas();
+
+  // logs the high water mark of each worker's arena
+  void reportArenas() const;
+
+  /**
+   * Calls fn(begin, end) for consecutive ranges covering [0, count) spread
+   * over the workers and the calling thread, and returns once all of them
+   * are finished. Ranges may run in any order and at the same time, so fn
+   * must only write to data owned by its range.
+   * @param count Number of items.
+   * @param chunkSize Most items handed to a single call.
+   */
+  template<typename Fn>
+  void parallelFor(const std::size_t count, const std::size_t chunkSize,
+                   Fn fn);
+
+private:
+  void run(const std::size_t count, const std::size_t chunkSize,
+           const ChunkFn& fn);
+  // works on chunks of the current job until there are none left
+  void runChunks();
+  void workerLoop(FrameArena* arena);
+};
+
+/****************************************************************************
+ * Function definitions
+ ****************************************************************************/
+
+template<typename Fn>
+void WorkerPool::parallelFor(const std::size_t count,
+                             const std::size_t chunkSize, Fn fn)
+{
+  // fn lives on this stack until run() returns, so only a reference to it is
+  // stored and nothing is allocated however much it captures
+  run(count, chunkSize, ChunkFn([&fn](std::size_t begin, std::size_t end) {
+    fn(begin, end);
+  }));
+}
\ No newline at end of file
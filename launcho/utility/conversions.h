@@ -1,7 +1,9 @@
 #pragma once
 
 #include "math/Vector2.h"
+#include "math/Transform2.h"
 #include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Transform.hpp>
 #include <sstream>
 
 /**
@@ -37,4 +39,18 @@ inline Vector2 convert(const sf::Vector2f& v)
 inline sf::Vector2f convert(const Vector2& v)
 {
   return sf::Vector2f(v.x, v.y);
+}
+
+/**
+ * Converts a world transform into an SFML transform. SFML uses an inverted y
+ * axis, so world y is flipped against the height of the target and the local
+ * y axis of the drawable is flipped to match.
+ */
+inline sf::Transform convert(const Transform2& t, const float targetHeight)
+{
+  return sf::Transform(
+    t.m00, -t.m01, t.m02,
+    -t.m10, t.m11, targetHeight - t.m12,
+    0.0f, 0.0f, 1.0f
+    );
 }
\ No newline at end of file